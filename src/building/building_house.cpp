@@ -13,6 +13,7 @@
 #include "graphics/image_groups.h"
 #include "grid/building.h"
 #include "grid/building_tiles.h"
+#include "grid/desirability.h"
 #include "grid/grid.h"
 #include "grid/tiles.h"
 #include "grid/image.h"
@@ -22,8 +23,12 @@
 #include "game/game_config.h"
 #include "io/gamefiles/lang.h"
 #include "game/game.h"
+#include "game/settings.h"
 
 #include "dev/debug.h"
+#include <array>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
 
 #define MAX_DIR 4
@@ -134,6 +139,15 @@ void building_house::update_count() const {
 void building_house::bind_dynamic(io_buffer *iob, size_t version) {
     auto &d = runtime_data();
 
+    // the levels live in the service coverage grids, a save gets them as of now
+    uint8_t levels[HOUSE_SERVICE_COUNT];
+    uint8_t *services = iob->is_read_access() ? d.saved_services : levels;
+    if (!iob->is_read_access()) {
+        for (int i = 0; i < HOUSE_SERVICE_COUNT; ++i) {
+            levels[i] = service_level((e_house_service)i);
+        }
+    }
+
     for (int i = 0; i < 4; ++i) {
         iob->bind(BIND_SIGNATURE_UINT16, &d.foods[i]);
     }
@@ -148,24 +162,24 @@ void building_house::bind_dynamic(io_buffer *iob, size_t version) {
         iob->bind(BIND_SIGNATURE_UINT16, &d.inventory[i + 4]);
     }
 
-    iob->bind(BIND_SIGNATURE_UINT8, &d.booth_juggler);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.bandstand_juggler);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.bandstand_musician);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.senet_player);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.magistrate);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.bullfighter);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.school);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.library);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.academy);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.apothecary);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.dentist);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.mortuary);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.physician);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.temple_osiris);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.temple_ra);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.temple_ptah);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.temple_seth);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.temple_bast);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_BOOTH_JUGGLER]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_BANDSTAND_JUGGLER]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_BANDSTAND_MUSICIAN]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_SENET_PLAYER]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_MAGISTRATE]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_BULLFIGHTER]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_SCHOOL]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_LIBRARY]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_ACADEMY]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_APOTHECARY]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_DENTIST]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_MORTUARY]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_PHYSICIAN]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_TEMPLE_OSIRIS]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_TEMPLE_RA]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_TEMPLE_PTAH]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_TEMPLE_SETH]);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_TEMPLE_BAST]);
     iob->bind(BIND_SIGNATURE_UINT8, &d.no_space_to_expand);
     iob->bind(BIND_SIGNATURE_UINT8, &d.num_foods);
     iob->bind(BIND_SIGNATURE_UINT8, &d.entertainment);
@@ -175,10 +189,10 @@ void building_house::bind_dynamic(io_buffer *iob, size_t version) {
     iob->bind(BIND_SIGNATURE_UINT8, &d.devolve_delay);
     iob->bind(BIND_SIGNATURE_UINT8, &d.fancy_bazaar_access);
     iob->bind(BIND_SIGNATURE_UINT8, &d.shrine_access);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.bazaar_access);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_BAZAAR_ACCESS]);
     iob->bind(BIND_SIGNATURE_UINT8, &d.water_supply);
     iob->bind(BIND_SIGNATURE_UINT8, &d.pavillion_dancer);
-    iob->bind(BIND_SIGNATURE_UINT8, &d.pavillion_musician);
+    iob->bind(BIND_SIGNATURE_UINT8, &services[HOUSE_SERVICE_PAVILLION_MUSICIAN]);
     iob->bind(BIND_SIGNATURE_UINT8, &d.house_happiness);
     iob->bind(BIND_SIGNATURE_UINT8, &d.is_merged);
     iob->bind(BIND_SIGNATURE_UINT8, &d.criminal_active);
@@ -251,6 +265,7 @@ resource_list building_house::consume_food() {
     }
 
     d.num_foods = 0;
+    d.evolve_checked = 0;
     resource_list food_types_eaten;
     if (scenario_property_kingdom_supplies_grain()) {
         d.foods[0] = amount_per_type;
@@ -281,6 +296,7 @@ resource_list building_house::consume_resources() {
     
     resource_list good_types_consumed;
     auto &d = runtime_data();
+    d.evolve_checked = 0;
     const model_house& model = model_get_house(house_level());
 
     auto consume_resource = [&] (int inventory, uint16_t amount) {
@@ -331,7 +347,12 @@ void building_house::add_population(int num_people) {
 }
 
 void building_house::change_to(building &b, e_building_type new_type) {
-    auto &d = *(building_house::runtime_data_t*)b.runtime_data;
+    auto old_house = b.dcast_house();
+    if (!old_house) {
+        return;
+    }
+
+    auto &d = old_house->runtime_data();
 
     const int house_update_delay = std::min(house_up_delay(), 7);
     const int absolute_day = game.simtime.absolute_day(true);
@@ -359,6 +380,7 @@ void building_house::change_to(building &b, e_building_type new_type) {
 
     map_building_tiles_add(b.id, b.tile, b.size, image_id, TERRAIN_BUILDING);
     d.last_update_day = game.simtime.absolute_day(true);
+    d.evolve_checked = 0;
 }
 
 int16_t building_house::population_room() const {
@@ -431,6 +453,7 @@ void building_house::merge_impl() {
     base.size = 2;
     d.hsize = 2;
     d.population += g_merge_data.population;
+    d.evolve_checked = 0;
 
     for (int i = 0; i < INVENTORY_MAX; i++) {
         d.foods[i] += g_merge_data.foods[i];
@@ -443,10 +466,12 @@ void building_house::merge_impl() {
     }
 
     map_building_tiles_remove(id(), tile());
+    g_service_coverage.move(base.tile, g_merge_data.tile);
     base.tile = g_merge_data.tile;
 
     d.is_merged = true;
     map_building_tiles_add(id(), tile(), 2, image_id, TERRAIN_BUILDING);
+    g_desirability.sources.add(base);
 }
 
 void building_house::merge() {
@@ -484,13 +509,86 @@ void building_house::merge() {
     }
 }
 
+// Last requirements verdict of every house, with the demand counters it added. Whatever changes
+// what the requirement walk reads (aggregated levels, water access, food and goods stocks) clears the
+// house's evolve_checked flag; the key below holds the rest, which is cheap to read every cycle.
+struct house_evolve_memo_t {
+    struct key_t {
+        uint8_t difficulty;
+        uint8_t level;
+        uint8_t desirability_status;
+        uint8_t wine;
+        uint8_t dentist;
+        uint8_t magistrate;
+
+        bool operator==(const key_t &o) const { return memcmp(this, &o, sizeof(key_t)) == 0; }
+    };
+
+    enum { NUM_COUNTERS = sizeof(house_demands::missing) / sizeof(int) + sizeof(house_demands::requiring) / sizeof(int) };
+
+    key_t key;
+    bool valid;
+    uint8_t status;
+    uint8_t num_increments;
+    uint8_t increments[16]; // indices of the missing/requiring counters, in the order they were raised
+
+    static int *counters(house_demands &demands) { return &demands.missing.well; }
+};
+
+static_assert(offsetof(house_demands, requiring) == sizeof(house_demands::missing), "demand counters must be contiguous");
+
+std::array<house_evolve_memo_t, MAX_BUILDINGS> g_house_evolve_memo;
+
+void building_house::clear_evolve_memo() {
+    for (auto &memo : g_house_evolve_memo) {
+        memo.valid = false;
+    }
+}
+
 e_house_progress building_house::check_requirements(house_demands* demands) {
     e_house_progress status = check_evolve_desirability();
-    if (!has_required_goods_and_services(0, demands)) { // check if it will devolve to previous step
+
+    auto &d = runtime_data();
+    house_evolve_memo_t::key_t key;
+    key.difficulty = g_settings.difficulty();
+    key.level = house_level();
+    key.desirability_status = status;
+    key.wine = city_resource_multiple_wine_available() ? 1 : 0;
+    key.dentist = service_level(HOUSE_SERVICE_DENTIST);
+    key.magistrate = service_level(HOUSE_SERVICE_MAGISTRATE);
+
+    auto &memo = g_house_evolve_memo[id()];
+    int *counters = house_evolve_memo_t::counters(*demands);
+    if (d.evolve_checked && memo.valid && memo.key == key) {
+        for (int i = 0; i < memo.num_increments; ++i) {
+            ++counters[memo.increments[i]];
+        }
+        return (e_house_progress)memo.status;
+    }
+
+    house_demands raised = {};
+    if (!has_required_goods_and_services(0, &raised)) { // check if it will devolve to previous step
         status = e_house_decay;
     } else if (status == e_house_evolve) { // check if it can evolve to the next step
-        status = has_required_goods_and_services(1, demands);
+        status = has_required_goods_and_services(1, &raised);
+    }
+
+    memo.key = key;
+    memo.status = status;
+    memo.num_increments = 0;
+    memo.valid = true;
+    const int *raised_counters = house_evolve_memo_t::counters(raised);
+    for (int i = 0; i < house_evolve_memo_t::NUM_COUNTERS; ++i) {
+        for (int n = 0; n < raised_counters[i]; ++n) {
+            if (memo.num_increments < std::size(memo.increments)) {
+                memo.increments[memo.num_increments++] = i;
+            } else {
+                memo.valid = false;
+            }
+        }
+        counters[i] += raised_counters[i];
     }
+    d.evolve_checked = memo.valid ? 1 : 0;
 
     return status;
 }
@@ -560,7 +658,7 @@ e_house_progress building_house::has_required_goods_and_services(int for_upgrade
 
     // dentist
     int dentist = model.dentist;
-    if (d.dentist < dentist) {
+    if (service_level(HOUSE_SERVICE_DENTIST) < dentist) {
         ++demands->missing.dentist;
         return e_house_none;
     }
@@ -571,7 +669,7 @@ e_house_progress building_house::has_required_goods_and_services(int for_upgrade
 
     // physician
     int magistrate = model.physician;
-    if (d.magistrate < magistrate) {
+    if (service_level(HOUSE_SERVICE_MAGISTRATE) < magistrate) {
         ++demands->missing.magistrate;
         return e_house_none;
     }
@@ -648,34 +746,6 @@ void building_house::decay_tax_coverage() {
     }
 }
 
-void building_house::decay_services() {
-    if (!hsize()) {
-        return;
-    }
-
-    auto &housed = runtime_data();
-    decay_service(housed.booth_juggler);
-    decay_service(housed.bandstand_juggler);
-    decay_service(housed.bandstand_musician);
-    decay_service(housed.pavillion_musician);
-    decay_service(housed.senet_player);
-    decay_service(housed.magistrate);
-    decay_service(housed.bullfighter);
-    decay_service(housed.school);
-    decay_service(housed.library);
-    decay_service(housed.academy);
-    decay_service(housed.apothecary);
-    decay_service(housed.dentist);
-    decay_service(housed.mortuary);
-    decay_service(housed.physician);
-    decay_service(housed.temple_osiris);
-    decay_service(housed.temple_ra);
-    decay_service(housed.temple_ptah);
-    decay_service(housed.temple_seth);
-    decay_service(housed.temple_bast);
-    decay_service(housed.bazaar_access);
-}
-
 bool building_house::can_expand(int num_tiles) {
     // merge with other houses
     for (int dir = 0; dir < MAX_DIR; dir++) {
@@ -847,6 +917,7 @@ static void split_size2(building* b, e_building_type new_type) {
         housed.inventory[i] = inventory_per_tile[i] + inventory_remainder[i];
         housed.foods[i] = foods_per_tile[i] + foods_remainder[i];
     }
+    housed.evolve_checked = 0;
     b->distance_from_entry = 0;
 
     const int image_id = house_image_group<true>(house->house_level());
@@ -888,6 +959,7 @@ static void split_size3(building* b) {
         housed.inventory[i] = inventory_per_tile[i] + inventory_remainder[i];
         housed.foods[i] = foods_per_tile[i] + foods_remainder[i];
     }
+    housed.evolve_checked = 0;
     b->distance_from_entry = 0;
 
     const int image_id = house_image_group<true>(house->house_level());
@@ -961,6 +1033,7 @@ void building_house_common_manor::devolve_to_fancy_residence() {
         housed.inventory[i] = inventory_per_tile[i] + inventory_remainder[i];
         housed.foods[i] = foods_per_tile[i] + foods_remainder[i];
     }
+    housed.evolve_checked = 0;
     base.distance_from_entry = 0;
 
     int image_id = house_image_group<true>(house_level());
@@ -1003,6 +1076,7 @@ void building_house_modest_estate::devolve_to_statel_manor() {
     for (int i = 0; i < INVENTORY_MAX; i++) {
         housed.inventory[i] = inventory_per_tile[i] + inventory_remainder[i];
     }
+    housed.evolve_checked = 0;
     base.distance_from_entry = 0;
 
     int image_id = house_image_group<true>(house_level());
@@ -1052,6 +1126,7 @@ void building_house::check_for_corruption() {
 
 void building_house::on_create(int orientation) {
     auto &d = runtime_data();
+    g_service_coverage.reset(base.tile);
     base.common_health = 100;
     d.house_happiness = 50;
 
@@ -1277,10 +1352,13 @@ void building_house_spacious_apartment::expand_to_common_residence() {
         housed.foods[i] += g_merge_data.foods[i];
         housed.inventory[i] += g_merge_data.inventory[i];
     }
+    housed.evolve_checked = 0;
     int image_id = house_image_group<true>(house_level()) + (map_random_get(tile().grid_offset()) & 1);
     map_building_tiles_remove(id(), tile());
+    g_service_coverage.move(base.tile, g_merge_data.tile);
     base.tile = g_merge_data.tile;
     map_building_tiles_add(id(), tile(), base.size, image_id, TERRAIN_BUILDING);
+    g_desirability.sources.add(base);
 }
 
 bool building_house_spacious_apartment::evolve(house_demands* demands) {
@@ -1381,10 +1459,14 @@ void building_house_fancy_residence::expand_to_common_manor() {
         housed.inventory[i] += g_merge_data.inventory[i];
     }
 
+    housed.evolve_checked = 0;
+
     int image_id = house_image_group<true>(house_level());
     map_building_tiles_remove(id(), base.tile);
+    g_service_coverage.move(base.tile, g_merge_data.tile);
     base.tile = g_merge_data.tile;
     map_building_tiles_add(id(), base.tile, base.size, image_id, TERRAIN_BUILDING);
+    g_desirability.sources.add(base);
 }
 
 bool building_house_fancy_residence::evolve(house_demands* demands) {
@@ -1481,10 +1563,13 @@ void building_house_stately_manor::expand_to_modest_estate() {
         housed.foods[i] += g_merge_data.foods[i];
         housed.inventory[i] += g_merge_data.inventory[i];
     }
+    housed.evolve_checked = 0;
     int image_id = house_image_group<true>(house_level());
     map_building_tiles_remove(id(), tile());
+    g_service_coverage.move(base.tile, g_merge_data.tile);
     base.tile = g_merge_data.tile;
     map_building_tiles_add(id(), tile(), base.size, image_id, TERRAIN_BUILDING);
+    g_desirability.sources.add(base);
 }
 
 bool building_house_stately_manor::evolve(house_demands* demands) {
@@ -2,6 +2,7 @@
 
 #include "building/building_house_demands.h"
 #include "building/building.h"
+#include "grid/service_coverage.h"
 
 enum e_house_progress { 
     e_house_evolve = 1,
@@ -36,26 +37,8 @@ public:
         uint16_t population;
         int16_t tax_income_or_storage;
         uint8_t is_merged;
-        uint8_t booth_juggler;
-        uint8_t bandstand_juggler;
-        uint8_t bandstand_musician;
-        uint8_t pavillion_musician;
+        uint8_t saved_services[HOUSE_SERVICE_COUNT]; // levels as read from a save, see service_coverage_t::rebuild
         uint8_t pavillion_dancer;
-        uint8_t senet_player;
-        uint8_t magistrate;
-        uint8_t bullfighter;
-        uint8_t school;
-        uint8_t library;
-        uint8_t academy;
-        uint8_t apothecary;
-        uint8_t dentist;
-        uint8_t mortuary;
-        uint8_t physician;
-        uint8_t temple_osiris;
-        uint8_t temple_ra;
-        uint8_t temple_ptah;
-        uint8_t temple_seth;
-        uint8_t temple_bast;
         uint8_t no_space_to_expand;
         uint8_t num_foods;
         uint8_t entertainment;
@@ -64,7 +47,6 @@ public:
         uint8_t num_gods;
         uint8_t shrine_access;
         uint8_t devolve_delay;
-        uint8_t bazaar_access;
         uint8_t fancy_bazaar_access;
         uint8_t water_supply;
         uint8_t house_happiness;
@@ -74,6 +56,7 @@ public:
         uint8_t hsize;
         building_id worst_desirability_building_id;
         xstring evolve_text;
+        uint8_t evolve_checked; // the memoized check_requirements verdict still holds, cleared by whatever changes its inputs, not saved
     };
 
     virtual void on_create(int orientation) override;
@@ -99,7 +82,8 @@ public:
     void determine_evolve_text();
     void determine_worst_desirability_building();
 
-    void decay_services();
+    uint8_t service_level(e_house_service service) const { return g_service_coverage.level(service, base.tile); }
+    void provide_service(e_house_service service) { g_service_coverage.stamp(service, base.tile); }
     void decay_tax_coverage();
 
     int16_t population_room() const;
@@ -122,6 +106,7 @@ public:
 
     void check_for_corruption();
     e_house_progress check_requirements(house_demands *demands);
+    static void clear_evolve_memo();
 
     static void create_vacant_lot(tile2i tile, int image_id);
 
@@ -7,6 +7,7 @@
 #include "core/profiler.h"
 #include "game/resource.h"
 #include "grid/building.h"
+#include "grid/desirability.h"
 #include "grid/grid.h"
 #include "grid/routing/routing_terrain.h"
 #include "grid/tiles.h"
@@ -60,7 +61,7 @@ void building_house::determine_evolve_text() {
         return;
     }
 
-    if (!housed.bazaar_access) {
+    if (!service_level(HOUSE_SERVICE_BAZAAR_ACCESS)) {
         housed.evolve_text = "#no_bazaar_access";
         return;
     }
@@ -72,10 +73,10 @@ void building_house::determine_evolve_text() {
             housed.evolve_text = "#lost_basic_educational_facilities";
             return;
         } else if (education == 2) {
-            if (housed.school) {
+            if (service_level(HOUSE_SERVICE_SCHOOL)) {
                 housed.evolve_text = "#lost_access_to_scribal_school";
                 return;
-            } else if (housed.library) {
+            } else if (service_level(HOUSE_SERVICE_LIBRARY)) {
                 housed.evolve_text = "#lost_access_to_library";
                 return;
             }
@@ -86,7 +87,7 @@ void building_house::determine_evolve_text() {
     }
 
     // magistrate
-    if (housed.magistrate < model.physician) {
+    if (service_level(HOUSE_SERVICE_MAGISTRATE) < model.physician) {
         housed.evolve_text = "#no_access_to_magistrates";
         return;
     }
@@ -113,7 +114,7 @@ void building_house::determine_evolve_text() {
     }
 
     // dentist
-    if (housed.dentist < model.dentist) {
+    if (service_level(HOUSE_SERVICE_DENTIST) < model.dentist) {
         housed.evolve_text = "#lost_dentist_access";
         return;
     }
@@ -123,7 +124,7 @@ void building_house::determine_evolve_text() {
     if (housed.health < health_need) {
         if (health_need == 1) {
             housed.evolve_text = "#no_access_to_physician";
-        } else if (housed.mortuary) {
+        } else if (service_level(HOUSE_SERVICE_MORTUARY)) {
             housed.evolve_text = "#no_access_to_mortuary";
         } else {
             housed.evolve_text = "#hard_access_to_physician";
@@ -230,10 +231,10 @@ void building_house::determine_evolve_text() {
             housed.evolve_text = "#cannot_evolve_needs_basic_education";
             return;
         } else if (education == 2) {
-            if (housed.school) {
+            if (service_level(HOUSE_SERVICE_SCHOOL)) {
                 housed.evolve_text = "#cannot_evolve_needs_school_education";
                 return;
-            } else if (housed.library) {
+            } else if (service_level(HOUSE_SERVICE_LIBRARY)) {
                 housed.evolve_text = "#cannot_evolve_needs_library_education";
                 return;
             }
@@ -246,7 +247,7 @@ void building_house::determine_evolve_text() {
     }
 
     // magistrate
-    if (housed.magistrate < next_model.physician) {
+    if (service_level(HOUSE_SERVICE_MAGISTRATE) < next_model.physician) {
         housed.evolve_text = "#cannot_evolve_needs_magistrate";
         return;
     }
@@ -273,7 +274,7 @@ void building_house::determine_evolve_text() {
     }
 
     // dentist
-    if (housed.dentist < next_model.dentist) {
+    if (service_level(HOUSE_SERVICE_DENTIST) < next_model.dentist) {
         housed.evolve_text = "#cannot_evolve_needs_dentist";
         return;
     }
@@ -283,7 +284,7 @@ void building_house::determine_evolve_text() {
     if (housed.health < model_health_need) {
         if (model_health_need == 1) {
             housed.evolve_text = "#cannot_evolve_needs_physician";
-        } else if (housed.dentist) {
+        } else if (service_level(HOUSE_SERVICE_DENTIST)) {
             housed.evolve_text = "#cannot_evolve_needs_mortuary_has_physician";
         } else {
             housed.evolve_text = "#cannot_evolve_needs_physician_mortuary_has";
@@ -333,47 +334,57 @@ void building_house::determine_worst_desirability_building() {
         return;
     }
 
+    // only the buildings indexed around the house are visited, the result is the same as
+    // scanning the area row by row: lowest value wins, first tile in scan order on ties
     int lowest_desirability = 0;
     int lowest_building_id = 0;
+    int lowest_scan_index = 0;
 
-    for (int y = area.tmin.y(), endy = area.tmax.y(); y <= endy; y++) {
-        for (int x = area.tmin.x(), endx = area.tmax.x(); x <= endx; x++) {
-            int building_id = map_building_at(tile2i(x, y));
-            if (building_id <= 0)
-                continue;
+    g_desirability.sources.for_each_in_area(area.tmin, area.tmax, [&] (building_id building_id) {
+        auto b = building_get(building_id);
+        if (!b->is_valid() || building_id == id()) {
+            return;
+        }
 
-            auto b = building_get(building_id);
-            if (!b->is_valid() || building_id == id()) {
-                continue;
-            }
+        const model_building *model = model_get_building(b->type);
+        if (model->desirability_value >= 0) {
+            return;
+        }
 
-            const model_building *model = model_get_building(b->type);
-            int des = model->desirability_value;
-            if (des >= 0) {
-                continue;
-            }
+        auto other_house = b->dcast_house();
+        if (other_house && other_house->house_level() >= my_level) {
+            return;
+        }
 
-            auto other_house = b->dcast_house();
-            if (other_house && other_house->house_level() >= my_level) {
-                continue;
-            }
+        const int size = std::max<int>(1, b->size);
+        const int minx = std::max(area.tmin.x(), b->tile.x()), maxx = std::min(area.tmax.x(), b->tile.x() + size - 1);
+        const int miny = std::max(area.tmin.y(), b->tile.y()), maxy = std::min(area.tmax.y(), b->tile.y() + size - 1);
+        for (int y = miny; y <= maxy; y++) {
+            for (int x = minx; x <= maxx; x++) {
+                if (map_building_at(tile2i(x, y)) != building_id) {
+                    continue;
+                }
+
+                // simplified desirability calculation
+                int des = model->desirability_value;
+                int dist = calc_maximum_distance(vec2i(x, y), tile());
+                if (dist > model->desirability_range) {
+                    continue;
+                }
 
-            // simplified desirability calculation
-            int step_size = model->desirability_step_size;
-            int range = model->desirability_range;
-            int dist = calc_maximum_distance(vec2i(x, y), tile());
-            if (dist <= range) {
                 while (--dist > 1) {
-                    des += step_size;
+                    des += model->desirability_step_size;
                 }
 
-                if (des < lowest_desirability) {
+                const int scan_index = y * GRID_LENGTH + x;
+                if (des < lowest_desirability || (des == lowest_desirability && lowest_building_id && scan_index < lowest_scan_index)) {
                     lowest_desirability = des;
                     lowest_building_id = building_id;
+                    lowest_scan_index = scan_index;
                 }
             }
         }
-    }
+    });
 
     housed.worst_desirability_building_id = lowest_building_id;
 }
\ No newline at end of file
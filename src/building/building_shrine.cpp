@@ -1,14 +1,96 @@
 #include "building_shrine.h"
 
+#include "city/city_buildings.h"
 #include "city/city_warnings.h"
+#include "core/profiler.h"
+#include "grid/grid.h"
 #include "grid/road_access.h"
 
+#include <algorithm>
+
 buildings::model_t<building_shrine_osiris> shrine_osiris_m;
 buildings::model_t<building_shrine_ra>   shrine_ra_m;
 buildings::model_t<building_shrine_ptah> shrine_ptah_m;
 buildings::model_t<building_shrine_seth> shrine_seth_m;
 buildings::model_t<building_shrine_bast> shrine_bast_m;
 
+shrine_coverage_t g_shrine_coverage;
+grid_xx g_shrine_coverage_grid = {0, FS_UINT8};
+
+static const int SHRINE_RANGE_RADIUS = 3;
+
+void shrine_coverage_t::clear() {
+    map_grid_clear(g_shrine_coverage_grid);
+    shrines.clear();
+}
+
+void shrine_coverage_t::rebuild() {
+    OZZY_PROFILER_SECTION("Game/Religion/Shrine Coverage Rebuild");
+    clear();
+    for (building &b : city_buildings()) {
+        if (b.is_shrine() && (b.state == BUILDING_STATE_VALID || b.state == BUILDING_STATE_CREATED)) {
+            add(b);
+        }
+    }
+}
+
+void shrine_coverage_t::stamp(tile2i tile, int delta) {
+    grid_area area = map_grid_get_area(tile, 1, SHRINE_RANGE_RADIUS);
+    map_grid_area_foreach(area.tmin, area.tmax, [delta] (tile2i t) {
+        map_grid_set(g_shrine_coverage_grid, t, map_grid_get(g_shrine_coverage_grid, t) + delta);
+    });
+}
+
+void shrine_coverage_t::add(building &b) {
+    if (b.id <= 0 || std::find(shrines.begin(), shrines.end(), b.id) != shrines.end()) {
+        return;
+    }
+
+    if (shrines.empty()) {
+        map_grid_clear(g_shrine_coverage_grid);
+    }
+
+    stamp(b.tile, 1);
+    shrines.push_back(b.id);
+}
+
+void shrine_coverage_t::remove(building &b) {
+    auto it = std::find(shrines.begin(), shrines.end(), b.id);
+    if (it == shrines.end()) {
+        return;
+    }
+
+    stamp(b.tile, -1);
+    shrines.erase(it);
+}
+
+bool shrine_coverage_t::covers(tile2i tile, int size) {
+    if (shrines.empty()) {
+        return false;
+    }
+
+    for (int dy = 0; dy < size; dy++) {
+        for (int dx = 0; dx < size; dx++) {
+            if (map_grid_get(g_shrine_coverage_grid, tile.shifted(dx, dy))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void building_shrine::on_create(int orientation) {
+    g_shrine_coverage.add(base);
+}
+
+void building_shrine::on_destroy() {
+    g_shrine_coverage.remove(base);
+}
+
+void building_shrine::on_undo() {
+    g_shrine_coverage.add(base);
+}
+
 void building_shrine::on_place_checks() {
     construction_warnings warnings;
 
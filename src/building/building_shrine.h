@@ -2,12 +2,17 @@
 
 #include "building/building.h"
 
+#include <vector>
+
 class building_shrine : public building_impl {
 public:
     building_shrine(building &b) : building_impl(b) {}
 
     virtual building_shrine *dcast_shrine() override { return this; }
 
+    virtual void on_create(int orientation) override;
+    virtual void on_destroy() override;
+    virtual void on_undo() override;
     virtual void on_place_checks() override;
     virtual e_overlay get_overlay() const override;
 };
@@ -30,4 +35,21 @@ struct building_shrine_seth : public building_shrine {
 
 struct building_shrine_bast : public building_shrine {
     BUILDING_METAINFO(BUILDING_SHRINE_BAST, building_shrine_bast, building_shrine);
-};
\ No newline at end of file
+};
+// Per tile count of the shrines whose range covers it. Shrines add and remove their range
+// when they are placed, restored by undo or destroyed, so the religion update only reads
+// the counts under each house footprint instead of re-marking every shrine area.
+struct shrine_coverage_t {
+    std::vector<building_id> shrines;
+
+    void clear();
+    void rebuild();
+    void add(building &b);
+    void remove(building &b);
+    bool covers(tile2i tile, int size);
+
+private:
+    void stamp(tile2i tile, int delta);
+};
+
+extern shrine_coverage_t g_shrine_coverage;
@@ -26,6 +26,18 @@ void building_well::static_params::planer_ghost_preview(build_planner &planer, p
     inherited::planer_ghost_preview(planer, ctx, tile, end, pixel);
 }
 
+void building_well::on_create(int orientation) {
+    g_well_coverage.add_well(base);
+}
+
+void building_well::on_destroy() {
+    g_well_coverage.remove_well(base);
+}
+
+void building_well::on_undo() {
+    g_well_coverage.add_well(base);
+}
+
 void building_well::update_month() {
     int avg_desirability = g_desirability.get_avg(tile(), 4);
     base.fancy_state = (avg_desirability > 30 ? efancy_good : efancy_normal);
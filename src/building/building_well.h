@@ -15,7 +15,9 @@ public:
         virtual void planer_ghost_preview(build_planner &p, painter &ctx, tile2i tile, tile2i end, vec2i pixel) const override;
     } BUILDING_STATIC_DATA(static_params);
 
-    //virtual void on_create() override;
+    virtual void on_create(int orientation) override;
+    virtual void on_destroy() override;
+    virtual void on_undo() override;
     virtual void update_month() override;
     virtual bool need_road_access() const override { return false; }
     virtual void on_place_checks() override;
@@ -1,8 +1,11 @@
 #include "buildings.h"
 
 #include "building/building_house.h"
+#include "building/building_shrine.h"
 #include "core/profiler.h"
 #include "grid/water.h"
+#include "grid/water_supply.h"
+#include "grid/service_coverage.h"
 #include "grid/building.h"
 #include "grid/routing/routing.h"
 #include "city/city.h"
@@ -234,6 +237,11 @@ void city_buildings_t::on_post_load () {
     });
 
     check_buildings_twins();
+    g_desirability.sources.rebuild();
+    g_well_coverage.rebuild();
+    g_service_coverage.rebuild();
+    g_shrine_coverage.rebuild();
+    building_house::clear_evolve_memo();
 }
 
 void city_buildings_t::init() {
@@ -266,6 +274,7 @@ void city_buildings_t::update_day() {
 }
 
 void city_buildings_t::reload_objects() {
+    building_house::clear_evolve_memo(); // verdicts were taken against the old parameters
     buildings_valid_do([] (building &b) {
         b.dcast()->on_config_reload();
     });
@@ -308,37 +317,11 @@ void city_buildings_t::update_month() {
 
 void city_buildings_t::update_religion_supply_houses() {
     OZZY_PROFILER_SECTION("Game/Update/Religion Supply Update");
-    svector<building*, 512> shrines;
-
-    auto mark_shrine_access = [] (building *shrine, int radius) {
-        grid_area area = map_grid_get_area(shrine->tile, 1, radius);
-
-        for (int yy = area.tmin.y(), endy = area.tmax.y(); yy <= endy; yy++) {
-            for (int xx = area.tmin.x(), endx = area.tmax.x(); xx <= endx; xx++) {
-                int building_id = map_building_at(tile2i(xx, yy));
-
-                auto house = building_get(building_id)->dcast_house();
-                if (house) {
-                    house->runtime_data().shrine_access = true;
-                }
-            }
-        }
-    };
-
-    for (auto& b : city_buildings()) {
-        if (b.state != BUILDING_STATE_VALID)
-            continue;
-
-        if (b.is_shrine()) {
-            shrines.push_back(&b);
-        } else if (auto house = b.dcast_house(); !!house) {
-            house->runtime_data().shrine_access = false;
+    buildings_valid_do([] (building &b) {
+        if (auto house = b.dcast_house(); !!house) {
+            house->runtime_data().shrine_access = g_shrine_coverage.covers(b.tile, b.size);
         }
-    }
-
-    for (auto& s : shrines) {
-        mark_shrine_access(s, 3);
-    }
+    });
 }
 
 io_buffer *iob_building_count_industry = new io_buffer([] (io_buffer *iob, size_t version) {
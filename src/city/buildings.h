@@ -49,7 +49,6 @@ struct city_buildings_t {
 
     void update_tick(bool refresh_only);
     void update_water_supply_houses();
-    void mark_well_access(building *well);
     void update_wells_range();
     void update_canals_from_water_lifts();
     void update_religion_supply_houses();
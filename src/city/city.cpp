@@ -19,6 +19,7 @@
 #include "empire/empire_city.h"
 #include "empire/empire.h"
 #include "io/io_buffer.h"
+#include "io/gamestate/boilerplate.h"
 #include "empire/trade_route.h"
 #include "building/building_granary.h"
 #include "building/building_house.h"
@@ -34,6 +35,7 @@
 #include "empire/empire_object.h"
 #include "overlays/city_overlay.h"
 #include "grid/building.h"
+#include "grid/service_coverage.h"
 #include "building/construction/build_planner.h"
 #include "dev/debug.h"
 #include "graphics/view/lookup.h"
@@ -470,10 +472,8 @@ void city_t::house_decay_tax_coverage() {
 }
 
 void city_t::house_decay_services() {
-    OZZY_PROFILER_SECTION("Game/Run/Tick/House Decay Culture");
-    buildings_house_do([] (auto house) {
-        house->decay_services();
-    });
+    // levels are read off the cycle walkers last stamped, no house is visited
+    g_service_coverage.next_cycle();
 }
 
 bool city_t::available_resource(e_resource resource) {
@@ -654,6 +654,7 @@ io_buffer* iob_city_data = new io_buffer([](io_buffer* iob, size_t version) {
     iob->bind(BIND_SIGNATURE_INT32, &data.health.num_mortuary_workers);
     iob->bind(BIND_SIGNATURE_UINT16, &game_speed());
     iob->bind____skip(2);
+    assert(iob->get_offset() == city_data_population_offset);
     iob->bind(BIND_SIGNATURE_INT32, &data.population.current);
     iob->bind(BIND_SIGNATURE_INT32, &data.population.last_year);
     iob->bind(BIND_SIGNATURE_INT32, &data.population.school_age);
@@ -868,6 +869,7 @@ io_buffer* iob_city_data = new io_buffer([](io_buffer* iob, size_t version) {
     iob->bind(BIND_SIGNATURE_INT32, &data.finance.last_year.expenses.tribute);
     iob->bind(BIND_SIGNATURE_INT8, &data.finance.tax_percentage);
     iob->bind____skip(3);
+    assert(iob->get_offset() == city_data_treasury_offset);
     iob->bind(BIND_SIGNATURE_INT32, &data.finance.treasury.value);
     iob->bind(BIND_SIGNATURE_UINT8, &data.finance.tribute_not_paid_last_year);
     iob->bind(BIND_SIGNATURE_UINT8, &data.finance.tribute_not_paid_total_years);
@@ -10,9 +10,12 @@
 #include "grid/building.h"
 #include "grid/tiles.h"
 #include "grid/canals.h"
+#include "grid/water_supply.h"
+#include "grid/service_coverage.h"
 #include "grid/building_tiles.h"
 #include "grid/routing/routing_terrain.h"
 #include "building/building_house.h"
+#include "building/building_shrine.h"
 #include "building/building_wall.h"
 #include "io/io_buffer.h"
 
@@ -94,6 +97,8 @@ building *building_create(e_building_type type, tile2i tile, int orientation) {
 
     memset(b->runtime_data, 0, sizeof(b->runtime_data));
     b->new_fill_in_data_for_type(type, tile, orientation);
+    g_desirability.sources.add(*b);
+    g_well_coverage.reset_building(*b);
 
     events::emit(event_building_create{ b->id });
 
@@ -144,9 +149,15 @@ void building_clear_all() {
         memset(&g_all_buildings[i], 0, sizeof(building));
         g_all_buildings[i].id = i;
     }
+    g_desirability.sources.clear();
+    g_well_coverage.clear();
+    g_service_coverage.clear();
+    g_shrine_coverage.clear();
 }
 
 static void building_delete_UNSAFE(building *b) {
+    g_desirability.sources.remove(*b);
+    g_well_coverage.reset_building(*b);
     b->clear_related_data();
     int id = b->id;
     memset(b, 0, sizeof(building));
@@ -226,65 +237,65 @@ io_buffer *iob_buildings = new io_buffer([] (io_buffer *iob, size_t version) {
             int a = 2134;
         }
 
-        iob->bind(BIND_SIGNATURE_UINT8, &b->state);
-        iob->bind____skip(1); // iob->bind(BIND_SIGNATURE_UINT8, &b->faction_id);
-        iob->bind____skip(1); // iob->bind(BIND_SIGNATURE_UINT8, &b->reserved_id);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->size);
-        iob->bind____skip(1); // iob->bind(BIND_SIGNATURE_UINT8, &b->house_is_merged);
-        iob->bind____skip(1); // iob->bind(BIND_SIGNATURE_UINT8, &b->house_size);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->state);
+        iob->bind____skip(1); // iob->bind<BIND_SIGNATURE_UINT8>(&b->faction_id);
+        iob->bind____skip(1); // iob->bind<BIND_SIGNATURE_UINT8>(&b->reserved_id);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->size);
+        iob->bind____skip(1); // iob->bind<BIND_SIGNATURE_UINT8>(&b->house_is_merged);
+        iob->bind____skip(1); // iob->bind<BIND_SIGNATURE_UINT8>(&b->house_size);
         iob->bind(BIND_SIGNATURE_TILE2I, b->tile);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->orientation);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->spawned_worker_this_month);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->curse_days_left);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->blessing_days_left);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->orientation);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->spawned_worker_this_month);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->curse_days_left);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->blessing_days_left);
         iob->bind____skip(2);
-        iob->bind(BIND_SIGNATURE_UINT16, &b->type);
+        iob->bind<BIND_SIGNATURE_UINT16>(&b->type);
         iob->bind____skip(2); // (BIND_SIGNATURE_INT16, &b->subtype.data); // which union field we use does not matter
-        iob->bind(BIND_SIGNATURE_UINT16, &b->road_network_id);
-        iob->bind(BIND_SIGNATURE_INT16, &b->native_meeting_center_id);
-        iob->bind(BIND_SIGNATURE_INT16, &b->houses_covered);
-        iob->bind(BIND_SIGNATURE_INT16, &b->percentage_houses_covered);
+        iob->bind<BIND_SIGNATURE_UINT16>(&b->road_network_id);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->native_meeting_center_id);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->houses_covered);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->percentage_houses_covered);
 
         iob->bind____skip(2);
         iob->bind____skip(2);
-        iob->bind(BIND_SIGNATURE_INT16, &b->distance_from_entry);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->distance_from_entry);
         iob->bind____skip(2);
 
         iob->bind____skip(2); 
         iob->bind(BIND_SIGNATURE_TILE2I, b->road_access);
 
-        iob->bind(BIND_SIGNATURE_UINT16, &b->figure_ids[0]);
-        iob->bind(BIND_SIGNATURE_UINT16, &b->figure_ids[1]);
-        iob->bind(BIND_SIGNATURE_UINT16, &b->figure_ids[2]);
-        iob->bind(BIND_SIGNATURE_UINT16, &b->figure_ids[3]);
-
-        iob->bind(BIND_SIGNATURE_INT16, &b->figure_spawn_delay);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->figure_roam_direction);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->has_water_access);
-
-        iob->bind(BIND_SIGNATURE_UINT8, &b->common_health);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->malaria_risk);
-        iob->bind(BIND_SIGNATURE_INT16, &b->prev_part_building_id);
-        iob->bind(BIND_SIGNATURE_INT16, &b->next_part_building_id);
-        iob->bind(BIND_SIGNATURE_INT16, &b->stored_amount_first);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->disease_days);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->has_well_access);
-
-        iob->bind(BIND_SIGNATURE_INT16, &b->num_workers);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->labor_category); // FF
-        iob->bind(BIND_SIGNATURE_UINT8, &b->output_resource_first_id);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->has_road_access);
+        iob->bind<BIND_SIGNATURE_UINT16>(&b->figure_ids[0]);
+        iob->bind<BIND_SIGNATURE_UINT16>(&b->figure_ids[1]);
+        iob->bind<BIND_SIGNATURE_UINT16>(&b->figure_ids[2]);
+        iob->bind<BIND_SIGNATURE_UINT16>(&b->figure_ids[3]);
+
+        iob->bind<BIND_SIGNATURE_INT16>(&b->figure_spawn_delay);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->figure_roam_direction);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->has_water_access);
+
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->common_health);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->malaria_risk);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->prev_part_building_id);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->next_part_building_id);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->stored_amount_first);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->disease_days);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->has_well_access);
+
+        iob->bind<BIND_SIGNATURE_INT16>(&b->num_workers);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->labor_category); // FF
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->output_resource_first_id);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->has_road_access);
         iob->bind____skip(1);
 
-        iob->bind(BIND_SIGNATURE_INT16, &b->damage_risk);
-        iob->bind(BIND_SIGNATURE_INT16, &b->fire_risk);
-        iob->bind(BIND_SIGNATURE_INT16, &b->fire_duration);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->fire_proof);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->damage_risk);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->fire_risk);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->fire_duration);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->fire_proof);
 
-        iob->bind(BIND_SIGNATURE_UINT8, &b->map_random_7bit); // 20 (workcamp 1)
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->map_random_7bit); // 20 (workcamp 1)
         iob->bind____skip(1);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->health_proof);
-        iob->bind(BIND_SIGNATURE_INT16, &b->formation_id);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->health_proof);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->formation_id);
 
         b->dcast()->bind_dynamic(iob, version); // 102 for PH
 
@@ -293,25 +304,25 @@ io_buffer *iob_buildings = new io_buffer([] (io_buffer *iob, size_t version) {
         iob->bind____skip(184 - currind);
 
         iob->bind____skip(2); 
-        iob->bind(BIND_SIGNATURE_INT16, &b->stored_amount_second);
+        iob->bind<BIND_SIGNATURE_INT16>(&b->stored_amount_second);
         iob->bind____skip(1); // 
-        iob->bind(BIND_SIGNATURE_UINT8, &b->has_plague); // 1
-
-        iob->bind(BIND_SIGNATURE_INT8, &b->desirability);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->is_deleted);
-        iob->bind(BIND_SIGNATURE_UINT8, &b->is_adjacent_to_water);
-
-        iob->bind(BIND_SIGNATURE_UINT8, &b->storage_id);
-        iob->bind____skip(1); // iob->bind(BIND_SIGNATURE_INT8, &b->sentiment.house_happiness); // which union field we use does not matter // 90 for house, 50 for wells
-        iob->bind(BIND_SIGNATURE_UINT8, &b->show_on_problem_overlay); // 1
-        iob->bind(BIND_SIGNATURE_UINT16, &b->deben_storage); // 2
-        iob->bind(BIND_SIGNATURE_UINT8, &b->has_open_water_access); // 1
-        iob->bind(BIND_SIGNATURE_UINT8, &b->output_resource_second_id); // 1
-        iob->bind(BIND_SIGNATURE_UINT8, &b->output_resource_second_rate); // 1
-
-        iob->bind(BIND_SIGNATURE_INT16, &b->fancy_state); // 2
-        iob->bind(BIND_SIGNATURE_INT8, &b->first_material_id);
-        iob->bind(BIND_SIGNATURE_INT8, &b->second_material_id);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->has_plague); // 1
+
+        iob->bind<BIND_SIGNATURE_INT8>(&b->desirability);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->is_deleted);
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->is_adjacent_to_water);
+
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->storage_id);
+        iob->bind____skip(1); // iob->bind<BIND_SIGNATURE_INT8>(&b->sentiment.house_happiness); // which union field we use does not matter // 90 for house, 50 for wells
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->show_on_problem_overlay); // 1
+        iob->bind<BIND_SIGNATURE_UINT16>(&b->deben_storage); // 2
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->has_open_water_access); // 1
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->output_resource_second_id); // 1
+        iob->bind<BIND_SIGNATURE_UINT8>(&b->output_resource_second_rate); // 1
+
+        iob->bind<BIND_SIGNATURE_INT16>(&b->fancy_state); // 2
+        iob->bind<BIND_SIGNATURE_INT8>(&b->first_material_id);
+        iob->bind<BIND_SIGNATURE_INT8>(&b->second_material_id);
         // 59 additional bytes
         iob->bind____skip(59); // temp for debugging
         //            assert(iob->get_offset() - sind == 264);
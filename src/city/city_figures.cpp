@@ -4,6 +4,8 @@
 #include "city/city.h"
 #include "city/city_figures.h"
 #include "figure/figure_names.h"
+#include "figure/route.h"
+#include "grid/routing/routing.h"
 #include "core/custom_span.hpp"
 #include "core/random.h"
 
@@ -11,6 +13,7 @@ struct figure_data_t {
     //int created_sequence;
     bool initialized;
     std::array<figure *, MAX_FIGURES> figures;
+    std::array<bool, MAX_FIGURES> fighting;
 
     void init() {
         if (initialized) {
@@ -69,8 +72,20 @@ void city_figures_t::update() {
     reset();
     //g_city.entertainment.hippodrome_has_race = false;
 
+    // routes the figures are about to ask for are searched in parallel, figure_route_add picks them up
+    figure_route_prefetch();
+
     for (auto &figure: map_figures()) {
         figure->action_perform();
+
+        // a fight blocks routes over its tile, whichever way it ends the flow fields must move on
+        const bool fighting = (figure->state == FIGURE_STATE_ALIVE && figure->action_state == FIGURE_ACTION_150_ATTACK);
+        if (fighting != g_figure_data.fighting[figure->id]) {
+            g_figure_data.fighting[figure->id] = fighting;
+            if (!fighting) {
+                map_routing_version_bump();
+            }
+        }
     }
 }
 
@@ -74,8 +74,7 @@ void city_health_t::start_disease(int total_people, bool force, int plague_peopl
             return;
         }
 
-        auto &housed = house->runtime_data();
-        if (!(housed.apothecary || housed.physician)) {
+        if (!(house->service_level(HOUSE_SERVICE_APOTHECARY) || house->service_level(HOUSE_SERVICE_PHYSICIAN))) {
             warn_building = &house->base;
             people_to_plague -= house->house_population();
             auto main = house->main();
@@ -152,12 +151,12 @@ void city_health_t::update() {
         total_population += hpop;
         auto &housed = house->runtime_data();
         if (house->house_level() <= HOUSE_STURDY_HUT) {
-            if (housed.apothecary) {
+            if (house->service_level(HOUSE_SERVICE_APOTHECARY)) {
                 healthy_population += hpop;
             } else {
                 healthy_population += hpop / 4;
             }
-        } else if (housed.physician) {
+        } else if (house->service_level(HOUSE_SERVICE_PHYSICIAN)) {
             if (housed.days_without_food == 0) {
                 healthy_population += hpop;
             } else {
@@ -7,6 +7,7 @@
 #include "grid/routing/routing_terrain.h"
 #include "building/building_house.h"
 
+#include <cstring>
 
 
 void city_t::house_service_update_health() {
@@ -18,10 +19,9 @@ void city_t::house_service_update_health() {
 
         decay_service(house->base.common_health);
 
-        auto &housed = house->runtime_data();
-        int target_common_health = (!!housed.apothecary ? 33 : 0)
-                                    + (!!housed.physician ? 33 : 0)
-                                    + (!!housed.dentist ? 33 : 0);
+        int target_common_health = (!!house->service_level(HOUSE_SERVICE_APOTHECARY) ? 33 : 0)
+                                    + (!!house->service_level(HOUSE_SERVICE_PHYSICIAN) ? 33 : 0)
+                                    + (!!house->service_level(HOUSE_SERVICE_DENTIST) ? 33 : 0);
 
         auto &b = house->base;
         b.common_health += ((b.common_health < target_common_health) ? +1 : -1);
@@ -146,47 +146,50 @@ void city_t::house_service_calculate_culture_aggregates() {
 
         // entertainment
         auto &housed = house->runtime_data();
+        const uint8_t old_levels[] = {housed.entertainment, housed.education, housed.num_gods, housed.health};
         housed.entertainment = base_entertainment;
-        const int jugglers_value = std::max<int>(housed.booth_juggler, housed.bandstand_juggler);
+        const int jugglers_value = std::max<int>(house->service_level(HOUSE_SERVICE_BOOTH_JUGGLER), house->service_level(HOUSE_SERVICE_BANDSTAND_JUGGLER));
         housed.entertainment += (jugglers_value / 5);
  
-        const int musicians_value = std::max<int>(housed.bandstand_musician, housed.pavillion_musician);
+        const int musicians_value = std::max<int>(house->service_level(HOUSE_SERVICE_BANDSTAND_MUSICIAN), house->service_level(HOUSE_SERVICE_PAVILLION_MUSICIAN));
         housed.entertainment += (musicians_value / 4);
 
         const int dancers_value = housed.pavillion_dancer;
         housed.entertainment += (dancers_value / 3);
 
-        const int senet_value = housed.senet_player;
+        const int senet_value = house->service_level(HOUSE_SERVICE_SENET_PLAYER);
         housed.entertainment += (senet_value / 2.5f);
 
         housed.entertainment = std::min<int>(housed.entertainment, 100);
 
         // education
+        const bool school = house->service_level(HOUSE_SERVICE_SCHOOL);
+        const bool library = house->service_level(HOUSE_SERVICE_LIBRARY);
         housed.education = 0;
-        if (housed.school || housed.library) {
+        if (school || library) {
             housed.education = 1;
-            if (housed.school && housed.library) {
+            if (school && library) {
                 housed.education = 2;
-                if (housed.academy)
+                if (house->service_level(HOUSE_SERVICE_ACADEMY))
                     housed.education = 3;
             }
         }
 
         // religion
         housed.num_gods = 0;
-        if (housed.temple_osiris)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_OSIRIS))
             ++housed.num_gods;
 
-        if (housed.temple_ra)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_RA))
             ++housed.num_gods;
 
-        if (housed.temple_ptah)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_PTAH))
             ++housed.num_gods;
 
-        if (housed.temple_seth)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_SETH))
             ++housed.num_gods;
 
-        if (housed.temple_bast)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_BAST))
             ++housed.num_gods;
 
         if (housed.num_gods == 0 && housed.shrine_access) {
@@ -195,10 +198,15 @@ void city_t::house_service_calculate_culture_aggregates() {
 
         // health
         housed.health = 0;
-        if (housed.apothecary)
+        if (house->service_level(HOUSE_SERVICE_APOTHECARY))
             ++housed.health;
 
-        if (housed.physician)
+        if (house->service_level(HOUSE_SERVICE_PHYSICIAN))
             ++housed.health;
+
+        const uint8_t new_levels[] = {housed.entertainment, housed.education, housed.num_gods, housed.health};
+        if (memcmp(old_levels, new_levels, sizeof(new_levels)) != 0) {
+            housed.evolve_checked = 0;
+        }
     }
 }
@@ -13,6 +13,7 @@
 #include "graphics/text.h"
 #include "graphics/screen.h"
 #include "graphics/image.h"
+#include "graphics/painter.h"
 
 #include "game/game.h"
 
@@ -20,16 +21,98 @@
 #include "js/js.h"
 
 #include <array>
+#include <chrono>
 #include <cinttypes>
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGEPAK_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define IMAGEPAK_NEON
+#include <arm_neon.h>
+#endif
+
 SDL_Surface *IMG_LoadPNG_RW(SDL_RWops *src);
 image_packer packer;
 
+static std::vector<imagepak_timing_t> g_imagepak_timings;
+
 static color to_32_bit(uint16_t c) {
     return ALPHA_OPAQUE | ((c & 0x7c00) << 9) | ((c & 0x7000) << 4) | ((c & 0x3e0) << 6) | ((c & 0x380) << 1) | ((c & 0x1f) << 3) | ((c & 0x1c) >> 2);
 }
 
+#if defined(IMAGEPAK_SSE2)
+// same bit layout as to_32_bit, four pixels widened to 32 bit lanes
+static inline __m128i to_32_bit_x4(__m128i c, bool transparent_key) {
+    const __m128i r = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7c00)), 9), _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x7000)), 4));
+    const __m128i g = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x3e0)), 6), _mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x380)), 1));
+    const __m128i b = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x1f)), 3), _mm_srli_epi32(_mm_and_si128(c, _mm_set1_epi32(0x1c)), 2));
+    __m128i result = _mm_or_si128(_mm_or_si128(_mm_set1_epi32((int)ALPHA_OPAQUE), r), _mm_or_si128(g, b));
+    if (transparent_key) {
+        const __m128i mask = _mm_cmpeq_epi32(result, _mm_set1_epi32((int)COLOR_SG2_TRANSPARENT));
+        result = _mm_andnot_si128(mask, result);
+    }
+    return result;
+}
+#elif defined(IMAGEPAK_NEON)
+static inline uint32x4_t to_32_bit_x4(uint32x4_t c, bool transparent_key) {
+    const uint32x4_t r = vorrq_u32(vshlq_n_u32(vandq_u32(c, vdupq_n_u32(0x7c00)), 9), vshlq_n_u32(vandq_u32(c, vdupq_n_u32(0x7000)), 4));
+    const uint32x4_t g = vorrq_u32(vshlq_n_u32(vandq_u32(c, vdupq_n_u32(0x3e0)), 6), vshlq_n_u32(vandq_u32(c, vdupq_n_u32(0x380)), 1));
+    const uint32x4_t b = vorrq_u32(vshlq_n_u32(vandq_u32(c, vdupq_n_u32(0x1f)), 3), vshrq_n_u32(vandq_u32(c, vdupq_n_u32(0x1c)), 2));
+    uint32x4_t result = vorrq_u32(vorrq_u32(vdupq_n_u32(ALPHA_OPAQUE), r), vorrq_u32(g, b));
+    if (transparent_key) {
+        const uint32x4_t mask = vceqq_u32(result, vdupq_n_u32(COLOR_SG2_TRANSPARENT));
+        result = vbicq_u32(result, mask);
+    }
+    return result;
+}
+#endif
+
+// converts a run of little endian 555 pixels, src does not need any alignment
+static void convert_555(const uint8_t *src, color *dst, int count, bool transparent_key) {
+    int i = 0;
+#if defined(IMAGEPAK_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i * 2));
+        _mm_storeu_si128((__m128i *)(dst + i), to_32_bit_x4(_mm_unpacklo_epi16(pixels, zero), transparent_key));
+        _mm_storeu_si128((__m128i *)(dst + i + 4), to_32_bit_x4(_mm_unpackhi_epi16(pixels, zero), transparent_key));
+    }
+#elif defined(IMAGEPAK_NEON)
+    for (; i + 8 <= count; i += 8) {
+        const uint16x8_t pixels = vreinterpretq_u16_u8(vld1q_u8(src + i * 2));
+        vst1q_u32(dst + i, to_32_bit_x4(vmovl_u16(vget_low_u16(pixels)), transparent_key));
+        vst1q_u32(dst + i + 4, to_32_bit_x4(vmovl_u16(vget_high_u16(pixels)), transparent_key));
+    }
+#endif
+    for (; i < count; ++i) {
+        const color c = to_32_bit((uint16_t)(src[i * 2] | (src[i * 2 + 1] << 8)));
+        dst[i] = (transparent_key && c == COLOR_SG2_TRANSPARENT) ? ALPHA_TRANSPARENT : c;
+    }
+}
+
+// Cursor over the raw pak bytes, every image gets its own so images can be decoded in parallel.
+// Reads past the end give zero pixels and do not move, the same as buffer::read_u16.
+struct pak_pixels {
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+
+    uint8_t read_u8() {
+        return offset < size ? data[offset++] : 0;
+    }
+
+    void read(color *dst, int count, bool transparent_key) {
+        const int available = std::min<int>(count, offset < size ? int((size - offset) / 2) : 0);
+        convert_555(data + offset, dst, available, transparent_key);
+        offset += available * 2;
+        for (int i = available; i < count; ++i) {
+            dst[i] = to_32_bit(0);
+        }
+    }
+};
+
 static color to_argb(uint32_t c) {
     return (((c >> 24) & 0xff) << 24) | (((c & 0xff) << 16) | (((c >> 8) & 0xff) << 8) | ((c >> 16) & 0xff));
 }
@@ -50,43 +133,43 @@ static int copy_to_atlas(const image_t* img) {
     return pixels_count;
 }
 
-static int convert_uncompressed(buffer* buf, const image_t &img) {
-    int pixels_count = 0;
+static int convert_uncompressed(pak_pixels &src, const image_t &img) {
     atlas_data_t *p_atlas = img.atlas.p_atlas;
 
     for (int y = 0; y < img.height; y++) {
         color* pixel = &p_atlas->temp_pixel_buffer[(img.atlas.offset.y + y) * p_atlas->width + img.atlas.offset.x];
-        for (int x = 0; x < img.width; x++) {
-            color color = to_32_bit(buf->read_u16());
-            pixel[x] = color == COLOR_SG2_TRANSPARENT ? ALPHA_TRANSPARENT : color;
-            pixels_count++;
-        }
+        src.read(pixel, img.width, true);
     }
-    return pixels_count;
+    return img.width * img.height;
 }
 
-static int convert_compressed(buffer* buf, int data_length, const image_t &img) {
-    // int pixels_count = 0;
+static int convert_compressed(pak_pixels &src, int data_length, const image_t &img) {
+    if (img.width <= 0) {
+        return 0;
+    }
+
     atlas_data_t *p_atlas = img.atlas.p_atlas;
-    int atlas_dst = (img.atlas.offset.y * p_atlas->width) + img.atlas.offset.x;
+    color *origin = &p_atlas->temp_pixel_buffer[(img.atlas.offset.y * p_atlas->width) + img.atlas.offset.x];
     int y = 0;
     int x = 0;
     while (data_length > 0) {
-        uint8_t control = buf->read_u8();
+        uint8_t control = src.read_u8();
         if (control == 0xff) {
             // next byte = transparent pixels to skip
-            x += buf->read_u8();
+            x += src.read_u8();
             while (x >= img.width) {
                 y++;
                 x -= img.width;
             }
             data_length -= 2;
         } else {
-            // control = number of concrete pixels
-            for (int i = 0; i < control; i++) {
-                int dst = atlas_dst + y * p_atlas->width + x;
-                p_atlas->temp_pixel_buffer[dst] = to_32_bit(buf->read_u16());
-                x++;
+            // control = number of concrete pixels, a run may continue on the next row
+            int left = control;
+            while (left > 0) {
+                const int count = std::min(left, img.width - x);
+                src.read(origin + y * p_atlas->width + x, count, false);
+                left -= count;
+                x += count;
                 if (x >= img.width) {
                     y++;
                     x -= img.width;
@@ -105,24 +188,23 @@ static const int FOOTPRINT_X_START_PER_HEIGHT[] = {
 constexpr int FOOTPRINT_HEIGHT = 30;
 #define FOOTPRINT_HALF_HEIGHT 15
 
-static int convert_footprint_tile(buffer* buf, const image_t &img, int x_offset, int y_offset) {
+static int convert_footprint_tile(pak_pixels &src, const image_t &img, int x_offset, int y_offset) {
     int pixels_count = 0;
     auto p_atlas = img.atlas.p_atlas;
 
     for (int y = 0; y < FOOTPRINT_HEIGHT; y++) {
         int x_start = FOOTPRINT_X_START_PER_HEIGHT[y];
         int x_max = FOOTPRINT_WIDTH - x_start;
-        for (int x = x_start; x < x_max; x++) {
-            int dst_index = (y + y_offset + img.atlas.offset.y) * p_atlas->width + img.atlas.offset.x + x + x_offset;
-            if (dst_index >= p_atlas->bmp_size)
-                continue;
-            p_atlas->temp_pixel_buffer[dst_index] = to_32_bit(buf->read_u16());
-        }
+        int dst_index = (y + y_offset + img.atlas.offset.y) * p_atlas->width + img.atlas.offset.x + x_start + x_offset;
+        // pixels past the end of the page are not read at all
+        int count = std::clamp(p_atlas->bmp_size - dst_index, 0, x_max - x_start);
+        src.read(&p_atlas->temp_pixel_buffer[dst_index], count, false);
+        pixels_count += count;
     }
     return pixels_count;
 }
 
-static int convert_isometric_footprint(buffer* buf, const image_t &img) {
+static int convert_isometric_footprint(pak_pixels &src, const image_t &img) {
     int pixels_count = 0;
     auto p_atlas = img.atlas.p_atlas;
 
@@ -136,7 +218,7 @@ static int convert_isometric_footprint(buffer* buf, const image_t &img) {
         int x = -FOOTPRINT_HEIGHT * i + x_start;
         int y = FOOTPRINT_HALF_HEIGHT * i + y_offset;
         for (int j = 0; j <= i; j++) {
-            convert_footprint_tile(buf, img, x, y);
+            convert_footprint_tile(src, img, x, y);
             x += FOOTPRINT_WIDTH + 2;
         }
     }
@@ -144,7 +226,7 @@ static int convert_isometric_footprint(buffer* buf, const image_t &img) {
         int x = -FOOTPRINT_HEIGHT * i + x_start;
         int y = FOOTPRINT_HALF_HEIGHT * (num_tiles * 2 - i - 2) + y_offset;
         for (int j = 0; j <= i; j++) {
-            convert_footprint_tile(buf, img, x, y);
+            convert_footprint_tile(src, img, x, y);
             x += FOOTPRINT_WIDTH + 2;
         }
     }
@@ -321,19 +403,21 @@ static void isometric_clear_foot_bottom(const image_t &img) {
     }
 }
 
-static bool convert_image_data(buffer* buf, image_t &img, bool convert_fonts) {
-    if (img.is_external)
-        buf = load_external_data(img);
-
-    if (buf == nullptr)
-        return false;
+static bool convert_image_data(pak_pixels src, image_t &img, bool convert_fonts) {
+    if (img.is_external) {
+        buffer *buf = load_external_data(img);
+        if (buf == nullptr) {
+            return false;
+        }
+        src = {buf->get_data(), buf->size(), buf->get_offset()};
+    }
 
     img.temp_pixel_data = &img.atlas.p_atlas->temp_pixel_buffer[(img.atlas.offset.y * img.atlas.p_atlas->width) + img.atlas.offset.x];
 
     if (img.type == IMAGE_TYPE_ISOMETRIC) {
-        convert_isometric_footprint(buf, img);
+        convert_isometric_footprint(src, img);
         if (img.has_isometric_top) {
-            convert_compressed(buf, img.data_length - img.uncompressed_length, img);
+            convert_compressed(src, img.data_length - img.uncompressed_length, img);
             img.isometric_box_height = isometric_calculate_top_height(img);
         }
 
@@ -345,9 +429,9 @@ static bool convert_image_data(buffer* buf, image_t &img, bool convert_fonts) {
             isometric_clear_foot_bottom(img);
         }
     } else if (img.is_fully_compressed) {
-        convert_compressed(buf, img.data_length, img);
+        convert_compressed(src, img.data_length, img);
     } else {
-        convert_uncompressed(buf, img);
+        convert_uncompressed(src, img);
     }
 
     if (convert_fonts) { // special font conversions
@@ -411,6 +495,7 @@ void imagepak::cleanup_and_destroy() {
 
         atlas_data.temp_pixel_buffer = nullptr;
         if (atlas_data.texture != nullptr) {
+            painter_grayscale_release(atlas_data.texture);
             SDL_DestroyTexture(atlas_data.texture);
         }
         atlas_data.texture = nullptr;
@@ -437,10 +522,11 @@ bool imagepak::load_zip_pak(pcstr pak, int starting_index) {
     }
 
     vfs::path configname(datafile, "/", pak, ".js");
-    archive arch = config::load(configname);
+    // pak configs are not part of the config snapshot, read them from the script engine
+    g_archive pak_arch = config::load(configname);
 
     global_image_index_offset = starting_index;
-    g_config_arch.r_array(pak, [&] (archive arch) {
+    pak_arch.r_array(pak, [&] (archive arch) {
         int start_index = arch.r_int("start_index");
         int finish_index = arch.r_int("finish_index");
         entries_num += (finish_index - start_index) + 1;
@@ -612,8 +698,21 @@ bool imagepak::load_zip_pak(pcstr pak, int starting_index) {
 }
 
 buffer* pak_buf = new buffer(MAX_FILE_SCRATCH_SIZE);
+const std::vector<imagepak_timing_t> &imagepak_timings() {
+    return g_imagepak_timings;
+}
+
+static float elapsed_ms(std::chrono::steady_clock::time_point &since) {
+    const auto now = std::chrono::steady_clock::now();
+    const float ms = std::chrono::duration<float, std::milli>(now - since).count();
+    since = now;
+    return ms;
+}
+
 bool imagepak::load_pak(pcstr pak_name, int starting_index) {
     OZZY_PROFILER_SECTION("Game/Loading/Resources/ImagePak");
+    imagepak_timing_t timing = {pak_name, 0, 1, 0.f, 0.f, 0.f, 0.f};
+    auto stage_start = std::chrono::steady_clock::now();
 
     // construct proper filepaths
     name = pak_name;
@@ -830,6 +929,8 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
         atlas_pages.push_back(atlas_data);
     }
 
+    timing.index_ms = elapsed_ms(stage_start);
+
     // *********** PAK_FILE.555 ************
 
     // read bitmap data into buffer
@@ -837,8 +938,11 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
     if (!io_read_file_into_buffer((const char *)filename_555, MAY_BE_LOCALIZED, pak_buf, MAX_FILE_SCRATCH_SIZE)) {
         return false;
     }
+    timing.read_ms = elapsed_ms(stage_start);
 
     // finish filling in image and atlas information
+    std::vector<image_t *> decode_list;
+    decode_list.reserve(images_array.size());
     for (auto &img: images_array) {
         if (has_system_bmp && !should_load_system_sprites && img.sgx_index < 201) {
             continue;
@@ -855,10 +959,38 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
         img.atlas.offset = rect->output.pos;
         //        p_data->images.push_back(img);
 
-        // load and convert image bitmap data
-        pak_buf->set_offset(img.sgx_data_offset);
-        convert_image_data(pak_buf, img, should_convert_fonts);
+        // external images share one scratch buffer for their file reads, so they stay on this thread
+        if (img.is_external) {
+            convert_image_data({nullptr, 0, 0}, img, should_convert_fonts);
+        } else {
+            decode_list.push_back(&img);
+        }
+    }
+
+    // every image writes its own atlas rect, so the rest is decoded in parallel
+    {
+        OZZY_PROFILER_SECTION("Game/Loading/Resources/ImagePak/Decode");
+        const pak_pixels pixels = {pak_buf->get_data(), pak_buf->size(), 0};
+        const bool convert_fonts = should_convert_fonts;
+        auto decode = [&] (int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                pak_pixels src = pixels;
+                src.offset = decode_list[i]->sgx_data_offset;
+                convert_image_data(src, *decode_list[i], convert_fonts);
+            }
+        };
+
+        const int count = (int)decode_list.size();
+        timing.threads = game.mt.get_thread_count();
+        if (timing.threads > 0 && count > 64) {
+            // sprite sizes vary a lot, smaller blocks keep the workers busy until the end
+            game.mt.submit_blocks(0, count, decode, timing.threads * 8).wait();
+        } else {
+            timing.threads = 1;
+            decode(0, count);
+        }
     }
+    timing.decode_ms = elapsed_ms(stage_start);
 
     // create textures from atlas data
     for (int i = 0; i < atlas_pages.size(); ++i) {
@@ -889,11 +1021,16 @@ bool imagepak::load_pak(pcstr pak_name, int starting_index) {
     }
 
     image_packer_reset(packer);
+    timing.upload_ms = elapsed_ms(stage_start);
+    timing.images = (int)images_array.size();
+    g_imagepak_timings.push_back(timing);
 
     logs::info("Loaded imagepak from '%s' ---- %i images, %i groups, %ix%i atlas pages (%u)",
                filename_sgx.c_str(),
                entries_num, groups_num,
                atlas_pages.at(atlas_pages.size() - 1).width, atlas_pages.at(atlas_pages.size() - 1).height, atlas_pages.size());
+    logs::info("Imagepak %s timing: index %.1f ms, read %.1f ms, decode %.1f ms (%u threads), upload %.1f ms",
+               pak_name, timing.index_ms, timing.read_ms, timing.decode_ms, timing.threads, timing.upload_ms);
 
     int y_offset = screen_height() - 24;
 
@@ -12,6 +12,18 @@
 
 #define PAK_IMAGE_ENTRY_SIZE 64
 
+// Load times of one .sg3/.555 pak, kept for the "imagepaks" console command
+struct imagepak_timing_t {
+    bstring64 name;
+    int images;
+    uint32_t threads;
+    float index_ms;  // .sg3 parse and atlas packing
+    float read_ms;   // .555 file read
+    float decode_ms; // pixel conversion into the atlas pages
+    float upload_ms; // texture creation
+};
+
+const std::vector<imagepak_timing_t> &imagepak_timings();
 
 class imagepak {
 public:
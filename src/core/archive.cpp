@@ -1,180 +1,188 @@
 #include "core/archive.h"
 
+#include "core/archive_snapshot.h"
 #include "graphics/animation.h"
 #include "graphics/image_desc.h"
 
 #include "mujs/mujs.h"
 
+static inline archive_snapshot *snapshot(void *state) {
+    return (state == &g_config_snapshot) ? &g_config_snapshot : nullptr;
+}
+
 void archive::getproperty(int idx, pcstr name) {
+    if (auto s = snapshot(state)) { s->getproperty(idx, name); return; }
     js_getproperty((js_State*)state, idx, name);
 }
 
 void archive::getproperty(archive arch, int idx, pcstr name) {
-    js_getproperty((js_State *)(arch.state), idx, name);
+    arch.getproperty(idx, name);
 }
 
 bool archive::isarray(int idx) {
+    if (auto s = snapshot(state)) { return s->type(idx) == archive_snapshot::t_array; }
     return js_isarray((js_State*)state, idx);
 }
 
 int archive::getlength(int idx) {
+    if (auto s = snapshot(state)) { return s->getlength(idx); }
     return js_getlength((js_State*)state, idx);
 }
 
 void archive::getindex(int idx, int i) {
+    if (auto s = snapshot(state)) { s->getindex(idx, i); return; }
     js_getindex((js_State*)state, idx, i);
 }
 
 bool archive::isnumber(int idx) {
+    if (auto s = snapshot(state)) {
+        // js_iscnumber compares the value type with a class id and also matches objects, kept as is
+        const auto type = s->type(idx);
+        return type == archive_snapshot::t_number || type >= archive_snapshot::t_array;
+    }
     return (js_isnumber((js_State*)state, idx) || js_iscnumber((js_State*)state, idx));
 }
 
 bool archive::isstring(int idx) {
+    if (auto s = snapshot(state)) { return s->type(idx) == archive_snapshot::t_string; }
     return js_isstring((js_State *)state, idx);
 }
 
 bool archive::isboolean(int idx) {
+    if (auto s = snapshot(state)) { return s->type(idx) == archive_snapshot::t_boolean; }
     return js_isboolean((js_State *)state, idx);
 }
 
+bool archive::isundefined(int idx) {
+    if (auto s = snapshot(state)) { return s->type(idx) == archive_snapshot::t_undefined; }
+    return js_isundefined((js_State *)state, idx);
+}
+
 double archive::tonumber(int idx) {
+    if (auto s = snapshot(state)) { return s->tonumber(idx); }
     return js_tonumber((js_State*)state, idx);
 }
 
+int archive::tointeger(int idx) {
+    if (auto s = snapshot(state)) { return s->tointeger(idx); }
+    return js_tointeger((js_State *)state, idx);
+}
+
+uint32_t archive::touint32(int idx) {
+    if (auto s = snapshot(state)) { return s->touint32(idx); }
+    return js_touint32((js_State *)state, idx);
+}
+
 pcstr archive::tostring(int idx) {
+    if (auto s = snapshot(state)) { return s->tostring(idx); }
     return js_tostring((js_State *)state, idx);
 }
 
 bool archive::toboolean(int idx) {
+    if (auto s = snapshot(state)) { return s->toboolean(idx); }
     return js_toboolean((js_State *)state, idx);
 }
 
 void archive::pop(int num) {
+    if (auto s = snapshot(state)) { s->pop(num); return; }
     js_pop((js_State *)state, num);
 }
 
 void archive::pop(archive arch, int n) {
-    js_pop((js_State *)(arch.state), n);
+    arch.pop(n);
 }
 
 bool archive::isobject(int idx) {
+    // arrays are objects too, same as in js
+    if (auto s = snapshot(state)) { return s->type(idx) >= archive_snapshot::t_array; }
     return js_isobject((js_State *)state, idx);
 }
 
 bool archive::isobject(archive arch, int idx) {
-    return js_isobject((js_State *)(arch.state), idx);
+    return arch.isobject(idx);
 }
 
 void archive::pushiterator(archive arch, int idx, int own) {
+    if (auto s = snapshot(arch.state)) { s->pushiterator(idx); return; }
     js_pushiterator((js_State *)(arch.state), idx, own);
 }
 
 pcstr archive::nextiterator(archive arch, int idx) {
+    if (auto s = snapshot(arch.state)) { return s->nextiterator(idx); }
     return js_nextiterator((js_State *)(arch.state), idx);
 }
 
 void archive::getglobal(pcstr name) {
+    if (auto s = snapshot(state)) { s->getglobal(name); return; }
     js_getglobal((js_State *)state, name);
 }
 
 const uint8_t *lang_get_string(int group, int index);
 pcstr archive::r_string(pcstr name) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     pcstr result = "";
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         ;
-    } else if (js_isstring(vm, -1)) {
-        result = js_tostring(vm, -1);
-    } else if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
+    } else if (isstring(-1)) {
+        result = tostring(-1);
+    } else if (isarray(-1)) {
+        int length = getlength(-1);
         vec2i gx;
         if (length == 2) {
-            js_getindex(vm, -1, 0); gx.x = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
-            js_getindex(vm, -1, 1); gx.y = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+            getindex(-1, 0); gx.x = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
+            getindex(-1, 1); gx.y = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
         }
 
         result = (pcstr)lang_get_string(gx.x, gx.y);
-    } else if (js_isobject(vm, -1)) {
-        js_getproperty(vm, -1, "group"); int group = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "id"); int id = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
+    } else if (isobject(-1)) {
+        getproperty(-1, "group"); int group = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "id"); int id = isundefined(-1) ? 0 : tointeger(-1); pop(1);
         result = (pcstr)lang_get_string(group, id);
     }
-    js_pop(vm, 1);
+    pop(1);
     return result;
 }
 
 std::vector<std::string> archive::r_array_str(pcstr name) {
-    auto vm = (js_State *)state;
-
-    js_getproperty(vm, -1, name);
-    std::vector<std::string> result;
-    if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
-        for (int i = 0; i < length; ++i) {
-            js_getindex(vm, -1, i);
-            pcstr v = js_tostring(vm, -1);
-            result.emplace_back(v);
-            js_pop(vm, 1);
-        }
-    }
-    if (js_isundefined(vm, -1)) {
-        int i = 0;
-        ;
-    }
-    if (js_isobject(vm, -1)) {
-        int i = 0;
-        ;
-    }
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    std::vector<std::string> result = to_array_str();
+    pop(1);
 
     return result;
 }
 
 std::vector<std::string> archive::to_array_str() {
-    auto vm = (js_State *)state;
-
     std::vector<std::string> result;
-    if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
+    if (isarray(-1)) {
+        int length = getlength(-1);
         for (int i = 0; i < length; ++i) {
-            js_getindex(vm, -1, i);
-            pcstr v = js_tostring(vm, -1);
+            getindex(-1, i);
+            pcstr v = tostring(-1);
             result.emplace_back(v);
-            js_pop(vm, 1);
+            pop(1);
         }
     }
-    if (js_isundefined(vm, -1)) {
-        int i = 0;
-        ;
-    }
-    if (js_isobject(vm, -1)) {
-        int i = 0;
-        ;
-    }
 
     return result;
 }
 
 archive::variant_t archive::to_variant() {
-    auto vm = (js_State *)state;
-
     variant_t result;
     pcstr name = "unknown";
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         result = variant_t(variant_none_t{ name });
-    } else if (js_isstring(vm, -1)) {
-        const xstring str = js_tostring(vm, -1);
+    } else if (isstring(-1)) {
+        const xstring str = tostring(-1);
         result = variant_t(str);
-    } else if (js_isboolean(vm, -1)) {
-        const bool v = js_toboolean(vm, -1);
+    } else if (isboolean(-1)) {
+        const bool v = toboolean(-1);
         result = variant_t(v);
-    } else if (js_isnumber(vm, -1)) {
-        const float f = js_tonumber(vm, -1);
+    } else if (isnumber(-1)) {
+        const float f = tonumber(-1);
         result = variant_t(f);
-    } else if (js_isobject(vm, -1)) {
+    } else if (isobject(-1)) {
         result = variant_t(variant_object_t{ name });
-    } else if (js_isarray(vm, -1)) {
+    } else if (isarray(-1)) {
         result = variant_t(variant_array_t{ name });
     }
 
@@ -182,77 +190,59 @@ archive::variant_t archive::to_variant() {
 }
 
 archive::variant_t archive::r_variant(pcstr name) {
-    auto vm = (js_State *)state;
-
-    js_getproperty(vm, -1, name);
-    variant_t result;
-    if (js_isundefined(vm, -1)) {
+    getproperty(-1, name);
+    variant_t result = to_variant();
+    if (std::holds_alternative<variant_none_t>(result)) {
         result = variant_t(variant_none_t{name});
-    } else if (js_isstring(vm, -1)) {
-        const xstring str = js_tostring(vm, -1);
-        result = variant_t(str);
-    } else if (js_isboolean(vm, -1)) {
-        const bool v = js_toboolean(vm, -1);
-        result = variant_t(v);
-    } else if (js_isnumber(vm, -1)) {
-        const float f = js_tonumber(vm, -1);
-        result = variant_t(f);
-    } else if (js_isobject(vm, -1)) {
-        result = variant_t(variant_object_t{ name });
-    } else if (js_isarray(vm, -1)) {
-        result = variant_t(variant_array_t{ name });
+    } else if (std::holds_alternative<variant_object_t>(result)) {
+        result = variant_t(variant_object_t{name});
     }
-    js_pop(vm, 1);
+    pop(1);
 
     return result;
 }
 
 std::vector<vec2i> archive::r_array_vec2i(pcstr name) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     std::vector<vec2i> result;
-    if (js_isarray(vm, -1)) {
-        int length = js_getlength(vm, -1);
+    if (isarray(-1)) {
+        int length = getlength(-1);
         for (int i = 0; i < length; ++i) {
-            js_getindex(vm, -1, i);
+            getindex(-1, i);
             vec2i v = r_vec2i_impl("x", "y");
             result.push_back(v);
-            js_pop(vm, 1);
+            pop(1);
         }
-        js_pop(vm, 1);
+        pop(1);
     }
     return result;
 }
 
 int archive::r_int(pcstr name, int def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    int result = js_isundefined(vm, -1) ? def : js_tointeger(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    int result = isundefined(-1) ? def : tointeger(-1);
+    pop(1);
     return result;
 }
 
 float archive::r_float(pcstr name, float def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    float result = js_isundefined(vm, -1) ? def : (float)js_tonumber(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    float result = isundefined(-1) ? def : (float)tonumber(-1);
+    pop(1);
     return result;
 }
 
 uint32_t archive::r_uint(pcstr name, uint32_t def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    uint32_t result = js_isundefined(vm, -1) ? def : js_touint32(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    uint32_t result = isundefined(-1) ? def : touint32(-1);
+    pop(1);
     return result;
 }
 
 bool archive::r_bool(pcstr name, bool def) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
-    bool result = js_isundefined(vm, -1) ? def : js_toboolean(vm, -1);
-    js_pop(vm, 1);
+    getproperty(-1, name);
+    bool result = isundefined(-1) ? def : toboolean(-1);
+    pop(1);
     return result;
 }
 
@@ -261,20 +251,19 @@ vec2i archive::r_size2i(pcstr name, pcstr w, pcstr h) {
 }
 
 vec2i archive::r_vec2i_impl(pcstr x, pcstr y) {
-    auto vm = (js_State *)state;
     vec2i result(0, 0);
-    if (js_isobject(vm, -1)) {
-        if (js_isarray(vm, -1)) {
-            int length = js_getlength(vm, -1);
+    if (isobject(-1)) {
+        if (isarray(-1)) {
+            int length = getlength(-1);
             if (length > 0) {
-                js_getindex(vm, -1, 0); result.x = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+                getindex(-1, 0); result.x = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
                 if (length > 1) {
-                    js_getindex(vm, -1, 1); result.y = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+                    getindex(-1, 1); result.y = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
                 }
             }
         } else {
-            js_getproperty(vm, -1, x); result.x = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
-            js_getproperty(vm, -1, y); result.y = !js_isundefined(vm, -1) ? js_tointeger(vm, -1) : 0; js_pop(vm, 1);
+            getproperty(-1, x); result.x = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
+            getproperty(-1, y); result.y = !isundefined(-1) ? tointeger(-1) : 0; pop(1);
         }
     }
 
@@ -282,45 +271,42 @@ vec2i archive::r_vec2i_impl(pcstr x, pcstr y) {
 }
 
 vec2i archive::r_vec2i(pcstr name, pcstr x, pcstr y) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     vec2i result = r_vec2i_impl(x, y);
-    js_pop(vm, 1);
+    pop(1);
 
     return result;
 }
 
 bool archive::r_anim(pcstr name, animation_t &anim) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     bool ok = false;
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         ;
-    } else if (js_isobject(vm, -1)) {
-        js_getproperty(vm, -1, "pack"); anim.pack = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "id"); anim.iid = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "offset"); anim.offset = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "duration"); anim.duration = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "max_frames"); anim.max_frames = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
+    } else if (isobject(-1)) {
+        getproperty(-1, "pack"); anim.pack = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "id"); anim.iid = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "offset"); anim.offset = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "duration"); anim.duration = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "max_frames"); anim.max_frames = isundefined(-1) ? 0 : tointeger(-1); pop(1);
         ok = true;
     }
-    js_pop(vm, 1);
+    pop(1);
     return ok;
 }
 
 bool archive::r_desc(pcstr name, image_desc &desc) {
-    auto vm = (js_State *)state;
-    js_getproperty(vm, -1, name);
+    getproperty(-1, name);
     bool ok = false;
-    if (js_isundefined(vm, -1)) {
+    if (isundefined(-1)) {
         ;
-    } else if (js_isobject(vm, -1)) {
-        js_getproperty(vm, -1, "pack"); desc.pack = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "id"); desc.id = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
-        js_getproperty(vm, -1, "offset"); desc.offset = js_isundefined(vm, -1) ? 0 : js_tointeger(vm, -1); js_pop(vm, 1);
+    } else if (isobject(-1)) {
+        getproperty(-1, "pack"); desc.pack = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "id"); desc.id = isundefined(-1) ? 0 : tointeger(-1); pop(1);
+        getproperty(-1, "offset"); desc.offset = isundefined(-1) ? 0 : tointeger(-1); pop(1);
         ok = true;
     }
-    js_pop(vm, 1);
+    pop(1);
     return ok;
 }
 
@@ -329,6 +315,11 @@ void g_archive::w_property(pcstr name, pcstr prop, const xstring &value) {
         return;
     }
 
+    if (auto s = snapshot(state)) {
+        s->set_global_property(name, prop, s->new_value(archive_snapshot::t_string, 0, value.c_str()));
+        return;
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
@@ -346,6 +337,11 @@ void g_archive::w_property(pcstr name, pcstr prop, bool value) {
         return;
     }
 
+    if (auto s = snapshot(state)) {
+        s->set_global_property(name, prop, s->new_value(archive_snapshot::t_boolean, value ? 1 : 0));
+        return;
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
@@ -363,6 +359,11 @@ void g_archive::w_property(pcstr name, pcstr prop, float value) {
         return;
     }
 
+    if (auto s = snapshot(state)) {
+        s->set_global_property(name, prop, s->new_value(archive_snapshot::t_number, value));
+        return;
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
@@ -380,6 +381,14 @@ void g_archive::w_property(pcstr name, pcstr prop, vec2i value) {
         return;
     }
 
+    if (auto s = snapshot(state)) {
+        const uint32_t v = s->new_object();
+        s->add_property(v, "x", s->new_value(archive_snapshot::t_number, value.x));
+        s->add_property(v, "y", s->new_value(archive_snapshot::t_number, value.y));
+        s->set_global_property(name, prop, v);
+        return;
+    }
+
     auto J = (js_State *)state;
     getglobal(name);
     if (js_isundefined(J, -1)) {
@@ -393,3 +402,29 @@ void g_archive::w_property(pcstr name, pcstr prop, vec2i value) {
     js_setproperty(J, -2, prop);
     js_setglobal(J, name);
 }
+
+static std::string *dump_target = nullptr;
+static void dump_append(js_State *, pcstr v) {
+    dump_target->append(v);
+}
+
+void g_archive::w_dump(pcstr name, std::string &out) {
+    if (!state) {
+        return;
+    }
+
+    if (auto s = snapshot(state)) {
+        s->dump_global(name, out);
+        return;
+    }
+
+    auto J = (js_State *)state;
+    dump_target = &out;
+    js_setdumping(J, &dump_append);
+    js_getglobal(J, name);
+    if (js_isobject(J, -1)) {
+        js_dumpobject_ex(J, -1);
+    }
+    js_pop(J, 1);
+    dump_target = nullptr;
+}
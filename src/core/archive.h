@@ -272,7 +272,10 @@ protected:
     bool isnumber(int idx);
     bool isstring(int idx);
     bool isboolean(int idx);
+    bool isundefined(int idx);
     double tonumber(int idx);
+    int tointeger(int idx);
+    uint32_t touint32(int idx);
     pcstr tostring(int idx);
     bool toboolean(int idx);
     void pop(int num);
@@ -327,6 +330,7 @@ struct g_archive : public archive {
     void w_property(pcstr name, pcstr prop, bool value);
     void w_property(pcstr name, pcstr prop, float value);
     void w_property(pcstr name, pcstr prop, vec2i value);
+    void w_dump(pcstr name, std::string &out);
 
     bool p_isobject() {
         return state ? isobject(-1) : false;
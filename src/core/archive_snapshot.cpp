@@ -0,0 +1,625 @@
+#include "core/archive_snapshot.h"
+
+#include "content/dir.h"
+#include "content/vfs.h"
+#include "core/log.h"
+#include "core/profiler.h"
+
+#include "mujs/mujs.h"
+#include "mujs/jsi.h"
+#include "mujs/jsvalue.h"
+
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <stdlib.h>
+#include <string.h>
+
+namespace fs = std::filesystem;
+
+archive_snapshot g_config_snapshot;
+
+static const uint32_t SNAPSHOT_MAGIC = 0x47464341; // "ACFG"
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const int SNAPSHOT_MAX_DEPTH = 64;
+
+static uint32_t fnv1a(const void *data, size_t size, uint32_t h = 2166136261u) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static uint32_t key_hash(pcstr key) {
+    return fnv1a(key, strlen(key));
+}
+
+struct snapshot_builder {
+    archive_snapshot &s;
+    js_State *J;
+
+    uint32_t value(int depth);
+    uint32_t object(uint32_t id, int depth, const std::vector<std::string> *names = nullptr);
+    uint32_t array(uint32_t id, int depth);
+};
+
+uint32_t snapshot_builder::value(int depth) {
+    if (js_isundefined(J, -1)) {
+        return 0;
+    }
+
+    // functions are kept as empty objects, the loaders only check that they are objects
+    if (js_iscallable(J, -1)) {
+        return s.new_object();
+    }
+
+    if (js_isnull(J, -1)) {
+        return s.new_value(archive_snapshot::t_null);
+    }
+
+    if (js_isboolean(J, -1)) {
+        return s.new_value(archive_snapshot::t_boolean, js_toboolean(J, -1) ? 1 : 0);
+    }
+
+    if (js_isnumber(J, -1)) {
+        return s.new_value(archive_snapshot::t_number, js_tonumber(J, -1));
+    }
+
+    if (js_isstring(J, -1)) {
+        return s.new_value(archive_snapshot::t_string, 0, js_tostring(J, -1));
+    }
+
+    if (!js_isobject(J, -1) || depth > SNAPSHOT_MAX_DEPTH) {
+        return 0;
+    }
+
+    // objects shared between several entries are copied, the depth limit stops cycles
+    const bool is_array = js_isarray(J, -1);
+    const uint32_t id = s.new_object(is_array ? archive_snapshot::t_array : archive_snapshot::t_object);
+    return is_array ? array(id, depth) : object(id, depth);
+}
+
+uint32_t snapshot_builder::array(uint32_t id, int depth) {
+    std::vector<uint32_t> items(js_getlength(J, -1));
+    for (int i = 0; i < (int)items.size(); ++i) {
+        js_getindex(J, -1, i);
+        items[i] = value(depth + 1);
+        js_pop(J, 1);
+    }
+
+    // children of a node are contiguous, so they are appended after the recursion
+    s.nodes[id].first = (uint32_t)s.children.size();
+    s.nodes[id].count = (uint32_t)items.size();
+    for (uint32_t item : items) {
+        s.children.push_back(item);
+        s.keys.push_back(0);
+        s.hashes.push_back(0);
+    }
+    return id;
+}
+
+uint32_t snapshot_builder::object(uint32_t id, int depth, const std::vector<std::string> *names) {
+    std::vector<std::string> own_names;
+    if (!names) {
+        js_pushiterator(J, -1, 1);
+        while (pcstr key = js_nextiterator(J, -1)) {
+            own_names.push_back(key);
+        }
+        js_pop(J, 1);
+        names = &own_names;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> props;
+    for (const auto &name : *names) {
+        js_getproperty(J, -1, name.c_str());
+        const uint32_t v = value(depth + 1);
+        js_pop(J, 1);
+        props.push_back({v, s.add_string(name.c_str())});
+    }
+
+    s.nodes[id].first = (uint32_t)s.children.size();
+    s.nodes[id].count = (uint32_t)props.size();
+    for (const auto &prop : props) {
+        s.children.push_back(prop.first);
+        s.keys.push_back(prop.second);
+        s.hashes.push_back(key_hash(s.strings.data() + prop.second));
+    }
+    return id;
+}
+
+void archive_snapshot::clear() {
+    nodes.clear();
+    children.clear();
+    keys.clear();
+    hashes.clear();
+    strings.clear();
+    sources.clear();
+    stack.clear();
+    env_hash = 0;
+}
+
+uint32_t archive_snapshot::add_string(pcstr value) {
+    const uint32_t offset = (uint32_t)strings.size();
+    strings.insert(strings.end(), value, value + strlen(value) + 1);
+    return offset;
+}
+
+uint32_t archive_snapshot::new_value(e_type type, double number, pcstr value) {
+    node_t node;
+    node.type = type;
+    node.number = number;
+    if (value) {
+        node.first = add_string(value);
+        node.count = (uint32_t)strlen(value);
+    }
+    nodes.push_back(node);
+    return (uint32_t)nodes.size() - 1;
+}
+
+uint32_t archive_snapshot::new_object(e_type type) {
+    node_t node;
+    node.type = type;
+    node.first = (uint32_t)children.size();
+    nodes.push_back(node);
+    return (uint32_t)nodes.size() - 1;
+}
+
+void archive_snapshot::build(js_State *J) {
+    OZZY_PROFILER_SECTION("Game/Config/Snapshot Build");
+    clear();
+    strings.push_back(0); // offset 0 is the empty string
+    nodes.push_back(node_t{}); // undefined
+
+    // script variables are not enumerable on the global object, so its property list is walked directly
+    std::vector<std::string> globals;
+    for (js_Property *prop = J->G->head; prop; prop = prop->next) {
+        globals.push_back(prop->name);
+    }
+
+    snapshot_builder builder{*this, J};
+    const uint32_t root = new_object();
+    js_pushglobal(J);
+    builder.object(root, 0, &globals);
+    js_pop(J, 1);
+}
+
+uint32_t archive_snapshot::hash() const {
+    uint32_t h = fnv1a(strings.data(), strings.size());
+    for (const auto &node : nodes) {
+        h = fnv1a(&node.type, sizeof(node.type), h);
+        h = fnv1a(&node.first, sizeof(node.first), h);
+        h = fnv1a(&node.count, sizeof(node.count), h);
+        h = fnv1a(&node.number, sizeof(node.number), h);
+    }
+    h = fnv1a(children.data(), children.size() * sizeof(uint32_t), h);
+    h = fnv1a(keys.data(), keys.size() * sizeof(uint32_t), h);
+    return h;
+}
+
+static bool file_stat(pcstr path, int64_t &size, int64_t &time) {
+    std::error_code ec;
+    size = (int64_t)fs::file_size(path, ec);
+    if (ec) {
+        size = -1;
+        time = 0;
+        return false;
+    }
+
+    time = (int64_t)fs::last_write_time(path, ec).time_since_epoch().count();
+    return !ec;
+}
+
+void archive_snapshot::add_source(pcstr path) {
+    source_t source;
+    source.path = path;
+    file_stat(path, source.size, source.time);
+    sources.push_back(source);
+}
+
+template<typename T>
+static void write_vector(FILE *fp, const std::vector<T> &v) {
+    const uint32_t size = (uint32_t)v.size();
+    fwrite(&size, sizeof(size), 1, fp);
+    if (size) {
+        fwrite(v.data(), sizeof(T), size, fp);
+    }
+}
+
+template<typename T>
+static bool read_vector(FILE *fp, long file_end, std::vector<T> &v) {
+    uint32_t size = 0;
+    if (fread(&size, sizeof(size), 1, fp) != 1) {
+        return false;
+    }
+
+    // a damaged size must not allocate more than the file can hold
+    const long remaining = file_end - ftell(fp);
+    if (remaining < 0 || size > (uint64_t)remaining / sizeof(T)) {
+        return false;
+    }
+    v.resize(size);
+    return !size || fread(v.data(), sizeof(T), size, fp) == size;
+}
+
+bool archive_snapshot::save(pcstr filename) const {
+    OZZY_PROFILER_SECTION("Game/Config/Snapshot Save");
+    vfs::path fs_file = vfs::content_path(filename);
+    FILE *fp = vfs::file_open_os(fs_file, "wb");
+    if (!fp) {
+        logs::info("Config snapshot: unable to write %s", fs_file.c_str());
+        return false;
+    }
+
+    const uint32_t header[4] = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, env_hash, (uint32_t)sources.size()};
+    fwrite(header, sizeof(uint32_t), 4, fp);
+    for (const auto &source : sources) {
+        const uint32_t length = (uint32_t)source.path.size();
+        fwrite(&length, sizeof(length), 1, fp);
+        fwrite(source.path.data(), 1, length, fp);
+        fwrite(&source.size, sizeof(source.size), 1, fp);
+        fwrite(&source.time, sizeof(source.time), 1, fp);
+    }
+
+    write_vector(fp, nodes);
+    write_vector(fp, children);
+    write_vector(fp, keys);
+    write_vector(fp, hashes);
+    write_vector(fp, strings);
+
+    vfs::file_close(fp);
+    vfs::sync_em_fs();
+    logs::info("Config snapshot: %u nodes, %u bytes of strings written to %s", (uint32_t)nodes.size(), (uint32_t)strings.size(), fs_file.c_str());
+    return true;
+}
+
+bool archive_snapshot::load(pcstr filename, uint32_t expected_env_hash) {
+    OZZY_PROFILER_SECTION("Game/Config/Snapshot Load");
+    clear();
+
+    vfs::path fs_file = vfs::content_path(filename);
+    FILE *fp = vfs::file_open_os(fs_file, "rb");
+    if (!fp) {
+        return false;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    const long file_end = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    uint32_t header[4] = {0};
+    bool ok = fread(header, sizeof(uint32_t), 4, fp) == 4;
+    ok = ok && header[0] == SNAPSHOT_MAGIC && header[1] == SNAPSHOT_VERSION;
+    if (ok && header[2] != expected_env_hash) {
+        logs::info("Config snapshot: registered constants changed, scripts will be evaluated");
+        ok = false;
+    }
+
+    sources.resize(ok ? header[3] : 0);
+    for (auto &source : sources) {
+        uint32_t length = 0;
+        ok = ok && fread(&length, sizeof(length), 1, fp) == 1 && length < 4096;
+        if (!ok) {
+            break;
+        }
+
+        source.path.resize(length);
+        ok = ok && fread(source.path.data(), 1, length, fp) == length;
+        ok = ok && fread(&source.size, sizeof(source.size), 1, fp) == 1;
+        ok = ok && fread(&source.time, sizeof(source.time), 1, fp) == 1;
+        if (!ok) {
+            break;
+        }
+
+        // any edited script falls back to the script engine
+        int64_t size, time;
+        file_stat(source.path.c_str(), size, time);
+        if (size != source.size || time != source.time) {
+            logs::info("Config snapshot: %s changed, scripts will be evaluated", source.path.c_str());
+            ok = false;
+        }
+    }
+
+    ok = ok && read_vector(fp, file_end, nodes);
+    ok = ok && read_vector(fp, file_end, children);
+    ok = ok && read_vector(fp, file_end, keys);
+    ok = ok && read_vector(fp, file_end, hashes);
+    ok = ok && read_vector(fp, file_end, strings);
+    vfs::file_close(fp);
+
+    if (ok && !check_tables()) {
+        logs::info("Config snapshot: %s is damaged, scripts will be evaluated", fs_file.c_str());
+        ok = false;
+    }
+
+    if (!ok) {
+        clear();
+        return false;
+    }
+
+    env_hash = expected_env_hash;
+    logs::info("Config snapshot: %u nodes loaded from %s", (uint32_t)nodes.size(), fs_file.c_str());
+    return true;
+}
+
+// every index read from disk is used unchecked later, so a snapshot is only taken when all of them fit
+bool archive_snapshot::check_tables() const {
+    if (!valid() || nodes[1].type != t_object) {
+        return false;
+    }
+
+    if (children.size() != keys.size() || children.size() != hashes.size()) {
+        return false;
+    }
+
+    // offset 0 is the empty string and every string ends with its terminator
+    if (strings.empty() || strings.front() != 0 || strings.back() != 0) {
+        return false;
+    }
+
+    for (const node_t &node : nodes) {
+        switch (node.type) {
+        case t_undefined:
+        case t_null:
+        case t_boolean:
+        case t_number:
+            break;
+
+        case t_string:
+            if ((uint64_t)node.first + node.count >= strings.size() || strings[node.first + node.count] != 0) {
+                return false;
+            }
+            break;
+
+        case t_array:
+        case t_object:
+            if ((uint64_t)node.first + node.count > children.size()) {
+                return false;
+            }
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < children.size(); ++i) {
+        if (children[i] >= nodes.size() || keys[i] >= strings.size()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint32_t archive_snapshot::find_property(uint32_t object, pcstr name) const {
+    const node_t &node = nodes[object];
+    if (node.type != t_object) {
+        return 0;
+    }
+
+    const uint32_t h = key_hash(name);
+    for (uint32_t i = node.first, end = node.first + node.count; i < end; ++i) {
+        if (hashes[i] == h && strcmp(str(keys[i]), name) == 0) {
+            return children[i];
+        }
+    }
+    return 0;
+}
+
+void archive_snapshot::getglobal(pcstr name) {
+    stack.push_back({find_property(1, name), -1});
+}
+
+void archive_snapshot::getproperty(int idx, pcstr name) {
+    stack.push_back({find_property(slot(idx).node, name), -1});
+}
+
+void archive_snapshot::getindex(int idx, int i) {
+    const node_t &node = nodes[slot(idx).node];
+    uint32_t result = 0;
+    if (node.type == t_array && i >= 0 && (uint32_t)i < node.count) {
+        result = children[node.first + i];
+    }
+    stack.push_back({result, -1});
+}
+
+int archive_snapshot::getlength(int idx) {
+    const node_t &node = nodes[slot(idx).node];
+    if (node.type == t_array) {
+        return (int)node.count;
+    }
+
+    getproperty(idx, "length");
+    const int length = tointeger(-1);
+    pop(1);
+    return length;
+}
+
+void archive_snapshot::pop(int n) {
+    stack.resize(stack.size() - n);
+}
+
+void archive_snapshot::pushiterator(int idx) {
+    stack.push_back({slot(idx).node, 0});
+}
+
+pcstr archive_snapshot::nextiterator(int idx) {
+    slot_t &it = slot(idx);
+    const node_t &node = nodes[it.node];
+    if (node.type != t_object || (uint32_t)it.iter >= node.count) {
+        return nullptr;
+    }
+    return str(keys[node.first + it.iter++]);
+}
+
+double archive_snapshot::tonumber(int idx) const {
+    const node_t &node = nodes[slot(idx).node];
+    switch (node.type) {
+    case t_null: return 0;
+    case t_boolean:
+    case t_number: return node.number;
+    case t_string: {
+        pcstr value = str(node.first);
+        while (*value == ' ' || *value == '\t' || *value == '\n') {
+            ++value;
+        }
+        if (!*value) {
+            return 0;
+        }
+        char *end = nullptr;
+        const double result = strtod(value, &end);
+        return (end && *end == 0) ? result : std::numeric_limits<double>::quiet_NaN();
+    }
+    default: return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+int archive_snapshot::tointeger(int idx) const {
+    // same rules as js_tointeger
+    const double n = tonumber(idx);
+    if (n == 0 || std::isnan(n)) {
+        return 0;
+    }
+
+    const double t = (n < 0) ? -floor(-n) : floor(n);
+    if (t < INT32_MIN) {
+        return INT32_MIN;
+    }
+    if (t > INT32_MAX) {
+        return INT32_MAX;
+    }
+    return (int)t;
+}
+
+uint32_t archive_snapshot::touint32(int idx) const {
+    const double n = tonumber(idx);
+    if (n == 0 || !std::isfinite(n)) {
+        return 0;
+    }
+
+    const double t = fmod((n < 0) ? -floor(-n) : floor(n), 4294967296.0);
+    return (uint32_t)(int64_t)(t < 0 ? t + 4294967296.0 : t);
+}
+
+bool archive_snapshot::toboolean(int idx) const {
+    const node_t &node = nodes[slot(idx).node];
+    switch (node.type) {
+    case t_undefined:
+    case t_null: return false;
+    case t_boolean:
+    case t_number: return node.number != 0 && !std::isnan(node.number);
+    case t_string: return node.count > 0;
+    default: return true;
+    }
+}
+
+pcstr archive_snapshot::tostring(int idx) {
+    const node_t &node = nodes[slot(idx).node];
+    switch (node.type) {
+    case t_undefined: return "undefined";
+    case t_null: return "null";
+    case t_boolean: return node.number ? "true" : "false";
+    case t_string: return str(node.first);
+    case t_number: {
+        char *buffer = scratch[scratch_index++ % 4];
+        snprintf(buffer, sizeof(scratch[0]), "%.15g", node.number);
+        return buffer;
+    }
+    case t_array: return "";
+    default: return "[object Object]";
+    }
+}
+
+void archive_snapshot::add_property(uint32_t object, pcstr key, uint32_t value_node) {
+    node_t &node = nodes[object];
+    for (uint32_t i = node.first, end = node.first + node.count; i < end; ++i) {
+        if (strcmp(str(keys[i]), key) == 0) {
+            children[i] = value_node;
+            return;
+        }
+    }
+
+    // ranges are packed, so a growing object is moved to the end first
+    if (node.first + node.count != children.size()) {
+        const uint32_t first = (uint32_t)children.size();
+        for (uint32_t i = 0; i < node.count; ++i) {
+            children.push_back(children[node.first + i]);
+            keys.push_back(keys[node.first + i]);
+            hashes.push_back(hashes[node.first + i]);
+        }
+        node.first = first;
+    }
+
+    children.push_back(value_node);
+    keys.push_back(add_string(key));
+    hashes.push_back(key_hash(key));
+    node.count++;
+}
+
+void archive_snapshot::set_global_property(pcstr name, pcstr prop, uint32_t value_node) {
+    uint32_t object = find_property(1, name);
+    if (!object) {
+        object = new_object();
+        add_property(1, name, object);
+    }
+    add_property(object, prop, value_node);
+}
+
+void archive_snapshot::dump_node(uint32_t id, std::string &out, int depth) const {
+    const node_t &node = nodes[id];
+    switch (node.type) {
+    case t_undefined: out.append("undefined"); break;
+    case t_null: out.append("null"); break;
+    case t_boolean: out.append(node.number ? "true" : "false"); break;
+    case t_number: {
+        char buffer[32];
+        snprintf(buffer, sizeof(buffer), "%.15g", node.number);
+        out.append(buffer);
+    }
+    break;
+
+    case t_string:
+        out.push_back('"');
+        for (pcstr c = str(node.first); *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                out.push_back('\\');
+            }
+            out.push_back(*c);
+        }
+        out.push_back('"');
+        break;
+
+    case t_array:
+    case t_object: {
+        const bool is_array = (node.type == t_array);
+        out.append(is_array ? "[" : "{\n");
+        for (uint32_t i = 0; i < node.count; ++i) {
+            if (!is_array) {
+                pcstr key = str(keys[node.first + i]);
+                const bool plain = strspn(key, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_$") == strlen(key);
+                out.append(depth + 1, '\t');
+                out.append(plain ? "" : "\"").append(key).append(plain ? "" : "\"");
+                out.append(": ");
+            }
+            dump_node(children[node.first + i], out, depth + 1);
+            if (i + 1 < node.count) {
+                out.append(is_array ? ", " : ",\n");
+            }
+        }
+        if (!is_array) {
+            out.push_back('\n');
+            out.append(depth, '\t');
+        }
+        out.append(is_array ? "]" : "}");
+    }
+    break;
+    }
+}
+
+void archive_snapshot::dump_global(pcstr name, std::string &out) const {
+    const uint32_t object = find_property(1, name);
+    if (object) {
+        dump_node(object, out, 0);
+    }
+}
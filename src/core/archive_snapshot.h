@@ -0,0 +1,98 @@
+#pragma once
+
+#include "core/xstring.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct js_State;
+
+// Read-only copy of the config object tree, detached from the script engine.
+// It is built once from the evaluated scripts and saved next to the game settings,
+// on the next start it is loaded instead of interpreting the scripts again, as long
+// as none of the script files changed. archive dispatches its stack primitives here
+// when its state points to a snapshot, so the config loaders do not see a difference.
+struct archive_snapshot {
+    enum e_type : uint8_t {
+        t_undefined = 0,
+        t_null,
+        t_boolean,
+        t_number,
+        t_string,
+        t_array,
+        t_object,
+    };
+
+    struct node_t {
+        e_type type = t_undefined;
+        uint32_t first = 0; // children range for arrays/objects, string offset for strings
+        uint32_t count = 0;
+        double number = 0;
+    };
+
+    struct source_t {
+        std::string path;
+        int64_t size = -1; // -1 when the file did not exist
+        int64_t time = 0;
+    };
+
+    std::vector<node_t> nodes;      // node 0 is undefined, node 1 is the global object
+    std::vector<uint32_t> children; // node ids
+    std::vector<uint32_t> keys;     // string offsets, parallel to children, 0 for arrays
+    std::vector<uint32_t> hashes;   // key hashes, parallel to children
+    std::vector<char> strings;
+    std::vector<source_t> sources;
+    uint32_t env_hash = 0;
+
+    bool valid() const { return nodes.size() > 1; }
+    void clear();
+    void build(js_State *J);
+    void add_source(pcstr path);
+    uint32_t hash() const;
+
+    bool save(pcstr filename) const;
+    bool load(pcstr filename, uint32_t expected_env_hash);
+
+    // archive backend, indices are relative to the top of the stack like in mujs
+    void getglobal(pcstr name);
+    void getproperty(int idx, pcstr name);
+    void getindex(int idx, int i);
+    int getlength(int idx);
+    void pop(int n);
+    void pushiterator(int idx);
+    pcstr nextiterator(int idx);
+
+    e_type type(int idx) const { return nodes[slot(idx).node].type; }
+    double tonumber(int idx) const;
+    int tointeger(int idx) const;
+    uint32_t touint32(int idx) const;
+    bool toboolean(int idx) const;
+    pcstr tostring(int idx);
+
+    void set_global_property(pcstr name, pcstr prop, uint32_t value_node);
+    uint32_t new_value(e_type type, double number = 0, pcstr str = nullptr);
+    uint32_t new_object(e_type type = t_object);
+    void add_property(uint32_t object, pcstr key, uint32_t value_node);
+    uint32_t add_string(pcstr value);
+    void dump_global(pcstr name, std::string &out) const;
+
+private:
+    struct slot_t {
+        uint32_t node;
+        int32_t iter; // next key for iterator slots, -1 for values
+    };
+
+    std::vector<slot_t> stack;
+    char scratch[4][32];
+    int scratch_index = 0;
+
+    const slot_t &slot(int idx) const { return stack[stack.size() + idx]; }
+    slot_t &slot(int idx) { return stack[stack.size() + idx]; }
+    pcstr str(uint32_t offset) const { return strings.data() + offset; }
+    uint32_t find_property(uint32_t object, pcstr name) const;
+    bool check_tables() const;
+    void dump_node(uint32_t node, std::string &out, int depth) const;
+};
+
+extern archive_snapshot g_config_snapshot;
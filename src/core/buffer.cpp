@@ -65,78 +65,72 @@ bool buffer::is_valid(size_t count) const {
     return result;
 }
 
-uint8_t buffer::read_u8() {
-    uint8_t result = 0;
-    if (is_valid(sizeof(result))) {
-        result = data.at(index++);
-    }
+// the save format is little endian, on little endian hosts values are copied as they are
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BUFFER_BIG_ENDIAN
+#endif
 
-    return result;
-}
-uint16_t buffer::read_u16() {
-    uint16_t result = 0;
-    if (is_valid(sizeof(result))) {
-        uint8_t b0 = data.at(index++);
-        uint8_t b1 = data.at(index++);
-        result = (uint16_t)(b0 | (b1 << 8));
+template<typename T>
+static inline T load_le(const uint8_t *src) {
+    T value;
+#ifdef BUFFER_BIG_ENDIAN
+    uint8_t *dst = (uint8_t *)&value;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dst[i] = src[sizeof(T) - 1 - i];
     }
-
-    return result;
+#else
+    memcpy(&value, src, sizeof(T));
+#endif
+    return value;
 }
-uint32_t buffer::read_u32() {
-    uint32_t result = 0;
-    if (is_valid(sizeof(result))) {
-        uint8_t b0 = data.at(index++);
-        uint8_t b1 = data.at(index++);
-        uint8_t b2 = data.at(index++);
-        uint8_t b3 = data.at(index++);
-        result = (uint32_t)(b0 | (b1 << 8) | (b2 << 16) | (b3 << 24));
-    }
 
-    return result;
+template<typename T>
+static inline void store_le(uint8_t *dst, T value) {
+#ifdef BUFFER_BIG_ENDIAN
+    const uint8_t *src = (const uint8_t *)&value;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        dst[i] = src[sizeof(T) - 1 - i];
+    }
+#else
+    memcpy(dst, &value, sizeof(T));
+#endif
 }
 
-uint64_t buffer::read_u64() {
-    uint64_t result = 0;
-    if (is_valid(sizeof(result))) {
-        result = (uint64_t&)data.at(index);
-        index += sizeof(uint64_t);
+#ifdef BUFFER_BIG_ENDIAN
+static void swap_items(uint8_t *items, size_t count, size_t item_size) {
+    for (size_t i = 0; i < count; ++i, items += item_size) {
+        std::reverse(items, items + item_size);
     }
-
-    return result;
 }
+#endif
 
-int8_t buffer::read_i8() {
-    int8_t result = 0;
+template<typename T>
+inline T buffer::read_le() {
+    T result = 0;
     if (is_valid(sizeof(result))) {
-        result = data.at(index++);
+        result = load_le<T>(data.data() + index);
+        index += sizeof(T);
     }
 
     return result;
 }
-int16_t buffer::read_i16() {
-    int16_t result = 0;
-    if (is_valid(sizeof(result))) {
-        uint8_t b0 = data.at(index++);
-        uint8_t b1 = data.at(index++);
-        result = (uint16_t)(b0 | (b1 << 8));
-    }
 
-    return result;
-}
-int32_t buffer::read_i32() {
-    int32_t result = 0;
-    if (is_valid(sizeof(result))) {
-        uint8_t b0 = data.at(index++);
-        uint8_t b1 = data.at(index++);
-        uint8_t b2 = data.at(index++);
-        uint8_t b3 = data.at(index++);
-        result = (int32_t)(b0 | (b1 << 8) | (b2 << 16) | (b3 << 24));
+template<typename T>
+inline void buffer::write_le(T value) {
+    if (is_valid(sizeof(value))) {
+        store_le<T>(data.data() + index, value);
+        index += sizeof(T);
     }
-
-    return result;
 }
 
+uint8_t buffer::read_u8() { return read_le<uint8_t>(); }
+uint16_t buffer::read_u16() { return read_le<uint16_t>(); }
+uint32_t buffer::read_u32() { return read_le<uint32_t>(); }
+uint64_t buffer::read_u64() { return read_le<uint64_t>(); }
+int8_t buffer::read_i8() { return read_le<int8_t>(); }
+int16_t buffer::read_i16() { return read_le<int16_t>(); }
+int32_t buffer::read_i32() { return read_le<int32_t>(); }
+
 int64_t buffer::read_i64() {
     int64_t result = 0;
     if (is_valid(sizeof(result))) {
@@ -158,63 +152,31 @@ size_t buffer::read_raw(void* value, size_t s) {
     return result;
 }
 
-void buffer::fill(uint8_t val) {
-    std::fill(data.begin(), data.end(), val);
-}
-void buffer::write_u8(uint8_t value) {
-    if (is_valid(sizeof(value))) {
-        data.at(index++) = value;
-    }
-}
-void buffer::write_u16(uint16_t value) {
-    if (is_valid(sizeof(value))) {
-        data.at(index++) = value & 0xff;
-        data.at(index++) = (value >> 8) & 0xff;
-    }
-}
-
-void buffer::write_u32(uint32_t value) {
-    if (is_valid(sizeof(value))) {
-        data.at(index++) = value & 0xff;
-        data.at(index++) = (value >> 8) & 0xff;
-        data.at(index++) = (value >> 16) & 0xff;
-        data.at(index++) = (value >> 24) & 0xff;
-    }
+size_t buffer::read_array(void *values, size_t count, size_t item_size) {
+    // items past the end read as zero, like the single value reads
+    const size_t available = index < size() ? (size() - index) / item_size : 0;
+    const size_t read_count = std::min(count, available);
+    memcpy(values, data.data() + index, read_count * item_size);
+    memset((uint8_t *)values + read_count * item_size, 0, (count - read_count) * item_size);
+#ifdef BUFFER_BIG_ENDIAN
+    swap_items((uint8_t *)values, read_count, item_size);
+#endif
+    index += read_count * item_size;
+    return read_count;
 }
 
-void buffer::write_u64(uint64_t value) {
-    if (is_valid(sizeof(value))) {
-        (uint64_t &)data.at(index) = value;
-        index += sizeof(uint64_t);
-    }
-}
-
-void buffer::write_i8(int8_t value) {
-    if (is_valid(sizeof(value))) {
-        data.at(index++) = value & 0xff;
-    }
-}
-void buffer::write_i16(int16_t value) {
-    if (is_valid(sizeof(value))) {
-        data.at(index++) = value & 0xff;
-        data.at(index++) = (value >> 8) & 0xff;
-    }
-}
-void buffer::write_i32(int32_t value) {
-    if (is_valid(sizeof(value))) {
-        data.at(index++) = value & 0xff;
-        data.at(index++) = (value >> 8) & 0xff;
-        data.at(index++) = (value >> 16) & 0xff;
-        data.at(index++) = (value >> 24) & 0xff;
-    }
+void buffer::fill(uint8_t val) {
+    std::fill(data.begin(), data.end(), val);
 }
 
-void buffer::write_i64(int64_t value) {
-    if (is_valid(sizeof(value))) {
-        (int64_t &)data.at(index) = value;
-        index += sizeof(int64_t);
-    }
-}
+void buffer::write_u8(uint8_t value) { write_le(value); }
+void buffer::write_u16(uint16_t value) { write_le(value); }
+void buffer::write_u32(uint32_t value) { write_le(value); }
+void buffer::write_u64(uint64_t value) { write_le(value); }
+void buffer::write_i8(int8_t value) { write_le(value); }
+void buffer::write_i16(int16_t value) { write_le(value); }
+void buffer::write_i32(int32_t value) { write_le(value); }
+void buffer::write_i64(int64_t value) { write_le(value); }
 
 void buffer::write_raw(const void* value, size_t s) {
     if (is_valid(s)) {
@@ -223,6 +185,19 @@ void buffer::write_raw(const void* value, size_t s) {
     }
 }
 
+size_t buffer::write_array(const void *values, size_t count, size_t item_size) {
+    // items that do not fit are dropped, like the single value writes
+    const size_t available = index < size() ? (size() - index) / item_size : 0;
+    const size_t write_count = std::min(count, available);
+    uint8_t *dst = data.data() + index;
+    memcpy(dst, values, write_count * item_size);
+#ifdef BUFFER_BIG_ENDIAN
+    swap_items(dst, write_count, item_size);
+#endif
+    index += write_count * item_size;
+    return write_count;
+}
+
 void buffer::skip(size_t s) {
     if (!is_valid(s)) {
         index = size();
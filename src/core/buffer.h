@@ -17,6 +17,9 @@ private:
     std::vector<uint8_t> data;
     size_t index = 0;
 
+    template<typename T> T read_le();
+    template<typename T> void write_le(T value);
+
 public:
     buffer();
     explicit buffer(size_t s);
@@ -46,6 +49,8 @@ public:
     int32_t read_i32();
     int64_t read_i64();
     size_t read_raw(void* value, size_t max_size);
+    // reads count little endian items of item_size bytes, returns the number of items read
+    size_t read_array(void *values, size_t count, size_t item_size);
 
     void write_u8(uint8_t value);
     void write_u16(uint16_t value);
@@ -56,6 +61,8 @@ public:
     void write_i32(int32_t value);
     void write_i64(int64_t value);
     void write_raw(const void* value, size_t s);
+    // writes count items of item_size bytes as little endian, returns the number of items written
+    size_t write_array(const void *values, size_t count, size_t item_size);
 
     size_t from_file(size_t count, FILE* fp);
     size_t to_file(size_t count, FILE* fp) const;
@@ -6,7 +6,6 @@
 #include "content/vfs.h"
 #include "core/log.h"
 #include "js/js_game.h"
-#include "mujs/mujs.h"
 
 
 class settings_vars_impl_t {
@@ -168,9 +167,6 @@ public:
 	}
 
 	static inline std::string svardata;
-	static void svarprintf(js_State *state, const char* v) {
-		svardata.append(v);
-    }
 
 	void save_global(pcstr filename, pcstr name) {
 		if (!_variantsDirty) {
@@ -187,13 +183,7 @@ public:
 		svardata = "log_info(\"akhenaten: akhenaten.conf started\")\n";
 		svardata.append("var game_settings = ");
 
-		js_State *state = (js_State *)g_config_arch.state;
-		js_setdumping(state, &svarprintf);
-		js_getglobal(state, name);
-		if (js_isobject(state, -1)) {
-			js_dumpobject_ex(state, -1);
-		}
-		js_pop(state, 1);
+		g_config_arch.w_dump(name, svardata);
 
 		fprintf(fp, "%s", svardata.c_str());
 		svardata.clear();
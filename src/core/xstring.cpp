@@ -3,97 +3,168 @@
 #include "log.h"
 #include "crc32.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <mutex>
-#include <unordered_map>
-
-static std::mutex xstring_container_m;
+#include <stdlib.h>
+#include <string.h>
 
+// Intern table split in shards by crc. Lookups walk the bucket chains without a lock,
+// values are published with a release store after they are fully written and are never
+// unlinked, so a reader sees either the old chain head or a complete new value.
+// Only inserts take the shard lock, and re-check the chain under it.
 struct xstring_container {
-    std::unordered_map<uint32_t, xstring_value *> data;
+    enum {
+        NUM_SHARDS = 16,
+        NUM_BUCKETS = 1024, // per shard
+        ARENA_BLOCK_SIZE = 64 * 1024,
+    };
+
+    struct shard_t {
+        std::mutex lock;
+        std::atomic<xstring_value *> buckets[NUM_BUCKETS] = {};
+        char *arena = nullptr;
+        size_t arena_left = 0;
+    };
+
+    shard_t shards[NUM_SHARDS];
+
+    std::atomic<uint64_t> lookups{0};
+    std::atomic<uint64_t> inserts{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> collisions{0};
+    std::atomic<uint64_t> arena_bytes{0};
+    std::atomic<uint32_t> arena_blocks{0};
+
+    static xstring_container &instance();
+
+    const xstring_value *dock(pcstr value);
+    xstring_value *find(std::atomic<xstring_value *> &bucket, uint32_t crc, pcstr value, uint16_t length);
+    xstring_value *alloc(shard_t &shard, size_t size);
     void verify();
-    void dump(FILE *f) const;
-    static xstring_value *dock(pcstr value);
-    void dump();
-    void clean();
-
-    ~xstring_container() {
-        clean();
-    }
+    void dump(FILE *f);
 };
 
-xstring_container *g_xstring = nullptr;
+xstring_container &xstring_container::instance() {
+    // xstrings are created during static initialization and read until exit, never destroyed
+    static xstring_container *container = new xstring_container();
+    return *container;
+}
 
-void xstring_container::verify() {
-    std::scoped_lock _(xstring_container_m);
-    logs::info("strings verify started");
-    for (const auto &it: data) {
-        const auto crc = crc32(it.second->value.c_str(), it.second->length);
-        bstring32 crc_str;
-        assert(crc == it.second->crc);// , "error: read-only memory corruption (shared_strings)"); // itoa(value->dwCRC, crc_str, 16));
-        assert(it.second->length == it.second->value.length());// , "error: read-only memory corruption (shared_strings, internal structures)");// , value->value);
+xstring_value *xstring_container::find(std::atomic<xstring_value *> &bucket, uint32_t crc, pcstr value, uint16_t length) {
+    for (xstring_value *it = bucket.load(std::memory_order_acquire); it; it = it->next) {
+        if (it->crc != crc) {
+            continue;
+        }
+
+        if (it->length == length && memcmp(it->value, value, length) == 0) {
+            return it;
+        }
+
+        collisions.fetch_add(1, std::memory_order_relaxed);
     }
-    logs::info("strings verify completed");
+    return nullptr;
 }
 
-void xstring_container::dump(FILE *f) const {
-    for (const auto &it: data) {
-        fprintf(f, "ref[%4u]-len[%3u]-crc[%8X] : %s\n", it.second->reference, it.second->length, it.second->crc, it.second->value.c_str());
+xstring_value *xstring_container::alloc(shard_t &shard, size_t size) {
+    size = (size + alignof(xstring_value) - 1) & ~(alignof(xstring_value) - 1);
+    if (size > shard.arena_left) {
+        const size_t block_size = std::max<size_t>(size, ARENA_BLOCK_SIZE);
+        shard.arena = (char *)malloc(block_size);
+        shard.arena_left = block_size;
+        arena_blocks.fetch_add(1, std::memory_order_relaxed);
     }
+
+    xstring_value *v = (xstring_value *)shard.arena;
+    shard.arena += size;
+    shard.arena_left -= size;
+    arena_bytes.fetch_add(size, std::memory_order_relaxed);
+    return v;
 }
 
-xstring_value *xstring_container::dock(pcstr value) {
+const xstring_value *xstring_container::dock(pcstr value) {
     if (nullptr == value) {
         return nullptr;
     }
 
-    std::scoped_lock _(xstring_container_m);
-
-    if (!g_xstring) {
-        g_xstring = new xstring_container();
-        g_xstring->data.reserve(4096);
-    }
+    lookups.fetch_add(1, std::memory_order_relaxed);
 
     // calc len
     const size_t s_len = strlen(value);
-    const size_t s_len_with_zero = s_len + 1;
-    assert(sizeof(xstring_value) + s_len_with_zero < 4096);
+    assert(sizeof(xstring_value) + s_len + 1 < 4096);
 
     // setup find structure
-    uint16_t length = static_cast<uint32_t>(s_len);
-    uint32_t crc = crc32(value, uint32_t(s_len));
-
-    // search
-    auto it = g_xstring->data.find(crc);
-
-    // it may be the case, string is not found or has "non-exact" match
-    if (it == g_xstring->data.end()) {
-        xstring_value *new_xstr = new xstring_value;
-        new_xstr->reference = 0;
-        new_xstr->length = length;
-        new_xstr->crc = crc;
-        new_xstr->value = value;
-
-        g_xstring->data.insert({crc, new_xstr});
-        return new_xstr;
+    const uint16_t length = static_cast<uint16_t>(s_len);
+    const uint32_t crc = crc32(value, uint32_t(s_len));
+
+    shard_t &shard = shards[crc % NUM_SHARDS];
+    std::atomic<xstring_value *> &bucket = shard.buckets[(crc / NUM_SHARDS) % NUM_BUCKETS];
+
+    if (xstring_value *found = find(bucket, crc, value, length)) {
+        return found;
+    }
+
+    std::unique_lock<std::mutex> guard(shard.lock, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        contended.fetch_add(1, std::memory_order_relaxed);
+        guard.lock();
     }
 
-    return it->second;
+    // another thread may have added it meanwhile
+    if (xstring_value *found = find(bucket, crc, value, length)) {
+        return found;
+    }
+
+    xstring_value *new_xstr = alloc(shard, offsetof(xstring_value, value) + s_len + 1);
+    new_xstr->crc = crc;
+    new_xstr->length = length;
+    new_xstr->next = bucket.load(std::memory_order_relaxed);
+    memcpy(new_xstr->value, value, s_len + 1);
+    bucket.store(new_xstr, std::memory_order_release);
+
+    inserts.fetch_add(1, std::memory_order_relaxed);
+    return new_xstr;
 }
 
-void xstring_container::dump() {
-    std::scoped_lock _(xstring_container_m);
-    FILE* F = fopen("c:\\$str_dump$.txt", "w");
-    dump(F);
-    fclose(F);
+void xstring_container::verify() {
+    logs::info("strings verify started");
+    for (auto &shard : shards) {
+        std::scoped_lock _(shard.lock);
+        for (auto &bucket : shard.buckets) {
+            for (xstring_value *it = bucket.load(std::memory_order_acquire); it; it = it->next) {
+                const auto crc = crc32(it->value, it->length);
+                assert(crc == it->crc); // "error: read-only memory corruption (shared_strings)"
+                assert(it->length == strlen(it->value)); // "error: read-only memory corruption (shared_strings, internal structures)"
+            }
+        }
+    }
+    logs::info("strings verify completed");
 }
 
-void xstring_container::clean() {
-    for (const auto &it : data) {
-        delete it.second;
+void xstring_container::dump(FILE *f) {
+    for (auto &shard : shards) {
+        std::scoped_lock _(shard.lock);
+        for (auto &bucket : shard.buckets) {
+            for (xstring_value *it = bucket.load(std::memory_order_acquire); it; it = it->next) {
+                fprintf(f, "len[%3u]-crc[%8X] : %s\n", it->length, it->crc, it->value);
+            }
+        }
     }
-    data.clear();
 }
 
-xstring_value *xstring::_dock(pcstr value) {
-    return xstring_container::dock(value);
-}
\ No newline at end of file
+xstring_stats_t xstring_stats() {
+    auto &container = xstring_container::instance();
+    xstring_stats_t stats;
+    stats.lookups = container.lookups.load(std::memory_order_relaxed);
+    stats.inserts = container.inserts.load(std::memory_order_relaxed);
+    stats.contended = container.contended.load(std::memory_order_relaxed);
+    stats.collisions = container.collisions.load(std::memory_order_relaxed);
+    stats.arena_bytes = container.arena_bytes.load(std::memory_order_relaxed);
+    stats.arena_blocks = container.arena_blocks.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const xstring_value *xstring::_dock(pcstr value) {
+    return xstring_container::instance().dock(value);
+}
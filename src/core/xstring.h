@@ -8,46 +8,33 @@
 #include <type_traits>
 #include <functional>
 
+// Interned string, lives until exit: the intern table never frees, so an xstring
+// is a plain pointer and copies need no reference counting.
 struct xstring_value {
     uint32_t crc;
-    uint16_t reference;
     uint16_t length;
-    std::string value;
+    xstring_value *next; // chain in the intern table bucket
+    char value[1];       // zero-terminated, allocated past the end of the struct
 };
 
-class xstring {
-    xstring_value* _p;
+struct xstring_stats_t {
+    uint64_t lookups;    // dock() calls
+    uint64_t inserts;    // new strings interned
+    uint64_t contended;  // inserts which had to wait for the shard lock
+    uint64_t collisions; // crc matches with a different string
+    uint64_t arena_bytes;
+    uint32_t arena_blocks;
+};
 
-protected:
-    // ref-counting
-    void _dec() {
-        if (0 == _p)
-            return;
+xstring_stats_t xstring_stats();
 
-        _p->reference--;
-        if (0 == _p->reference)
-            _p = 0;
-    }
+class xstring {
+    const xstring_value* _p;
 
 public:
-    xstring_value *_dock(pcstr value);
-    void _set(pcstr rhs) {
-        xstring_value* v = _dock(rhs);
-        if (0 != v) {
-            v->reference++;
-        }
-        _dec();
-        _p = v;
-    }
-
-    void _set(xstring const& rhs) {
-        xstring_value* v = rhs._p;
-        if (0 != v) {
-            v->reference++;
-        }
-        _dec();
-        _p = v;
-    }
+    static const xstring_value *_dock(pcstr value);
+    void _set(pcstr rhs) { _p = _dock(rhs); }
+    void _set(xstring const& rhs) { _p = rhs._p; }
 
     [[nodiscard]]
     const xstring_value* _get() const { return _p; }
@@ -59,14 +46,13 @@ public:
     // construction
     xstring() { _p = nullptr; }
     xstring(pcstr rhs) { _p = nullptr; _set(rhs); }
-    xstring(xstring const& rhs) { _p = 0; _set(rhs); }
-    ~xstring() { _dec(); }
+    xstring(xstring const& rhs) { _p = rhs._p; }
 
     xstring& operator=(pcstr rhs) { _set(rhs); return (xstring&)*this; }
     xstring& operator=(xstring const& rhs) { _set(rhs); return (xstring&)*this; }
 
     [[nodiscard]]
-    pcstr operator*() const { return _p ? _p->value.data() : nullptr; }
+    pcstr operator*() const { return _p ? _p->value : nullptr; }
 
     [[nodiscard]]
     bool operator!() const { return empty(); }
@@ -78,7 +64,7 @@ public:
     char operator[](size_t id) const { return _p->value[id]; }
 
     [[nodiscard]]
-    pcstr c_str() const { return _p ? _p->value.c_str() : nullptr; }
+    pcstr c_str() const { return _p ? _p->value : nullptr; }
 
     [[nodiscard]]
     size_t size() const { return _p ? _p->length : 0; }
@@ -86,7 +72,7 @@ public:
     [[nodiscard]]
     bool empty() const { return size() == 0; }
 
-    void swap(xstring& rhs) noexcept { xstring_value* tmp = _p; _p = rhs._p; rhs._p = tmp; }
+    void swap(xstring& rhs) noexcept { const xstring_value* tmp = _p; _p = rhs._p; rhs._p = tmp; }
 
     [[nodiscard]]
     bool equal(const xstring& rhs) const { return (_p == rhs._p); }
@@ -3,6 +3,10 @@
 #include <cmath>
 
 #include "core/string.h"
+#include "core/log.h"
+#include "core/xstring.h"
+#include "content/imagepak.h"
+#include "io/manager.h"
 #include "graphics/text.h"
 
 #include "graphics/graphics.h"
@@ -59,6 +63,41 @@ declare_console_command_p(debugrender) {
     g_debug_render  = atoi(args.empty() ? (pcstr)"0" : args.c_str());
 };
 
+declare_console_command_p(xstrings) {
+    const xstring_stats_t stats = xstring_stats();
+    bstring256 text;
+    text.printf("xstrings: %llu lookups, %llu interned, %llu contended, %llu crc collisions, %llu bytes in %u blocks",
+                (unsigned long long)stats.lookups, (unsigned long long)stats.inserts, (unsigned long long)stats.contended,
+                (unsigned long long)stats.collisions, (unsigned long long)stats.arena_bytes, stats.arena_blocks);
+    os << text.c_str() << std::endl;
+    logs::info(text.c_str());
+};
+
+declare_console_command_p(savecodecs) {
+    // uses the chunk buffers of the last save read or written, load the save to measure first
+    for (const auto &b : FILEIO.benchmark_codecs()) {
+        bstring256 text;
+        text.printf("%s: %lld -> %lld bytes (%.1f%%), compress %.1f ms, decompress %.1f ms",
+                    b.name, (long long)b.raw_size, (long long)b.packed_size,
+                    b.raw_size ? 100.f * b.packed_size / b.raw_size : 0.f, b.compress_ms, b.decompress_ms);
+        os << text.c_str() << std::endl;
+        logs::info(text.c_str());
+    }
+};
+
+declare_console_command_p(imagepaks) {
+    float total = 0.f;
+    for (const auto &t : imagepak_timings()) {
+        bstring256 text;
+        text.printf("%s: %d images, index %.1f ms, read %.1f ms, decode %.1f ms (%u threads), upload %.1f ms",
+                    t.name.c_str(), t.images, t.index_ms, t.read_ms, t.decode_ms, t.threads, t.upload_ms);
+        os << text.c_str() << std::endl;
+        logs::info(text.c_str());
+        total += t.index_ms + t.read_ms + t.decode_ms + t.upload_ms;
+    }
+    os << "total " << total << " ms" << std::endl;
+};
+
 
 static const uint8_t* font_test_str = (uint8_t*)(char*)"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890!\"%*()-+=:;'?\\/,._äáàâëéèêïíìîöóòôüúùûçñæßÄÉÜÑÆŒœÁÂÀÊÈÍÎÌÓÔÒÖÚÛÙ¡¿^°ÅØåø";
 static const uint8_t* font_test_str_ascii = (uint8_t*)(char*)"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890!\"%*()-+=:;'?\\/,._";
@@ -9,6 +9,7 @@
 #include "game/difficulty.h"
 #include "grid/figure.h"
 #include "grid/point.h"
+#include "grid/routing/routing.h"
 #include "sound/sound.h"
 #include "game/game_events.h"
 
@@ -201,6 +202,7 @@ void figure::figure_combat_handle_corpse() {
 }
 
 void figure::resume_activity_after_attack() {
+    map_routing_version_bump(); // the fight no longer blocks routes
     num_attackers = 0;
     action_state = action_state_before_attack;
     opponent_id = 0;
@@ -350,6 +352,7 @@ void figure::figure_combat_attack_figure_at(int grid_offset) {
             attack = 0;
 
         if (attack) {
+            map_routing_version_bump(); // fighting figures block routes
             action_state_before_attack = action_state;
             action_state = FIGURE_ACTION_150_ATTACK;
             opponent_id = opponent_id;
@@ -9,47 +9,180 @@
 #include "grid/grid.h"
 #include "grid/figure.h"
 #include "grid/random.h"
-#include "grid/routing/routing.h"
+#include "core/profiler.h"
+#include "game/game.h"
 
+#include <algorithm>
+#include <array>
 #include <assert.h>
+#include <vector>
 
 #define MAX_ROUTES 3000
 
+// Paths are packed two directions per byte into blocks of a few size classes carved from one pool.
+// Route ids and released blocks are kept in free lists, so adding and removing a route is O(1)
+// and the routes in use are listed densely for cleanup and saving.
 struct figure_route_data_t {
-    int figure_ids[MAX_ROUTES];
-    uint8_t direction_paths[MAX_ROUTES][MAX_PATH_LENGTH];
+    enum {
+        NUM_SIZE_CLASSES = 6,
+        MIN_BLOCK_SIZE = 8, // bytes, blocks go from 8 to 256 bytes (16 to 512 directions)
+    };
+
+    struct route_t {
+        uint16_t figure_id = 0;
+        uint16_t length = 0;
+        uint16_t active_index = 0;
+        uint8_t size_class = 0;
+        uint32_t block = 0;
+    };
+
+    std::vector<route_t> routes;
+    std::vector<uint16_t> free_ids;
+    std::vector<uint16_t> active;
+    std::vector<uint8_t> pool;
+    std::array<std::vector<uint32_t>, NUM_SIZE_CLASSES> free_blocks;
+
+    void reset();
+    void rebuild_free_ids();
+    void place(int path_id, int figure_id, const uint8_t *path, int length);
+    void add(int path_id, int figure_id, const uint8_t *path, int length);
+    void remove(int path_id);
+    int direction(int path_id, int index) const;
+    void unpack(int path_id, uint8_t *path) const;
 };
 
 figure_route_data_t g_figure_route_data;
 
-void figure_route_clear_all(void) {
-    auto &data = g_figure_route_data;
-    for (int i = 0; i < MAX_ROUTES; i++) {
-        data.figure_ids[i] = 0;
-        for (int j = 0; j < MAX_PATH_LENGTH; j++) {
-            data.direction_paths[i][j] = 0;
+static int route_block_size(int size_class) {
+    return figure_route_data_t::MIN_BLOCK_SIZE << size_class;
+}
+
+void figure_route_data_t::reset() {
+    routes.assign(MAX_ROUTES, route_t{});
+    active.clear();
+    pool.clear();
+    for (auto &blocks : free_blocks) {
+        blocks.clear();
+    }
+    rebuild_free_ids();
+}
+
+void figure_route_data_t::rebuild_free_ids() {
+    free_ids.clear();
+    for (int i = MAX_ROUTES - 1; i > 0; i--) {
+        if (!routes[i].figure_id) {
+            free_ids.push_back(i);
         }
     }
 }
 
+void figure_route_data_t::add(int path_id, int figure_id, const uint8_t *path, int length) {
+    assert(!free_ids.empty() && free_ids.back() == path_id);
+    free_ids.pop_back();
+    place(path_id, figure_id, path, length);
+}
+
+// stores the path without touching the id free list, loads rebuild it afterwards
+void figure_route_data_t::place(int path_id, int figure_id, const uint8_t *path, int length) {
+    const int packed_size = (length + 1) / 2;
+    int size_class = 0;
+    while (size_class < NUM_SIZE_CLASSES - 1 && route_block_size(size_class) < packed_size) {
+        size_class++;
+    }
+
+    uint32_t block;
+    auto &blocks = free_blocks[size_class];
+    if (!blocks.empty()) {
+        block = blocks.back();
+        blocks.pop_back();
+    } else {
+        block = (uint32_t)pool.size();
+        pool.resize(pool.size() + route_block_size(size_class));
+    }
+
+    uint8_t *packed = &pool[block];
+    for (int i = 0; i < packed_size; i++) {
+        const uint8_t low = path[2 * i] & 0xf;
+        const uint8_t high = (2 * i + 1 < length) ? (path[2 * i + 1] & 0xf) : 0;
+        packed[i] = low | (high << 4);
+    }
+
+    route_t &route = routes[path_id];
+    route.figure_id = figure_id;
+    route.length = length;
+    route.size_class = size_class;
+    route.block = block;
+    route.active_index = (uint16_t)active.size();
+    active.push_back(path_id);
+}
+
+void figure_route_data_t::remove(int path_id) {
+    route_t &route = routes[path_id];
+    if (!route.figure_id) {
+        return;
+    }
+
+    free_blocks[route.size_class].push_back(route.block);
+
+    const uint16_t last = active.back();
+    active[route.active_index] = last;
+    routes[last].active_index = route.active_index;
+    active.pop_back();
+
+    route = route_t{};
+    free_ids.push_back(path_id);
+}
+
+int figure_route_data_t::direction(int path_id, int index) const {
+    const route_t &route = routes[path_id];
+    if (!route.figure_id || index < 0 || index >= route.length) {
+        return 0;
+    }
+
+    const uint8_t packed = pool[route.block + index / 2];
+    return (index & 1) ? (packed >> 4) : (packed & 0xf);
+}
+
+void figure_route_data_t::unpack(int path_id, uint8_t *path) const {
+    const route_t &route = routes[path_id];
+    for (int i = 0; i < route.length; i++) {
+        path[i] = direction(path_id, i);
+    }
+}
+
+void figure_route_clear_all(void) {
+    map_routing_version_bump();
+    g_figure_route_data.reset();
+}
+
 void figure_route_clean(void) {
     auto &data = g_figure_route_data;
-    for (int i = 0; i < MAX_ROUTES; i++) {
-        int figure_id = data.figure_ids[i];
-        if (figure_id > 0 && figure_id < MAX_FIGURES) {
-            const figure* f = figure_get(figure_id);
-            if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != i)
-                data.figure_ids[i] = 0;
+    if (data.routes.empty()) {
+        data.reset();
+    }
+
+    for (int i = (int)data.active.size() - 1; i >= 0; i--) {
+        const int path_id = data.active[i];
+        const int figure_id = data.routes[path_id].figure_id;
+        if (figure_id >= MAX_FIGURES) {
+            data.remove(path_id);
+            continue;
+        }
+
+        const figure* f = figure_get(figure_id);
+        if (f->state != FIGURE_STATE_ALIVE || f->routing_path_id != path_id) {
+            data.remove(path_id);
         }
     }
 }
+
 int map_routing_get_first_available_id() {
     auto &data = g_figure_route_data;
-    for (int i = 1; i < MAX_ROUTES; i++) {
-        if (data.figure_ids[i] == 0)
-            return i;
+    if (data.routes.empty()) {
+        data.reset();
     }
-    return 0;
+
+    return data.free_ids.empty() ? 0 : data.free_ids.back();
 }
 
 void figure::map_figure_add() {
@@ -122,6 +255,182 @@ void figure::map_figure_remove() {
     next_figure = 0;
 }
 
+// land routes only read the routing grids, terrain, buildings and fighting figures,
+// so they can also run on worker threads with their own distance buffers
+static int figure_route_calculate_land(uint8_t *path, tile2i src, tile2i dst, int terrain_usage, int destination_id, bool in_formation) {
+    // enemies, and soldiers or herds moving together, share fields towards their destinations
+    const bool shared_field = (terrain_usage == TERRAIN_USAGE_ENEMY)
+                                || (in_formation && (terrain_usage == TERRAIN_USAGE_ANY || terrain_usage == TERRAIN_USAGE_ANIMAL));
+    if (shared_field) {
+        return map_routing_flow_field_get_path(path, src, dst, terrain_usage, destination_id);
+    }
+
+    int can_travel;
+    switch (terrain_usage) {
+
+    case TERRAIN_USAGE_WALLS:
+        can_travel = map_routing_can_travel_over_walls(src.x(), src.y(), dst.x(), dst.y());
+        break;
+
+    case TERRAIN_USAGE_ANIMAL:
+        can_travel = map_routing_noncitizen_can_travel_over_land(src, dst, -1, 5000);
+        break;
+
+    case TERRAIN_USAGE_PREFER_ROADS:
+        can_travel = map_routing_citizen_can_travel_over_road(src, dst);
+        if (!can_travel) {
+            can_travel = map_routing_citizen_can_travel_over_land(src, dst);
+        }
+        break;
+
+    case TERRAIN_USAGE_ROADS:
+        can_travel = map_routing_citizen_can_travel_over_road(src, dst);
+        break;
+
+    default:
+        can_travel = map_routing_citizen_can_travel_over_land(src, dst);
+        break;
+    }
+
+    if (!can_travel) {
+        return 0;
+    }
+
+    if (terrain_usage == TERRAIN_USAGE_WALLS) {
+        int path_length = map_routing_get_path(path, src, dst, 4);
+        if (path_length <= 0) {
+            path_length = map_routing_get_path(path, src, dst, 8);
+        }
+        return path_length;
+    }
+
+    if (terrain_usage == TERRAIN_USAGE_ROADS) {
+        return map_routing_get_path(path, src, dst, 4);
+    }
+
+    return map_routing_get_path(path, src, dst, 8);
+
+}
+
+// Land routes which figures are expected to ask for during this tick, searched ahead on the
+// worker threads. A result is only used when the request and the routing version still match,
+// otherwise the figure routes as before, so the simulation does not depend on the prefetch.
+struct figure_route_prefetch_t {
+    struct slot_t {
+        int src_offset = -1;
+        int dst_offset = -1;
+        int terrain_usage = -1;
+        int destination_id = 0;
+        bool in_formation = false;
+        uint32_t version = 0;
+        int path_length = 0;
+        int total_routes = 0;
+        int enemy_routes = 0;
+        uint8_t path[MAX_PATH_LENGTH];
+
+        bool matches(const figure &f, uint32_t v) const {
+            return src_offset == f.tile.grid_offset() && dst_offset == f.destination_tile.grid_offset() && terrain_usage == f.terrain_usage
+                    && destination_id == f.destinationID() && in_formation == (f.formation_id > 0) && version == v;
+        }
+    };
+
+    std::vector<slot_t> slots;
+    std::vector<int> requests;
+};
+
+figure_route_prefetch_t g_figure_route_prefetch;
+
+static bool figure_route_take_prefetched(const figure &f, uint8_t *path, int &path_length) {
+    auto &prefetch = g_figure_route_prefetch;
+    if (f.id <= 0 || f.id >= (int)prefetch.slots.size()) {
+        return false;
+    }
+
+    const auto &slot = prefetch.slots[f.id];
+    if (!slot.matches(f, map_routing_version())) {
+        return false;
+    }
+
+    std::copy(slot.path, slot.path + slot.path_length, path);
+    path_length = slot.path_length;
+    map_routing_add_stats(slot.total_routes, slot.enemy_routes);
+    return true;
+}
+
+void figure_route_prefetch() {
+    OZZY_PROFILER_SECTION("Game/Run/Tick/Figure Action/Route Prefetch");
+    auto &prefetch = g_figure_route_prefetch;
+    if (game.mt.get_thread_count() <= 0) {
+        return;
+    }
+
+    if (prefetch.slots.empty()) {
+        prefetch.slots.resize(MAX_FIGURES);
+    }
+
+    // fighting figures change passability while the others move, keep those ticks serial
+    const uint32_t version = map_routing_version();
+    prefetch.requests.clear();
+    for (figure *f : map_figures()) {
+        if (f->state != FIGURE_STATE_ALIVE) {
+            continue;
+        }
+
+        if (f->action_state == FIGURE_ACTION_150_ATTACK) {
+            return;
+        }
+
+        if (f->routing_path_id > 0 || !f->destination_tile.valid()) {
+            continue;
+        }
+
+        // boats pick their path with the random generator, leave them to the serial order
+        if (f->is_boat() || f->can_move_by_water()) {
+            continue;
+        }
+
+        // only figures close enough to a tile center to route during this tick
+        if (f->progress_on_tile + std::max<int>(f->speed_multiplier, 1) < 15) {
+            continue;
+        }
+
+        const auto &slot = prefetch.slots[f->id];
+        if (slot.matches(*f, version)) {
+            continue;
+        }
+
+        prefetch.requests.push_back(f->id);
+    }
+
+    if (prefetch.requests.empty()) {
+        return;
+    }
+
+    auto resolve = [&prefetch, version] (int begin, int end) {
+        routing_use_local_buffers(true);
+        auto &queue = routing_queue();
+        for (int i = begin; i < end; ++i) {
+            const figure *f = figure_get(prefetch.requests[i]);
+            auto &slot = prefetch.slots[f->id];
+            queue.total_routes = 0;
+            queue.enemy_routes = 0;
+
+            slot.src_offset = f->tile.grid_offset();
+            slot.dst_offset = f->destination_tile.grid_offset();
+            slot.terrain_usage = f->terrain_usage;
+            slot.destination_id = f->destinationID();
+            slot.in_formation = (f->formation_id > 0);
+            slot.version = version;
+            slot.path_length = figure_route_calculate_land(slot.path, f->tile, f->destination_tile, f->terrain_usage, f->destinationID(), slot.in_formation);
+            slot.total_routes = queue.total_routes;
+            slot.enemy_routes = queue.enemy_routes;
+        }
+        routing_use_local_buffers(false);
+    };
+
+    game.mt.submit_blocks(0, (int)prefetch.requests.size(), resolve).wait();
+}
+
 void figure::figure_route_add() {
     auto &data = g_figure_route_data;
     routing_path_id = 0;
@@ -132,70 +441,22 @@ void figure::figure_route_add() {
         return;
     }
 
+    uint8_t path[MAX_PATH_LENGTH];
     int path_length;
     if (can_move_by_water() && is_boat()) {
         if (allow_move_type == EMOVE_DEEPWATER) { // flotsam
             map_routing_calculate_distances_deepwater(tile);
-            path_length = map_routing_get_path_on_water(data.direction_paths[path_id], destination_tile, true);
+            path_length = map_routing_get_path_on_water(path, destination_tile, true);
         } else {
             map_routing_calculate_distances_water_boat(tile);
-            path_length = map_routing_get_path_on_water(data.direction_paths[path_id], destination_tile, false);
-        }
-    } else {
-        // land figure
-        int can_travel;
-        switch (terrain_usage) {
-        case TERRAIN_USAGE_ENEMY:
-            can_travel = map_routing_noncitizen_can_travel_over_land(tile, destination_tile, destinationID(), 5000);
-            if (!can_travel) {
-                can_travel = map_routing_noncitizen_can_travel_over_land(tile, destination_tile, 0, 25000);
-                if (!can_travel)
-                    can_travel = map_routing_noncitizen_can_travel_through_everything(tile, destination_tile);
-            }
-            break;
-
-        case TERRAIN_USAGE_WALLS:
-            can_travel = map_routing_can_travel_over_walls(tile.x(), tile.y(), destination_tile.x(), destination_tile.y());
-            break;
-
-        case TERRAIN_USAGE_ANIMAL:
-            can_travel = map_routing_noncitizen_can_travel_over_land(tile, destination_tile, -1, 5000);
-            break;
-
-        case TERRAIN_USAGE_PREFER_ROADS:
-            can_travel = map_routing_citizen_can_travel_over_road(tile, destination_tile);
-            if (!can_travel) {
-                can_travel = map_routing_citizen_can_travel_over_land(tile, destination_tile);
-            }
-            break;
-
-        case TERRAIN_USAGE_ROADS:
-            can_travel = map_routing_citizen_can_travel_over_road(tile, destination_tile);
-            break;
-
-        default:
-            can_travel = map_routing_citizen_can_travel_over_land(tile, destination_tile);
-            break;
-        }
-
-        if (can_travel) {
-            if (terrain_usage == TERRAIN_USAGE_WALLS) {
-                path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 4);
-                if (path_length <= 0) {
-                    path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 8);
-                }
-            } else if (terrain_usage == TERRAIN_USAGE_ROADS) {
-                path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 4);
-            } else {
-                path_length = map_routing_get_path(data.direction_paths[path_id], tile, destination_tile, 8);
-            }
-        } else { // cannot travel
-            path_length = 0;
+            path_length = map_routing_get_path_on_water(path, destination_tile, false);
         }
+    } else if (!figure_route_take_prefetched(*this, path, path_length)) {
+        path_length = figure_route_calculate_land(path, tile, destination_tile, terrain_usage, destinationID(), formation_id > 0);
     }
 
-    if (path_length) {
-        data.figure_ids[path_id] = id;
+    if (path_length > 0) {
+        data.add(path_id, id, path, path_length);
         routing_path_id = path_id;
         routing_path_length = path_length;
     }
@@ -204,32 +465,131 @@ void figure::figure_route_add() {
 void figure::route_remove() {
     auto &data = g_figure_route_data;
     if (routing_path_id > 0) {
-        if (data.figure_ids[routing_path_id] == id) {
-            data.figure_ids[routing_path_id] = 0;
+        if (routing_path_id < (int)data.routes.size() && data.routes[routing_path_id].figure_id == id) {
+            data.remove(routing_path_id);
         }
         routing_path_id = 0;
     }
 }
 int figure_route_get_direction(int path_id, int index) {
     auto &data = g_figure_route_data;
-    return data.direction_paths[path_id][index];
+    if (path_id <= 0 || path_id >= (int)data.routes.size()) {
+        return 0;
+    }
+
+    return data.direction(path_id, index);
 }
 
+// saves before version 167: MAX_ROUTES (3000) slots of figure ids, then as many fixed MAX_PATH_LENGTH (500) byte paths
+static std::vector<int16_t> g_route_legacy_figure_ids;
+
 io_buffer* iob_route_figures = new io_buffer([](io_buffer* iob, size_t version) {
     auto &data = g_figure_route_data;
+    map_routing_version_bump();
+    if (data.routes.empty()) {
+        data.reset();
+    }
+
+    g_route_legacy_figure_ids.assign(MAX_ROUTES, 0);
+    if (!iob->is_read_access()) {
+        for (int path_id : data.active) {
+            g_route_legacy_figure_ids[path_id] = data.routes[path_id].figure_id;
+        }
+    }
+
     for (int i = 0; i < MAX_ROUTES; i++) {
-        iob->bind(BIND_SIGNATURE_INT16, &data.figure_ids[i]);
+        iob->bind(BIND_SIGNATURE_INT16, &g_route_legacy_figure_ids[i]);
     }
 });
 
 io_buffer* iob_route_paths = new io_buffer([](io_buffer* iob, size_t version) {
     auto &data = g_figure_route_data;
+    const bool reading = iob->is_read_access();
+    if (reading || data.routes.empty()) {
+        data.reset();
+    }
+    if (g_route_legacy_figure_ids.size() < MAX_ROUTES) {
+        g_route_legacy_figure_ids.assign(MAX_ROUTES, 0);
+    }
+
+    uint8_t path[MAX_PATH_LENGTH];
     for (int i = 0; i < MAX_ROUTES; i++) {
-        iob->bind(BIND_SIGNATURE_RAW, &data.direction_paths[i], MAX_PATH_LENGTH);
+        const int figure_id = g_route_legacy_figure_ids[i];
+        std::fill(path, path + MAX_PATH_LENGTH, 0);
+        if (!reading && figure_id > 0) {
+            data.unpack(i, path);
+        }
+
+        iob->bind(BIND_SIGNATURE_RAW, path, MAX_PATH_LENGTH);
+        if (!reading || figure_id <= 0 || figure_id >= MAX_FIGURES || i == 0) {
+            continue;
+        }
+
+        // the old layout has no lengths, the figures are loaded already and know theirs
+        const figure *f = figure_get(figure_id);
+        if (f->routing_path_id != i || f->routing_path_length <= 0) {
+            continue;
+        }
+
+        data.place(i, figure_id, path, std::min<int>(f->routing_path_length, MAX_PATH_LENGTH));
+    }
+
+    if (reading) {
+        data.rebuild_free_ids();
+    }
+    g_route_legacy_figure_ids.clear();
+});
+
+// count, then for every route in use: id, figure id, length and the packed directions
+io_buffer* iob_route_paths_packed = new io_buffer([](io_buffer* iob, size_t version) {
+    auto &data = g_figure_route_data;
+    map_routing_version_bump();
+    if (iob->is_read_access() || data.routes.empty()) {
+        data.reset();
+    }
+
+    uint16_t count = (uint16_t)data.active.size();
+    iob->bind(BIND_SIGNATURE_UINT16, &count);
+
+    uint8_t path[MAX_PATH_LENGTH];
+    for (int i = 0; i < count; i++) {
+        uint16_t path_id = 0;
+        uint16_t figure_id = 0;
+        uint16_t length = 0;
+        if (!iob->is_read_access()) {
+            const auto &route = data.routes[data.active[i]];
+            path_id = data.active[i];
+            figure_id = route.figure_id;
+            length = route.length;
+            data.unpack(path_id, path);
+        }
+
+        iob->bind(BIND_SIGNATURE_UINT16, &path_id);
+        iob->bind(BIND_SIGNATURE_UINT16, &figure_id);
+        iob->bind(BIND_SIGNATURE_UINT16, &length);
+        length = std::min<uint16_t>(length, MAX_PATH_LENGTH);
+        for (int j = 0; j < (length + 1) / 2; j++) {
+            uint8_t packed = path[2 * j] | ((2 * j + 1 < length ? path[2 * j + 1] : 0) << 4);
+            iob->bind(BIND_SIGNATURE_UINT8, &packed);
+            path[2 * j] = packed & 0xf;
+            if (2 * j + 1 < MAX_PATH_LENGTH) {
+                path[2 * j + 1] = packed >> 4;
+            }
+        }
+
+        if (!iob->is_read_access() || path_id == 0 || path_id >= MAX_ROUTES || !figure_id || !length || data.routes[path_id].figure_id) {
+            continue;
+        }
+
+        data.place(path_id, figure_id, path, length);
+    }
+
+    if (iob->is_read_access()) {
+        data.rebuild_free_ids();
     }
 });
 
-int g_direction_path[MAX_PATH_LENGTH];
+static thread_local int g_direction_path[MAX_PATH_LENGTH];
 
 void map_routing_adjust_tile_in_direction(int direction, tile2i &tile, int &grid_offset) {
     switch (direction) {
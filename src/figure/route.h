@@ -7,6 +7,7 @@ constexpr uint32_t MAX_PATH_LENGTH = 500;
 
 void figure_route_clear_all();
 void figure_route_clean();
+void figure_route_prefetch();
 int figure_route_get_direction(int path_id, int index);
 
 void map_routing_adjust_tile_in_direction(int direction, tile2i &tile, int &grid_offset);
@@ -36,8 +36,7 @@ int figure::figure_service_provide_coverage() {
             auto house = ((building *)b)->dcast_house();
 
             if (house) {
-                auto &housed = house->runtime_data();
-                housed.mortuary = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_MORTUARY);
             }
         });
         break;
@@ -51,8 +50,7 @@ int figure::figure_service_provide_coverage() {
             auto house = ((building *)b)->dcast_house();
 
             if (house) {
-                auto &housed = house->runtime_data();
-                housed.bullfighter = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_BULLFIGHTER);
             }
         });
         break;
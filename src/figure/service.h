@@ -3,8 +3,7 @@
 #include "figure/figure.h"
 #include "building/building.h"
 #include "grid/building.h"
-
-constexpr uint8_t MAX_COVERAGE = 96;
+#include "grid/service_coverage.h"
 
 template<typename T>
 inline int figure_provide_service(tile2i tile, figure* f, T callback) {
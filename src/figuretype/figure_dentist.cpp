@@ -35,7 +35,7 @@ int figure_dentist::provide_service() {
         if (!house) {
             return;
         }
-        house->runtime_data().dentist = MAX_COVERAGE;
+        house->provide_service(HOUSE_SERVICE_DENTIST);
     });
     return 0;
 }
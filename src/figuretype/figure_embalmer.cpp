@@ -35,7 +35,7 @@ int figure_embalmer::provide_service() {
         if (!house) {
             return;
         }
-        house->runtime_data().mortuary = MAX_COVERAGE;
+        house->provide_service(HOUSE_SERVICE_MORTUARY);
     });
     return 0;
 }
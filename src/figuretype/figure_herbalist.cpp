@@ -67,8 +67,7 @@ int figure_herbalist::provide_service() {
 
         auto house = b->dcast_house();
         if (house) {
-            auto &housed = house->runtime_data();
-            housed.apothecary = MAX_COVERAGE;
+            house->provide_service(HOUSE_SERVICE_APOTHECARY);
         }
     });
 
@@ -88,7 +88,7 @@ int figure_juggler::provide_service() {
         houses_serviced = figure_provide_culture(tile(), &base, [] (building *b, figure *f) {
             auto house = b->dcast_house();
             if (house) {
-                house->runtime_data().booth_juggler = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_BOOTH_JUGGLER);
             }
         });
 
@@ -96,7 +96,7 @@ int figure_juggler::provide_service() {
         houses_serviced = provide_entertainment(0, [] (building * b, int shows) {
             auto house = b->dcast_house();
             if (house) {
-                house->runtime_data().bandstand_juggler = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_BANDSTAND_JUGGLER);
             }
         });
     }
@@ -12,8 +12,7 @@ int figure_librarian::provide_service() {
         auto house = ((building *)b)->dcast_house();
 
         if (house) {
-            auto &housed = house->runtime_data();
-            housed.library = MAX_COVERAGE;
+            house->provide_service(HOUSE_SERVICE_LIBRARY);
         }
     });
     return houses_serviced;
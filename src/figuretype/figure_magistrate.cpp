@@ -112,7 +112,7 @@ int figure_magistrate::provide_service() {
         }
 
         if (house && house->house_population() > 0) {
-            house->runtime_data().magistrate = MAX_COVERAGE;
+            house->provide_service(HOUSE_SERVICE_MAGISTRATE);
         }
 
         auto &housed = house->runtime_data();
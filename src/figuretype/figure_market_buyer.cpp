@@ -130,6 +130,7 @@ void distribute_good(building* b, building* market, int stock_wanted, int invent
     }
 
     auto &housed = house->runtime_data();
+    housed.evolve_checked = 0;
     int amount_wanted = stock_wanted - housed.inventory[inventory_resource];
 
     auto &d = bazaar->runtime_data();
@@ -157,6 +158,7 @@ void distribute_market_resources(building* b, building* market) {
 
     auto &marketd = bazaar->runtime_data();
     auto &housed = house->runtime_data();
+    housed.evolve_checked = 0;
     int level = house->house_level();
     if (level < HOUSE_PALATIAL_ESTATE) {
         level++;
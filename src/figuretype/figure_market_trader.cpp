@@ -46,7 +46,7 @@ int figure_market_trader::provide_service() {
         }
 
         if (house->house_population() > 0) {
-            house->runtime_data().bazaar_access = MAX_COVERAGE;
+            house->provide_service(HOUSE_SERVICE_BAZAAR_ACCESS);
         }
     });
     return houses_serviced;
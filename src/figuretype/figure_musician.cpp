@@ -81,14 +81,14 @@ int figure_musician::provide_service() {
         houses_serviced = provide_entertainment(0, [] (building *b, int shows) {
             auto house = b->dcast_house();
             if (house) {
-                house->runtime_data().bandstand_musician = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_BANDSTAND_MUSICIAN);
             }
         });
     } else if (b->type == BUILDING_PAVILLION) {
         houses_serviced = provide_entertainment(0, [] (building *b, int shows) {
             auto house = b->dcast_house();
             if (house) {
-                house->runtime_data().pavillion_musician = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_PAVILLION_MUSICIAN);
             }
         });
     }
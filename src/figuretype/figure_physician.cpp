@@ -91,7 +91,7 @@ int figure_physician::provide_service() {
         auto house = b->dcast_house();
 
         if (house && house->house_population() > 0) {
-            house->runtime_data().physician = MAX_COVERAGE;
+            house->provide_service(HOUSE_SERVICE_PHYSICIAN);
             b->common_health = std::min(b->common_health + 1, 100);
         }
     });
@@ -114,7 +114,7 @@ int figure_priest::provide_service() {
         houses_serviced = figure_provide_service(tile(), &base, [] (building *b, figure *f) {
             auto house = b->dcast_house();
             if (house && house->house_population() > 0) {
-                house->runtime_data().temple_osiris = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_TEMPLE_OSIRIS);
             }
         });
         break;
@@ -124,7 +124,7 @@ int figure_priest::provide_service() {
         houses_serviced = figure_provide_service(tile(), &base, [] (building *b, figure *f) {
             auto house = b->dcast_house();
             if (house && house->house_population() > 0) {
-                house->runtime_data().temple_ra = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_TEMPLE_RA);
             }
         });
         break;
@@ -134,7 +134,7 @@ int figure_priest::provide_service() {
         houses_serviced = figure_provide_service(tile(), &base, [] (building *b, figure *f) {
             auto house = b->dcast_house();
             if (house && house->house_population() > 0) {
-                house->runtime_data().temple_ptah = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_TEMPLE_PTAH);
             }
         });
         break;
@@ -144,7 +144,7 @@ int figure_priest::provide_service() {
         houses_serviced = figure_provide_service(tile(), &base, [] (building *b, figure *f) {
             auto house = b->dcast_house();
             if (house && house->house_population() > 0) {
-                house->runtime_data().temple_seth = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_TEMPLE_SETH);
             }
         });
         break;
@@ -154,7 +154,7 @@ int figure_priest::provide_service() {
         houses_serviced = figure_provide_service(tile(), &base, [] (building *b, figure *f) {
             auto house = b->dcast_house();
             if (house && house->house_population() > 0) {
-                house->runtime_data().temple_bast = MAX_COVERAGE;
+                house->provide_service(HOUSE_SERVICE_TEMPLE_BAST);
             }
         });
         break;
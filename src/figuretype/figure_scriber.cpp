@@ -27,8 +27,7 @@ int figure_scriber::provide_service() {
         auto house = ((building *)b)->dcast_house();
 
         if (house) {
-            auto &housed = house->runtime_data();
-            housed.academy = MAX_COVERAGE;
+            house->provide_service(HOUSE_SERVICE_ACADEMY);
         }
     });
     return houses_serviced;
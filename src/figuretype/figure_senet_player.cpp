@@ -83,8 +83,7 @@ int figure_senet_player::provide_service() {
         auto house = ((building *)b)->dcast_house();
 
         if (house) {
-            auto &housed = house->runtime_data();
-            housed.senet_player = MAX_COVERAGE;
+            house->provide_service(HOUSE_SERVICE_SENET_PLAYER);
         }
     });
     return houses_serviced;
@@ -87,11 +87,10 @@ int figure_teacher::provide_service() {
         }
 
         const uint8_t delta_allow_papyrus = MAX_COVERAGE / 4;
-        auto &housed = house->runtime_data();
-        if ((MAX_COVERAGE - housed.school) > delta_allow_papyrus) {
+        if ((MAX_COVERAGE - house->service_level(HOUSE_SERVICE_SCHOOL)) > delta_allow_papyrus) {
             f->home()->stored_amount_first--;
         }
-        housed.school = MAX_COVERAGE;
+        house->provide_service(HOUSE_SERVICE_SCHOOL);
     });
     return houses_serviced;
 }
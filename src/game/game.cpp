@@ -41,7 +41,6 @@
 #include "platform/renderer.h"
 #include "io/movie_writer.h"
 #include "graphics/screen.h"
-#include "widget/widget_minimap.h"
 #include "city/city.h"
 #include "city/trade.h"
 #include "city/city_floods.h"
@@ -194,7 +193,7 @@ void game_t::advance_month() {
 
     if (g_settings.monthly_autosave) {
         bstring256 autosave_file("autosave_month.", saved_game_data_expanded.extension);
-        GamestateIO::write_savegame(autosave_file);
+        GamestateIO::write_savegame(autosave_file, /*autosave*/true);
     }
 
     events::emit(event_advance_month::from_simtime(game.simtime));
@@ -211,23 +210,22 @@ void game_t::advance_day() {
     g_city.update_day();
 
     g_sound.music_update(false);
-    widget_minimap_invalidate();
 
     events::emit(event_advance_day::from_simtime(game.simtime));
 }
 
 void game_t::shutdown() {
-    free(frame_pixels);
+    set_write_video(false);
 }
 
 void game_t::set_write_video(bool v) {
     if (!write_video && v) {
-        assert(!mvwriter);
-        mvwriter = new MovieWriter("test.mp4", screen_width(), screen_height(), 4);
+        assert(!mvcapture);
+        mvcapture = new MovieCapture("test.mp4", screen_width(), screen_height(), 4);
     } else if (write_video && !v) {
-        assert(mvwriter);
-        delete mvwriter;
-        mvwriter = nullptr;
+        assert(mvcapture);
+        delete mvcapture;
+        mvcapture = nullptr;
     }
     write_video = v;
 }
@@ -237,7 +235,7 @@ void game_t::write_frame() {
         return;
     }
 
-    if (!mvwriter) {
+    if (!mvcapture) {
         return;
     }
 
@@ -246,18 +244,9 @@ void game_t::write_frame() {
         return;
     }
     last_frame_tick = 0;
-    
-    ::painter ctx = this->painter();
-    if (!frame_pixels) {
-        frame_pixels = (color*)malloc(sizeof(color) * screen_width() * screen_height());
-    }
-
-    if (!graphics_renderer()->save_screen_buffer(ctx, frame_pixels, 0, 0, screen_width(), screen_height(), screen_width())) {
-        free(frame_pixels);
-        return;
-    }
 
-    mvwriter->addFrame((const uint8_t*)frame_pixels);
+    // readback is queued on the GPU where possible, conversion and encoding happen on the capture thread
+    mvcapture->captureFrame(graphics_renderer()->renderer(), vec2i(screen_width(), screen_height()));
 }
 
 void game_t::reload_objects() {
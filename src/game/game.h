@@ -37,7 +37,7 @@ enum e_session_type {
     e_session_custom_map = 2
 };
 
-class MovieWriter;
+class MovieCapture;
 
 struct game_t {
     enum {
@@ -52,10 +52,9 @@ struct game_t {
     uint16_t game_speed;
     uint32_t frame = 0;
     uint16_t last_frame_tick = 0;
-    color *frame_pixels = nullptr;
     bool write_video = false;
 
-    MovieWriter *mvwriter = nullptr;
+    MovieCapture *mvcapture = nullptr;
     simulation_time_t simtime;
 
     struct {
@@ -136,8 +136,8 @@ bool player_data_prepare_savegame(const char* filename_short) {
 
     vfs::create_folders(folders);
     // write file
-    return FILEIO.serialize(savefile, 0, FILE_FORMAT_SAVE_FILE, latest_save_version, [] (e_file_format file_format, const int file_version) {
-        FILEIO.push_chunk(4, false, "family_index", 0);
+    return FILEIO.serialize(savefile, 0, FILE_FORMAT_SAVE_FILE, latest_save_version, [] (FileIOManager &io, e_file_format file_format, const int file_version) {
+        io.push_chunk(4, false, "family_index", 0);
     });
 }
 
@@ -1,6 +1,7 @@
 #include "simulation_time.h"
 
 #include "io/io_buffer.h"
+#include "io/gamestate/boilerplate.h"
 #include "scenario/scenario.h"
 #include "game/game.h"
 
@@ -67,8 +68,10 @@ io_buffer* iob_game_time = new io_buffer([](io_buffer* iob, size_t version) {
     iob->bind____skip(3);
     iob->bind(BIND_SIGNATURE_INT16, &data.day);
     iob->bind____skip(2);
+    assert(iob->get_offset() == game_time_month_offset);
     iob->bind(BIND_SIGNATURE_INT16, &data.month);
     iob->bind____skip(2);
+    assert(iob->get_offset() == game_time_year_offset);
     iob->bind(BIND_SIGNATURE_INT16, &data.year);
     iob->bind____skip(2);
     iob->bind(BIND_SIGNATURE_INT32, &data.total_days);
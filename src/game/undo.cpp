@@ -11,13 +11,16 @@
 #include "graphics/image_groups.h"
 #include "graphics/window.h"
 #include "grid/canals.h"
+#include "grid/desirability.h"
 #include "grid/building.h"
 #include "grid/building_tiles.h"
 #include "grid/grid.h"
 #include "grid/image.h"
 #include "grid/property.h"
+#include "grid/road_network.h"
 #include "grid/routing/routing_terrain.h"
 #include "grid/sprite.h"
+#include "grid/water_supply.h"
 #include "grid/terrain.h"
 #include "scenario/earthquake.h"
 
@@ -173,6 +176,8 @@ static void add_building_to_terrain(building* b) {
     int size = building_impl::params(b->type).building_size;
     map_building_tiles_add(b->id, b->tile, size, 0, 0);
     b->state = BUILDING_STATE_VALID;
+    g_desirability.sources.add(*b);
+    g_well_coverage.reset_building(*b);
 
     auto main = b->main();
     main->dcast()->on_undo();
@@ -264,6 +269,8 @@ void game_undo_perform() {
     }
     map_routing_update_land();
     map_routing_update_walls();
+    map_road_network_rescan();
+    g_well_coverage.sync_terrain(); // restored terrain may carry an old fountain range
     data.num_buildings = 0;
     int vacant_lot_image = building_impl::params(BUILDING_HOUSE_VACANT_LOT).anim["base"].first_img();
     for (int i = 0; data.newhouses_offsets[i] != 0; i++) {
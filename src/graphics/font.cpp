@@ -1,5 +1,7 @@
 #include "font.h"
 
+#include "graphics/text.h"
+
 #include "core/encoding/trad_chinese.h"
 #include "image.h"
 #include "js/js_game.h"
@@ -339,6 +341,7 @@ static int image_y_offset_korean(uint8_t c, int image_height, int line_height) {
 
 void font_set_encoding(encoding_type encoding) {
     auto& data = g_font_data;
+    text_layout_cache_clear();
     data.multibyte = MULTIBYTE_NONE;
     if (encoding == ENCODING_EASTERN_EUROPE) {
         data.font_mapping = CHAR_TO_FONT_IMAGE_EASTERN;
@@ -1,16 +1,24 @@
 #include "graphics/painter.h"
 
+#include "core/profiler.h"
 #include "game/game.h"
 #include "graphics/graphics.h"
 #include "graphics/image.h"
 #include "platform/renderer.h"
 
+#include <algorithm>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include <SDL.h>
 
-std::unordered_map<uint64_t, SDL_Texture *> grayscaled_txs;
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PAINTER_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PAINTER_NEON
+#include <arm_neon.h>
+#endif
 
 void painter::draw(SDL_Texture *texture, vec2i pos, vec2i offset, vec2i size, color color, float scale_x, float scale_y,
                    double angle, ImgFlags flags, const bool force_linear) {
@@ -87,92 +95,167 @@ void painter::draw_impl(SDL_Texture *texture, vec2i pos, vec2i offset, vec2i siz
     }
 }
 
-SDL_Texture* painter::convertToGrayscale(SDL_Texture *tx, vec2i offset, vec2i size) {
-    if (!tx) {
-        return nullptr;
+// Grayscale copies of whole atlas pages. A page is read back once, on the first grayscale
+// draw from it, converted on the cpu and uploaded as one texture with the same layout,
+// so every sprite of the page is drawn from it at its usual atlas offset.
+// The least recently used pages are dropped when the cache goes over its texel budget.
+struct grayscale_cache_t {
+    enum {
+        MAX_TEXELS = 32 * 1024 * 1024,
+    };
+
+    struct page_t {
+        SDL_Texture *source;
+        SDL_Texture *gray;
+        int64_t texels;
+        uint64_t last_used;
+    };
+
+    std::vector<page_t> pages;
+    int64_t texels = 0;
+    uint64_t tick = 0;
+
+    page_t *find(SDL_Texture *source);
+    void add(SDL_Texture *source, SDL_Texture *gray, int64_t page_texels);
+    void release(SDL_Texture *source);
+};
+
+grayscale_cache_t g_grayscale_cache;
+
+grayscale_cache_t::page_t *grayscale_cache_t::find(SDL_Texture *source) {
+    for (auto &page : pages) {
+        if (page.source == source) {
+            page.last_used = ++tick;
+            return &page;
+        }
     }
+    return nullptr;
+}
 
-    uint64_t hash = ((uint64_t)tx & 0xffffffff) | ((uint64_t)offset.x << 32) | ((uint64_t)offset.y << 48);
-
-    auto it = grayscaled_txs.find(hash);
-    if (it != grayscaled_txs.end()) {
-        return it->second;
+void grayscale_cache_t::add(SDL_Texture *source, SDL_Texture *gray, int64_t page_texels) {
+    // the page being added is never evicted, even when it alone is over the budget
+    while (!pages.empty() && texels + page_texels > MAX_TEXELS) {
+        auto lru = std::min_element(pages.begin(), pages.end(), [] (const page_t &a, const page_t &b) { return a.last_used < b.last_used; });
+        release(lru->source);
     }
 
-    auto gray_tx = grayscaled_txs.insert({ hash , nullptr });
-
-    uint32_t format;
-    int w, h;
+    pages.push_back({source, gray, page_texels, ++tick});
+    texels += page_texels;
+}
 
-    /* Get information about texture we want to save */
-    int st = SDL_QueryTexture(tx, &format, NULL, &w, &h);
-    if (st != 0) {
-        return nullptr;
+void grayscale_cache_t::release(SDL_Texture *source) {
+    for (auto it = pages.begin(); it != pages.end(); ++it) {
+        if (it->source == source) {
+            if (it->gray) {
+                SDL_DestroyTexture(it->gray);
+            }
+            texels -= it->texels;
+            pages.erase(it);
+            return;
+        }
     }
+}
 
-    if (SDL_BYTESPERPIXEL(format) != 4) {
-        return nullptr;
-    }
+void painter_grayscale_release(SDL_Texture *tx) {
+    g_grayscale_cache.release(tx);
+}
 
-    SDL_Texture* ren_tex = SDL_CreateTexture(this->renderer, format, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
-    if (!ren_tex) {
-        return nullptr;
+// gray = (77 * r + 151 * g + 28 * b) >> 8, alpha is kept, pixels are ARGB8888
+static void convert_grayscale(uint32_t *pixels, size_t count) {
+    size_t i = 0;
+#if defined(PAINTER_SSE2)
+    const __m128i weights = _mm_setr_epi16(28, 151, 77, 0, 28, 151, 77, 0);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha_mask = _mm_set1_epi32((int)COLOR_CHANNEL_ALPHA);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128((const __m128i *)(pixels + i));
+        // per pixel pairs of 32-bit partial sums: b*28 + g*151, r*77 + a*0
+        const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), weights);
+        const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), weights);
+        const __m128i lo_sum = _mm_add_epi32(lo, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 3, 0, 1)));
+        const __m128i hi_sum = _mm_add_epi32(hi, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m128i y = _mm_unpacklo_epi64(_mm_shuffle_epi32(lo_sum, _MM_SHUFFLE(2, 0, 2, 0)),
+                                       _mm_shuffle_epi32(hi_sum, _MM_SHUFFLE(2, 0, 2, 0)));
+        y = _mm_srli_epi32(y, 8);
+        y = _mm_or_si128(y, _mm_or_si128(_mm_slli_epi32(y, 8), _mm_slli_epi32(y, 16)));
+        _mm_storeu_si128((__m128i *)(pixels + i), _mm_or_si128(y, _mm_and_si128(px, alpha_mask)));
     }
-
-    struct RenTexDeleter {
-        SDL_Texture *tx;
-        ~RenTexDeleter() { SDL_DestroyTexture(tx); }
-    } _renTexDeleter{ ren_tex };
-
-    /*
-     * Initialize our canvas, then copy texture to a target whose pixel data we
-     * can access
-     */
-    SDL_Texture *old_target = SDL_GetRenderTarget(this->renderer);
-    st = SDL_SetRenderTarget(this->renderer, ren_tex);
-    if (st != 0) {
-        return nullptr;
+#elif defined(PAINTER_NEON)
+    const uint8x8_t wr = vdup_n_u8(77);
+    const uint8x8_t wg = vdup_n_u8(151);
+    const uint8x8_t wb = vdup_n_u8(28);
+    for (; i + 8 <= count; i += 8) {
+        uint8x8x4_t px = vld4_u8((const uint8_t *)(pixels + i)); // b, g, r, a planes
+        uint16x8_t sum = vmull_u8(px.val[0], wb);
+        sum = vmlal_u8(sum, px.val[1], wg);
+        sum = vmlal_u8(sum, px.val[2], wr);
+        const uint8x8_t y = vshrn_n_u16(sum, 8);
+        px.val[0] = y;
+        px.val[1] = y;
+        px.val[2] = y;
+        vst4_u8((uint8_t *)(pixels + i), px);
     }
+#endif
+    for (; i < count; ++i) {
+        const uint32_t p = pixels[i];
+        const uint32_t y = (77 * ((p >> 16) & 0xff) + 151 * ((p >> 8) & 0xff) + 28 * (p & 0xff)) >> 8;
+        pixels[i] = (p & COLOR_CHANNEL_ALPHA) | (y << 16) | (y << 8) | y;
+    }
+}
 
-    SDL_SetRenderDrawColor(this->renderer, 0x00, 0x00, 0x00, 0x00);
-    SDL_RenderClear(this->renderer);
-
-    SDL_Rect srcrect{ offset.x, offset.y, size.x, size.y };
-    st = SDL_RenderCopy(this->renderer, tx, &srcrect, NULL);
-    if (st != 0) {
+SDL_Texture* painter::convertToGrayscale(SDL_Texture *tx) {
+    if (!tx) {
         return nullptr;
     }
 
-    /* Create buffer to hold texture data and load it */
-    std::vector<uint32_t> pixels(size.x * size.y);
-    st = SDL_RenderReadPixels(this->renderer, NULL, format, pixels.data(), size.x * SDL_BYTESPERPIXEL(format));
-
-    const SDL_PixelFormat *pxformat = SDL_AllocFormat(format);
-    for (int y = 0; y < size.y; ++y) {
-        for (int x = 0; x < size.x; ++x) {
-            Uint32 *pixel = pixels.data() + y * size.x + x;
-            Uint8 r, g, b, a;
-            SDL_GetRGBA(*pixel, pxformat, &r, &g, &b, &a);
-            Uint8 gray = static_cast<Uint8>(0.3 * r + 0.59 * g + 0.11 * b);
-            *pixel = SDL_MapRGBA(pxformat, gray, gray, gray, a);
-        }
+    if (auto page = g_grayscale_cache.find(tx)) {
+        return page->gray;
     }
 
-    /* Copy pixel data over to surface */
-    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels.data(), size.x, size.y, SDL_BITSPERPIXEL(format),
-                                                              size.x * SDL_BYTESPERPIXEL(format), format);
-    if (!surface) {
+    OZZY_PROFILER_SECTION("Render/Grayscale Page");
+    int w, h;
+    if (SDL_QueryTexture(tx, nullptr, nullptr, &w, &h) != 0) {
         return nullptr;
     }
 
-    SDL_Texture *gray_tx_ptr = SDL_CreateTextureFromSurface(this->renderer, surface);
+    // a failed page is cached as empty too, so it is not read back on every draw
+    SDL_Texture *gray_tx = nullptr;
+    SDL_Texture *ren_tex = SDL_CreateTexture(this->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, w, h);
+    if (ren_tex) {
+        SDL_Texture *old_target = SDL_GetRenderTarget(this->renderer);
+        SDL_BlendMode old_blend;
+        SDL_GetTextureBlendMode(tx, &old_blend);
+        Uint8 old_r, old_g, old_b, old_a;
+        SDL_GetTextureColorMod(tx, &old_r, &old_g, &old_b);
+        SDL_GetTextureAlphaMod(tx, &old_a);
+
+        std::vector<uint32_t> pixels((size_t)w * h);
+        bool ok = SDL_SetRenderTarget(this->renderer, ren_tex) == 0;
+        if (ok) {
+            // plain copy of the page, without blending or the modulation of the last draw
+            SDL_SetRenderDrawColor(this->renderer, 0x00, 0x00, 0x00, 0x00);
+            SDL_RenderClear(this->renderer);
+            SDL_SetTextureBlendMode(tx, SDL_BLENDMODE_NONE);
+            SDL_SetTextureColorMod(tx, 0xff, 0xff, 0xff);
+            SDL_SetTextureAlphaMod(tx, 0xff);
+            ok = SDL_RenderCopy(this->renderer, tx, nullptr, nullptr) == 0
+                 && SDL_RenderReadPixels(this->renderer, nullptr, SDL_PIXELFORMAT_ARGB8888, pixels.data(), w * sizeof(uint32_t)) == 0;
+        }
 
-    gray_tx.first->second = gray_tx_ptr;
-    SDL_FreeSurface(surface);
+        SDL_SetTextureBlendMode(tx, old_blend);
+        SDL_SetTextureColorMod(tx, old_r, old_g, old_b);
+        SDL_SetTextureAlphaMod(tx, old_a);
+        SDL_SetRenderTarget(this->renderer, old_target);
+        SDL_DestroyTexture(ren_tex);
 
-    SDL_SetRenderTarget(this->renderer, old_target);
+        if (ok) {
+            convert_grayscale(pixels.data(), pixels.size());
+            gray_tx = graphics_renderer()->create_texture_from_buffer((color *)pixels.data(), w, h);
+        }
+    }
 
-    return gray_tx_ptr;
+    g_grayscale_cache.add(tx, gray_tx, (int64_t)w * h);
+    return gray_tx;
 }
 
 auto painter::draw_grayscale(SDL_Texture *texture, vec2i pos, vec2i offset, vec2i size, float scale_x, float scale_y,
@@ -181,12 +264,12 @@ auto painter::draw_grayscale(SDL_Texture *texture, vec2i pos, vec2i offset, vec2
         return;
     }
 
-    SDL_Texture *grtx = convertToGrayscale(texture, offset, size);
-    if (!grtx) { 
+    SDL_Texture *grtx = convertToGrayscale(texture);
+    if (!grtx) {
         return;
     }
 
-    draw_impl(grtx, pos, vec2i{ 0, 0 }, size, COLOR_WHITE, scale_x, scale_y, angle, flags, force_linear);
+    draw_impl(grtx, pos, offset, size, COLOR_WHITE, scale_x, scale_y, angle, flags, force_linear);
 }
 
 void painter::draw(const sprite &spr, vec2i pos, color color_mask, float scale_x, float scale_y, double angle, ImgFlags flags, const bool force_linear) {
@@ -43,6 +43,9 @@ protected:
         SDL_Texture *texture, vec2i pos, vec2i offset, vec2i size, color color = COLOR_MASK_NONE,
         float scale_x = 1.f, float scale_y = 1.f, double angle = 0, ImgFlags flags = ImgFlag_None, bool force_linear = false
     );
-    SDL_Texture *convertToGrayscale(SDL_Texture *tx, vec2i offset, vec2i size);
+    SDL_Texture *convertToGrayscale(SDL_Texture *tx);
 };
 
+// drops the grayscale copy of an atlas page, must be called before the page texture is destroyed
+void painter_grayscale_release(SDL_Texture *tx);
+
@@ -7,11 +7,99 @@
 #include "io/gamefiles/lang.h"
 #include "game/game.h"
 
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #define ELLIPSIS_LENGTH 4
 #define NUMBER_BUFFER_LENGTH 100
 
 static uint8_t tmp_line[200];
 
+// Layouts of recently drawn strings: the glyph run of text_draw, the measured width
+// and the wrapped lines of text_draw_multiline, so unchanged labels skip the font lookups.
+// Entries not used during the last MAX_ENTRIES lookups are dropped once the cache is full.
+struct text_layout_cache_t {
+    enum {
+        MAX_ENTRIES = 2048,
+    };
+
+    struct glyph_t {
+        int letter_id;
+        int x;
+        int y; // offset above the baseline
+    };
+
+    struct key_t {
+        std::string text;
+        int font;
+        float scale;
+        int box_width;
+
+        bool operator==(const key_t &o) const {
+            return font == o.font && scale == o.scale && box_width == o.box_width && text == o.text;
+        }
+    };
+
+    struct key_hash {
+        size_t operator()(const key_t &k) const {
+            size_t h = std::hash<std::string>()(k.text);
+            h ^= (size_t)k.font * 0x9e3779b1u + (size_t)k.box_width * 0x85ebca6bu;
+            h ^= std::hash<float>()(k.scale) + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    struct layout_t {
+        // each part is filled by the first call that needs it
+        bool has_glyphs = false;
+        bool has_lines = false;
+        std::vector<glyph_t> glyphs;
+        int advance = 0;
+        int width = -1;
+        std::vector<std::string> lines; // wrapped at box_width
+        uint32_t last_used = 0;
+    };
+
+    std::unordered_map<key_t, layout_t, key_hash> entries;
+    key_t probe;
+    uint32_t use_tick = 0;
+    uint32_t next_sweep = 0;
+
+    layout_t &get(const uint8_t *str, int length, e_font font, float scale, int box_width);
+    void clear() { entries.clear(); }
+};
+
+text_layout_cache_t g_text_layout_cache;
+
+text_layout_cache_t::layout_t &text_layout_cache_t::get(const uint8_t *str, int length, e_font font, float scale, int box_width) {
+    ++use_tick;
+    probe.text.assign((const char *)str, length);
+    probe.font = font;
+    probe.scale = scale;
+    probe.box_width = box_width;
+
+    auto it = entries.find(probe);
+    if (it == entries.end()) {
+        // entries in use right now were just touched, so references held by callers stay valid
+        if (entries.size() >= MAX_ENTRIES && use_tick >= next_sweep) {
+            for (auto e = entries.begin(); e != entries.end();) {
+                e = (use_tick - e->second.last_used > MAX_ENTRIES) ? entries.erase(e) : std::next(e);
+            }
+            next_sweep = use_tick + MAX_ENTRIES / 4;
+        }
+        it = entries.emplace(probe, layout_t{}).first;
+    }
+
+    it->second.last_used = use_tick;
+    return it->second;
+}
+
+void text_layout_cache_clear() {
+    g_text_layout_cache.clear();
+}
+
 struct input_cursor_t {
     int capture;
     int seen;
@@ -89,11 +177,7 @@ int get_letter_height(const uint8_t* str, e_font font) {
     return letter_id >= 0 ? image_letter(letter_id)->height : 0;
 }
 
-int text_get_width(const uint8_t* str, e_font font) {
-    if (!str) {
-        return 0;
-    }
-
+static int measure_width(const uint8_t* str, e_font font) {
     const font_definition* def = font_definition_for(font);
     int maxlen = 10000;
     int width = 0;
@@ -115,6 +199,18 @@ int text_get_width(const uint8_t* str, e_font font) {
     return width;
 }
 
+int text_get_width(const uint8_t* str, e_font font) {
+    if (!str) {
+        return 0;
+    }
+
+    auto &layout = g_text_layout_cache.get(str, string_length(str), font, 1.f, 0);
+    if (layout.width < 0) {
+        layout.width = measure_width(str, font);
+    }
+    return layout.width;
+}
+
 int get_letter_width(const uint8_t* str, const font_definition* def, int* num_bytes) {
     *num_bytes = 1;
     if (*str == ' ') {
@@ -240,25 +336,46 @@ int text_draw(const uint8_t *str, int x, int y, e_font font, color color) {
     return text_draw(ctx, str, x, y, font, color);
 }
 
-int text_draw(painter &ctx, const uint8_t* str, int x, int y, e_font font, color color, float scale) {
-    y = y - 3;
+static void layout_glyphs(text_layout_cache_t::layout_t &layout, const font_definition *def, const uint8_t *str, int length, float scale) {
+    int current_x = 0;
+    while (length > 0) {
+        int num_bytes = 1;
 
+        if (*str >= ' ') {
+            int letter_id = font_letter_id(def, str, &num_bytes);
+            int width = 0;
 
-    const font_definition* def = font_definition_for(font);
-    if (!def) {
-        return 0;
-    }
+            if (letter_id < 0) {
+                letter_id = font_letter_id(def, (uint8_t*)"?", &num_bytes);
+            }
 
-    int length = string_length(str);
-    if (!length) {
-        return 0;
-    }
+            if (*str == ' ' || *str == '_') {
+                width = (def->space_width * scale);
+            } else {
+                const image_t* img = image_letter(letter_id);
+                if (img != nullptr) {
+                    int height = def->image_y_offset(*str, img->height, def->line_height);
+                    layout.glyphs.push_back({letter_id, current_x, height});
+                    width = (def->letter_spacing + img->width) * scale;
+                }
+            }
+            current_x += width;
+        }
 
-    if (input_cursor.capture) {
-        str += input_cursor.text_offset_start;
-        length = input_cursor.text_offset_end - input_cursor.text_offset_start;
+        str += num_bytes;
+        length -= num_bytes;
     }
 
+    current_x += def->space_width;
+    layout.advance = current_x;
+    layout.has_glyphs = true;
+}
+
+// the input box text is drawn directly, it tracks the cursor while walking the glyphs
+static int draw_glyphs_with_cursor(painter &ctx, const font_definition *def, const uint8_t *str, int length, int x, int y, e_font font, color color, float scale) {
+    str += input_cursor.text_offset_start;
+    length = input_cursor.text_offset_end - input_cursor.text_offset_start;
+
     int current_x = x;
     while (length > 0) {
         int num_bytes = 1;
@@ -306,6 +423,36 @@ int text_draw(painter &ctx, const uint8_t* str, int x, int y, e_font font, color
     current_x += def->space_width;
     return current_x - x;
 }
+
+int text_draw(painter &ctx, const uint8_t* str, int x, int y, e_font font, color color, float scale) {
+    y = y - 3;
+
+
+    const font_definition* def = font_definition_for(font);
+    if (!def) {
+        return 0;
+    }
+
+    int length = string_length(str);
+    if (!length) {
+        return 0;
+    }
+
+    if (input_cursor.capture) {
+        return draw_glyphs_with_cursor(ctx, def, str, length, x, y, font, color, scale);
+    }
+
+    auto &layout = g_text_layout_cache.get(str, length, font, scale, 0);
+    if (!layout.has_glyphs) {
+        layout_glyphs(layout, def, str, length, scale);
+    }
+
+    for (const auto &glyph : layout.glyphs) {
+        ImageDraw::img_letter(ctx, font, glyph.letter_id, x + glyph.x, y - glyph.y, color, scale);
+    }
+    return layout.advance;
+}
+
 void text_draw_centered(const uint8_t* str, int x, int y, int box_width, e_font font, color color) {
     int offset = (box_width - (int)text_get_width(str, font)) / 2;
     if (offset < 0) {
@@ -387,14 +534,9 @@ void text_draw_label_and_number_centered(const char* label, int value, const cha
     text_draw_centered(str, x_offset, y_offset, box_width, font, color);
 }
 
-int text_draw_multiline(const uint8_t* str, int x_offset, int y_offset, int box_width, e_font font, uint32_t color) {
-    int line_height = font_definition_for(font)->line_height;
-    if (line_height < 11)
-        line_height = 11;
-
+static void wrap_lines(std::vector<std::string> &lines, const uint8_t* str, int box_width, e_font font) {
     int has_more_characters = 1;
     int guard = 0;
-    int y = y_offset;
     while (has_more_characters) {
         if (++guard >= 100)
             break;
@@ -429,39 +571,33 @@ int text_draw_multiline(const uint8_t* str, int x_offset, int y_offset, int box_
                 }
             }
         }
-        text_draw(tmp_line, x_offset, y, font, color);
+        lines.emplace_back((const char*)tmp_line);
+    }
+}
+
+int text_draw_multiline(const uint8_t* str, int x_offset, int y_offset, int box_width, e_font font, uint32_t color) {
+    int line_height = font_definition_for(font)->line_height;
+    if (line_height < 11)
+        line_height = 11;
+
+    auto &layout = g_text_layout_cache.get(str, string_length(str), font, 1.f, box_width);
+    if (!layout.has_lines) {
+        wrap_lines(layout.lines, str, box_width, font);
+        layout.has_lines = true;
+    }
+
+    int y = y_offset;
+    for (const auto &line : layout.lines) {
+        text_draw((const uint8_t*)line.c_str(), x_offset, y, font, color);
         y += line_height + 5;
     }
     return y - y_offset;
 }
 int text_measure_multiline(const uint8_t* str, int box_width, e_font font) {
-    int has_more_characters = 1;
-    int guard = 0;
-    int num_lines = 0;
-    while (has_more_characters) {
-        if (++guard >= 100)
-            break;
-
-        int current_width = 0;
-        while (has_more_characters && current_width < box_width) {
-            int word_num_chars;
-            int word_width = get_word_width(str, font, &word_num_chars);
-            current_width += word_width;
-            if (current_width >= box_width) {
-                if (current_width == 0)
-                    has_more_characters = 0;
-
-            } else {
-                str += word_num_chars;
-                if (!*str)
-                    has_more_characters = 0;
-                else if (*str == '\n') {
-                    str++;
-                    break;
-                }
-            }
-        }
-        num_lines += 1;
+    auto &layout = g_text_layout_cache.get(str, string_length(str), font, 1.f, box_width);
+    if (!layout.has_lines) {
+        wrap_lines(layout.lines, str, box_width, font);
+        layout.has_lines = true;
     }
-    return num_lines;
+    return (int)layout.lines.size();
 }
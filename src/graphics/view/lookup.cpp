@@ -140,6 +140,17 @@ vec2i tile_to_pixel(tile2i point) {
     return MAPPOINT_TO_PIXEL_LOOKUP[grid_offset];
 }
 
+// pixel distance between two map tiles in the current orientation, dx/dy are absolute grid deltas
+vec2i tile_pixel_delta(int dx, int dy) {
+    vec2i start;
+    vec2i column_step;
+    vec2i row_step;
+    screentile_calc_params_by_orientation(city_view_orientation() / 2, &start, &column_step, &row_step);
+
+    return { (dx * column_step.x + dy * row_step.x) * HALF_TILE_WIDTH_PIXELS,
+             (dx * column_step.y + dy * row_step.y) * HALF_TILE_HEIGHT_PIXELS };
+}
+
 vec2i pixel_to_viewport(vec2i pixel) {
     return pixel - g_city_view.viewport.offset;
 }
@@ -459,19 +459,40 @@ static vec2i starting_pixel_coord(painter &ctx) {
     return pixel - camera_get_pixel_offset_internal(ctx);
 }
 
-void city_view_foreach_valid_map_tile(painter &ctx,
-                                      tile_draw_callback callback1,
-                                      tile_draw_callback callback2,
-                                      tile_draw_callback callback3,
-                                      tile_draw_callback callback4,
-                                      tile_draw_callback callback5,
-                                      tile_draw_callback callback6) {
+struct visible_tiles_cache_t {
+    vec2i screen_0 = {-1, -1};
+    vec2i pixel_0 = {0, 0};
+    vec2i viewport_offset = {0, 0};
+    vec2i viewport_tiles = {0, 0};
+    int orientation = -1;
+    std::vector<city_view_tile> tiles;
+};
+
+visible_tiles_cache_t g_visible_tiles;
+
+const std::vector<city_view_tile> &city_view_visible_tiles(painter &ctx) {
     auto& data = g_city_view;
+    auto& cache = g_visible_tiles;
+
+    const vec2i screen_0 = starting_tile(ctx);
+    const vec2i pixel_0 = starting_pixel_coord(ctx);
+    const vec2i viewport_tiles(data.viewport.width_tiles, data.viewport.height_tiles);
+    if (cache.screen_0 == screen_0 && cache.pixel_0 == pixel_0
+        && cache.viewport_offset == data.viewport.offset
+        && cache.viewport_tiles == viewport_tiles
+        && cache.orientation == data.orientation) {
+        return cache.tiles;
+    }
+
+    cache.screen_0 = screen_0;
+    cache.pixel_0 = pixel_0;
+    cache.viewport_offset = data.viewport.offset;
+    cache.viewport_tiles = viewport_tiles;
+    cache.orientation = data.orientation;
+    cache.tiles.clear();
 
     int odd = 0;
-    vec2i screen_0 = starting_tile(ctx);
     vec2i screen = screen_0;
-    vec2i pixel_0 = starting_pixel_coord(ctx);
     vec2i pixel = pixel_0;
 
     for (int y = 0; y < data.viewport.height_tiles + 21; y++) {
@@ -488,23 +509,7 @@ void city_view_foreach_valid_map_tile(painter &ctx,
                 if (screen.x >= 0 && screen.x < (2 * GRID_LENGTH) + 1) {
                     tile2i point = screen_to_tile(screen);
                     if (point.grid_offset() >= 0) {
-                        if (callback1)
-                            callback1(pixel, point, ctx);
-
-                        if (callback2)
-                            callback2(pixel, point, ctx);
-
-                        if (callback3)
-                            callback3(pixel, point, ctx);
-
-                        if (callback4)
-                            callback4(pixel, point, ctx);
-
-                        if (callback5)
-                            callback5(pixel, point, ctx);
-
-                        if (callback6)
-                            callback6(pixel, point, ctx);
+                        cache.tiles.push_back({pixel, point});
                     }
                 }
 
@@ -517,6 +522,8 @@ void city_view_foreach_valid_map_tile(painter &ctx,
         pixel.y += HALF_TILE_HEIGHT_PIXELS;
         screen.y++;
     }
+
+    return cache.tiles;
 }
 
 static void do_valid_callback(painter &ctx, vec2i pixel, tile2i point, tile_draw_callback callback) {
@@ -5,6 +5,8 @@
 #include "zoom.h"
 #include "graphics/painter.h"
 
+#include <vector>
+
 extern int SCROLL_MIN_SCREENTILE_X;
 extern int SCROLL_MIN_SCREENTILE_Y;
 extern int SCROLL_MAX_SCREENTILE_X;
@@ -93,12 +95,19 @@ bool city_view_is_sidebar_collapsed(void);
 void city_view_start_sidebar_toggle(void);
 void city_view_toggle_sidebar(int mode = -1);
 
-void city_view_foreach_valid_map_tile(painter &ctx,
-                                      tile_draw_callback callback1,
-                                      tile_draw_callback callback2 = nullptr,
-                                      tile_draw_callback callback3 = nullptr,
-                                      tile_draw_callback callback4 = nullptr,
-                                      tile_draw_callback callback5 = nullptr,
-                                      tile_draw_callback callback6 = nullptr);
+struct city_view_tile {
+    vec2i pixel;
+    tile2i tile;
+};
+
+// valid map tiles covered by the viewport, rebuilt only when camera, zoom, viewport or orientation changes
+const std::vector<city_view_tile> &city_view_visible_tiles(painter &ctx);
+
+template<typename ... Callbacks>
+inline void city_view_foreach_valid_map_tile(painter &ctx, Callbacks&& ... callbacks) {
+    for (const city_view_tile &vt : city_view_visible_tiles(ctx)) {
+        (callbacks(vt.pixel, vt.tile, ctx), ...);
+    }
+}
 
 void city_view_foreach_tile_in_range(painter &ctx, int grid_offset, int size, int radius, tile_draw_callback callback);
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "building/building.h"
 #include "grid/grid.h"
 #include "grid/property.h"
+#include "grid/routing/routing.h"
 #include "grid/image.h"
 #include "game/game_config.h"
 #include "graphics/graphics.h"
@@ -25,6 +26,7 @@ int map_building_at(tile2i tile) {
 }
 
 void map_building_set(int grid_offset, int building_id) {
+    map_routing_version_bump();
     map_grid_set(g_buildings_grid, grid_offset, building_id);
 }
 
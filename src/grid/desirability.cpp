@@ -4,6 +4,8 @@
 #include "building/model.h"
 #include "core/calc.h"
 #include "core/profiler.h"
+#include "dev/debug.h"
+#include "grid/building.h"
 #include "grid/grid.h"
 #include "grid/property.h"
 #include "grid/ring.h"
@@ -11,8 +13,11 @@
 #include "io/io_buffer.h"
 #include "scenario/map.h"
 #include "city/city.h"
+#include "city/city_buildings.h"
 #include "js/js_game.h"
 
+#include <algorithm>
+
 grid_xx g_desirability_grid = {0, FS_INT8};
  
 desirability_t ANK_VARIABLE_N(g_desirability, "desirability");
@@ -93,6 +98,39 @@ void desirability_t::add_to_terrain(tile2i tile, int size, int desirability, int
     }
 }
 
+// Read-only check of the source index: around every house, each building a row by row scan
+// of the lookup area finds on the map must also be returned by the index.
+declare_console_command_p(testdesirabilitysources) {
+    int houses = 0;
+    int missing = 0;
+    buildings_valid_do([&] (building &house) {
+        if (!house.dcast_house()) {
+            return;
+        }
+
+        houses++;
+        grid_area area = map_grid_get_area(house.tile, 1, 6);
+        std::vector<building_id> indexed;
+        g_desirability.sources.for_each_in_area(area.tmin, area.tmax, [&indexed] (building_id id) {
+            indexed.push_back(id);
+        });
+
+        map_grid_area_foreach(area.tmin, area.tmax, [&] (tile2i tile) {
+            const int id = map_building_at(tile);
+            if (!id || building_get(id)->state == BUILDING_STATE_UNUSED) {
+                return;
+            }
+
+            if (std::find(indexed.begin(), indexed.end(), id) == indexed.end()) {
+                os << "testdesirabilitysources: building " << id << " at " << tile.x() << "," << tile.y() << " not indexed near house " << house.id << std::endl;
+                missing++;
+            }
+        });
+    });
+
+    os << "testdesirabilitysources: " << houses << " houses checked, " << (missing ? "failed" : "passed") << std::endl;
+}
+
 void desirability_t::update_buildings() {
     buildings_valid_do([this] (building &b) {
         const model_building *model = model_get_building(b.type);
@@ -100,6 +138,58 @@ void desirability_t::update_buildings() {
     });
 }
 
+void desirability_t::sources_t::clear() {
+    for (auto &cell : cells) {
+        cell.clear();
+    }
+    cell_of.assign(MAX_BUILDINGS, -1);
+    max_size = 1;
+}
+
+void desirability_t::sources_t::rebuild() {
+    OZZY_PROFILER_SECTION("Game/Desirability/Sources Rebuild");
+    clear();
+    for (building &b : city_buildings()) {
+        if (b.state != BUILDING_STATE_UNUSED) {
+            add(b);
+        }
+    }
+}
+
+void desirability_t::sources_t::add(building &b) {
+    if (b.id <= 0) {
+        return;
+    }
+
+    if (cell_of.empty()) {
+        cell_of.assign(MAX_BUILDINGS, -1);
+    }
+
+    const int cell = (b.tile.y() / CELL_SIZE) * CELLS_PER_ROW + (b.tile.x() / CELL_SIZE);
+    max_size = std::max<int>(max_size, b.size);
+    if (cell_of[b.id] == cell) {
+        return;
+    }
+
+    remove(b);
+    cells[cell].push_back(b.id);
+    cell_of[b.id] = cell;
+}
+
+void desirability_t::sources_t::remove(building &b) {
+    if (b.id <= 0 || cell_of.empty() || cell_of[b.id] < 0) {
+        return;
+    }
+
+    auto &cell = cells[cell_of[b.id]];
+    auto it = std::find(cell.begin(), cell.end(), b.id);
+    if (it != cell.end()) {
+        *it = cell.back();
+        cell.pop_back();
+    }
+    cell_of[b.id] = -1;
+}
+
 void desirability_t::update_terrain() {
     int grid_offset = scenario_map_data()->start_offset;
     tile2i tile(grid_offset);
@@ -1,9 +1,44 @@
 #pragma once
 
 #include "grid/point.h"
+#include "grid/grid.h"
 #include "core/runtime_item.h"
+#include "building/building_type.h"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+class building;
 
 struct desirability_t {
+    // Buildings bucketed by the coarse map cell of their main tile, so lookups for nearby
+    // desirability sources visit a few cells instead of every tile around. Updated when
+    // buildings are created, restored by undo or deleted, when houses merge or expand onto
+    // a new main tile, and rebuilt after a load.
+    // The sign of the influence is checked by the caller, houses change type in place.
+    struct sources_t {
+        enum {
+            CELL_SIZE = 8,
+            CELLS_PER_ROW = (GRID_LENGTH + CELL_SIZE - 1) / CELL_SIZE,
+        };
+
+        std::array<std::vector<building_id>, CELLS_PER_ROW * CELLS_PER_ROW> cells;
+        std::vector<int16_t> cell_of; // per building id, -1 when not indexed
+        int max_size = 1;             // largest footprint indexed, widens the lookup
+
+        void clear();
+        void rebuild();
+        void add(building &b);
+        void remove(building &b);
+
+        // calls func(building_id) for every indexed building whose footprint may touch [tmin, tmax]
+        template<typename F>
+        void for_each_in_area(tile2i tmin, tile2i tmax, F func) const;
+    };
+
+    sources_t sources;
+
     struct influence_t {
         int size = 0;
         int value = 0;
@@ -38,4 +73,19 @@ struct desirability_t {
     int get_avg(tile2i tile, int size);
 };
 
-extern desirability_t g_desirability;
\ No newline at end of file
+extern desirability_t g_desirability;
+
+template<typename F>
+void desirability_t::sources_t::for_each_in_area(tile2i tmin, tile2i tmax, F func) const {
+    const int cx_min = std::max(0, tmin.x() - max_size + 1) / CELL_SIZE;
+    const int cy_min = std::max(0, tmin.y() - max_size + 1) / CELL_SIZE;
+    const int cx_max = std::clamp(tmax.x(), 0, GRID_LENGTH - 1) / CELL_SIZE;
+    const int cy_max = std::clamp(tmax.y(), 0, GRID_LENGTH - 1) / CELL_SIZE;
+    for (int cy = cy_min; cy <= cy_max; ++cy) {
+        for (int cx = cx_min; cx <= cx_max; ++cx) {
+            for (building_id id : cells[cy * CELLS_PER_ROW + cx]) {
+                func(id);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -7,11 +7,14 @@
 #include "graphics/view/lookup.h"
 #include "graphics/view/view.h"
 #include "city/city_figures.h"
+#include "core/profiler.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
 
 static grid_xx grid_figures = {0, FS_UINT16};
-svector<figure *, 5000> g_figures_y_sort;
 
 bool map_has_figure_at(int grid_offset) {
     return map_grid_is_valid_offset(grid_offset) && map_grid_get(grid_figures, grid_offset) > 0;
@@ -21,8 +24,90 @@ int map_figure_id_get(int grid_offset) {
     return map_grid_is_valid_offset(grid_offset) ? map_grid_get(grid_figures, grid_offset) : 0;
 }
 
-void map_figure_sort_by_y() {
-    g_figures_y_sort.clear();
+// Per frame list of the figures to draw, bucketed by the visible tile that draws them.
+// The visible tiles sit on a lattice of half tile rows and half tile columns, so the tile
+// at a screen pixel is found by a lookup, and a figure goes to the first tile in drawing
+// order whose row band (one tile high) and column span (one tile each side) contain it.
+struct figure_draw_list_t {
+    vec2i origin;
+    int rows = 0;
+    int columns = 0;                 // in half tiles
+    std::vector<int> slots;          // visible tile index per lattice cell, -1 when none
+    std::vector<uint8_t> culled;     // per visible tile, row is outside of the viewport
+    std::vector<uint32_t> starts;    // per visible tile, range in figures
+    std::vector<figure *> figures;
+    std::vector<std::pair<figure *, int>> pending;
+    std::vector<figure *> scratch;
+
+    int slot_at(int row, int column) const {
+        if (row < 0 || row >= rows || column < 0 || column >= columns) {
+            return -1;
+        }
+        return slots[row * columns + column];
+    }
+
+    int row_of(int y) const { return floor_div(y - origin.y, HALF_TILE_HEIGHT_PIXELS); }
+    int column_of(int x) const { return floor_div(x - origin.x, HALF_TILE_WIDTH_PIXELS); }
+    static int floor_div(int a, int b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); }
+};
+
+figure_draw_list_t g_figure_draw_list;
+
+static bool map_figure_row_visible(vec2i pixel) {
+    const vec2i scr = pixel_to_viewport(pixel);
+    const vec2i &size = g_city_view.viewport.size_pixels;
+    return scr.x >= 0 && scr.x <= size.x && scr.y + TILE_HEIGHT_PIXELS >= 0 && scr.y <= size.y;
+}
+
+static int map_figure_draw_slot(const figure_draw_list_t &list, vec2i pos) {
+    // rows are visited top to bottom and tiles left to right, the first match draws the figure
+    const int last_row = list.row_of(pos.y);
+    const int first_column = list.column_of(pos.x - TILE_WIDTH_PIXELS - 1) + 1;
+    const int last_column = list.column_of(pos.x + TILE_WIDTH_PIXELS);
+    for (int row = last_row - 1; row <= last_row; ++row) {
+        for (int column = first_column; column <= last_column; ++column) {
+            const int slot = list.slot_at(row, column);
+            if (slot >= 0 && !list.culled[slot]) {
+                return slot;
+            }
+        }
+    }
+    return -1;
+}
+
+void map_figure_build_draw_list(painter &ctx) {
+    OZZY_PROFILER_SECTION("Render/Figures/Draw List");
+    auto &list = g_figure_draw_list;
+    const auto &tiles = city_view_visible_tiles(ctx);
+
+    list.figures.clear();
+    list.pending.clear();
+    list.starts.assign(tiles.size() + 1, 0);
+    list.culled.resize(tiles.size());
+    if (tiles.empty()) {
+        list.rows = list.columns = 0;
+        return;
+    }
+
+    vec2i min_pixel = tiles.front().pixel;
+    vec2i max_pixel = tiles.front().pixel;
+    for (const auto &vt : tiles) {
+        min_pixel.x = std::min(min_pixel.x, vt.pixel.x);
+        min_pixel.y = std::min(min_pixel.y, vt.pixel.y);
+        max_pixel.x = std::max(max_pixel.x, vt.pixel.x);
+        max_pixel.y = std::max(max_pixel.y, vt.pixel.y);
+    }
+
+    list.origin = min_pixel;
+    list.rows = list.row_of(max_pixel.y) + 1;
+    list.columns = list.column_of(max_pixel.x) + 1;
+    list.slots.assign(list.rows * list.columns, -1);
+    for (int i = 0; i < (int)tiles.size(); ++i) {
+        const vec2i pixel = tiles[i].pixel;
+        list.slots[list.row_of(pixel.y) * list.columns + list.column_of(pixel.x)] = i;
+        list.culled[i] = !map_figure_row_visible(pixel);
+    }
+
     for (auto *f : map_figures()) {
         if (f->state == FIGURE_STATE_NONE) {
             continue;
@@ -44,44 +129,79 @@ void map_figure_sort_by_y() {
 
         f->cached_pos = f->adjust_pixel_offset(f->cached_pos);
         f->is_drawn = false;
-        g_figures_y_sort.push_back(f);
+
+        const int slot = map_figure_draw_slot(list, f->cached_pos);
+        if (slot >= 0) {
+            list.pending.push_back({f, slot});
+            list.starts[slot + 1]++;
+        }
     }
 
-    std::sort(g_figures_y_sort.begin(), g_figures_y_sort.end(), [] (figure *lhs, figure *rhs) {
-        return lhs->cached_pos.y < rhs->cached_pos.y;
-    });
-}
+    // counting sort by tile, then by y inside of each tile, buckets hold a few figures at most
+    for (size_t i = 1; i < list.starts.size(); ++i) {
+        list.starts[i] += list.starts[i - 1];
+    }
 
-custom_span<figure *> map_figures_in_row(tile2i tile) {
-    vec2i pixel_begin = tile_to_pixel(tile);
-    vec2i pixel_end = pixel_begin + vec2i(0, TILE_HEIGHT_PIXELS);
+    list.figures.resize(list.pending.size());
+    for (const auto &item : list.pending) {
+        list.figures[list.starts[item.second]++] = item.first;
+    }
 
-    vec2i pixel_begin_scr = pixel_to_viewport(pixel_begin);
-    vec2i pixel_end_scr = pixel_to_viewport(pixel_end);
+    // placing advanced every start to the start of the next bucket, shift them back
+    for (size_t i = list.starts.size() - 1; i > 0; --i) {
+        list.starts[i] = list.starts[i - 1];
+    }
+    list.starts[0] = 0;
 
-    if (pixel_end_scr.x < 0 || pixel_end_scr.y < 0 
-        || pixel_begin_scr.x > g_city_view.viewport.size_pixels.x
-        || pixel_begin_scr.y > g_city_view.viewport.size_pixels.y) {
+    for (size_t i = 0; i + 1 < list.starts.size(); ++i) {
+        std::sort(list.figures.begin() + list.starts[i], list.figures.begin() + list.starts[i + 1], [] (figure *lhs, figure *rhs) {
+            return lhs->cached_pos.y < rhs->cached_pos.y;
+        });
+    }
+}
+
+custom_span<figure *> map_figures_to_draw(vec2i pixel) {
+    auto &list = g_figure_draw_list;
+    const int slot = list.slot_at(list.row_of(pixel.y), list.column_of(pixel.x));
+    if (slot < 0 || list.figures.empty()) {
         return custom_span<figure *>(nullptr, 0);
     }
 
-    auto begin = std::lower_bound(g_figures_y_sort.begin(), g_figures_y_sort.end(), pixel_begin.y, [](const figure *f, int y) {
-        return f->cached_pos.y < y;
-    });
+    return custom_span<figure *>(list.figures.data() + list.starts[slot], list.starts[slot + 1] - list.starts[slot]);
+}
 
-    if (begin == g_figures_y_sort.end()) {
+custom_span<figure *> map_figures_around(vec2i pixel) {
+    auto &list = g_figure_draw_list;
+    list.scratch.clear();
+    if (!map_figure_row_visible(pixel)) {
         return custom_span<figure *>(nullptr, 0);
     }
 
-    auto end = std::lower_bound(g_figures_y_sort.begin(), g_figures_y_sort.end(), pixel_end.y, [](const figure *f, int y) {
-        return f->cached_pos.y < y;
-    });
+    // a figure inside of this tile band is bucketed at most one row above or below
+    // and two tiles to either side
+    const int row = list.row_of(pixel.y);
+    const int column = list.column_of(pixel.x);
+    for (int r = row - 1; r <= row + 1; ++r) {
+        for (int c = column - 4; c <= column + 4; ++c) {
+            const int slot = list.slot_at(r, c);
+            if (slot < 0) {
+                continue;
+            }
 
-    if (end == g_figures_y_sort.end()) {
-        custom_span<figure *>(begin, g_figures_y_sort.end());
+            for (uint32_t i = list.starts[slot]; i < list.starts[slot + 1]; ++i) {
+                figure *f = list.figures[i];
+                if (f->cached_pos.y >= pixel.y && f->cached_pos.y < pixel.y + TILE_HEIGHT_PIXELS
+                    && std::abs(f->cached_pos.x - pixel.x) <= TILE_WIDTH_PIXELS) {
+                    list.scratch.push_back(f);
+                }
+            }
+        }
     }
 
-    return custom_span<figure*>(begin, end);
+    std::sort(list.scratch.begin(), list.scratch.end(), [] (figure *lhs, figure *rhs) {
+        return lhs->cached_pos.y < rhs->cached_pos.y;
+    });
+    return custom_span<figure *>(list.scratch.data(), list.scratch.size());
 }
 
 void map_figure_set(int grid_offset, int id) {
@@ -34,6 +34,11 @@ int map_figure_foreach_until(int grid_offset, int test);
 inline int map_figure_foreach_until(tile2i tile, int test) { return map_figure_foreach_until(tile.grid_offset(), test); }
 
 void map_figure_clear();
-void map_figure_sort_by_y();
 
-custom_span<figure *> map_figures_in_row(tile2i tile);
+struct painter;
+// rebuilds the per frame figure draw list, after the tile pixel coords are recorded
+void map_figure_build_draw_list(painter &ctx);
+// figures drawn by the visible tile at pixel, in y order
+custom_span<figure *> map_figures_to_draw(vec2i pixel);
+// all figures within the draw range of the tile at pixel, for tiles that redraw figures over themselves
+custom_span<figure *> map_figures_around(vec2i pixel);
@@ -11,6 +11,7 @@
 #include "grid/property.h"
 #include "grid/image.h"
 #include "grid/random.h"
+#include "grid/road_network.h"
 #include "city/city_floods.h"
 #include "grid/building.h"
 #include "core/calc.h"
@@ -156,6 +157,7 @@ static void map_floodplain_update_inundation_row(int floodplain_is_flooding, int
         if (map_terrain_is(grid_offset, TERRAIN_ROAD)) {
             map_terrain_remove(grid_offset, TERRAIN_ROAD);
             map_terrain_add(grid_offset, TERRAIN_SUBMERGED_ROAD);
+            map_road_network_rescan();
         }
 
     } else if (floodplain_is_flooding == -1) { // tile is RESURFACING
@@ -182,6 +184,7 @@ static void map_floodplain_update_inundation_row(int floodplain_is_flooding, int
         if (map_terrain_is(grid_offset, TERRAIN_SUBMERGED_ROAD)) {
             map_terrain_remove(grid_offset, TERRAIN_SUBMERGED_ROAD);
             map_terrain_add(grid_offset, TERRAIN_ROAD);
+            map_road_network_rescan();
         } else {
             int fertility_value = map_get_fertility(grid_offset, FERT_WITH_MALUS);
             int fertility_index = std::clamp(fertility_value / 25, 0, 3);
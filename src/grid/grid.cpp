@@ -194,32 +194,8 @@ void map_grid_save_buffer(grid_xx& grid, buffer* buf) {
         map_grid_init(grid);
     }
 
-    switch (grid.datatype) {
-    case FS_UINT8:
-        buf->write_raw(grid.items_xx, GRID_SIZE_TOTAL);
-        break;
-    case FS_INT8:
-        buf->write_raw(grid.items_xx, GRID_SIZE_TOTAL);
-        break;
-    case FS_UINT16:
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            buf->write_u16(((uint16_t*)grid.items_xx)[i]);
-        break;
-    case FS_INT16:
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            buf->write_i16(((int16_t*)grid.items_xx)[i]);
-        break;
-    case FS_UINT32:
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            buf->write_u32(((uint32_t*)grid.items_xx)[i]);
-        break;
-    case FS_INT32:
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            buf->write_i32(((int32_t*)grid.items_xx)[i]);
-        break;
-    default:
-        assert(false);
-    }
+    assert(grid.size_field == 1 || grid.size_field == 2 || grid.size_field == 4);
+    buf->write_array(grid.items_xx, GRID_SIZE_TOTAL, grid.size_field);
 }
 
 void map_grid_load_buffer(grid_xx& grid, buffer* buf) {
@@ -227,42 +203,8 @@ void map_grid_load_buffer(grid_xx& grid, buffer* buf) {
         map_grid_init(grid);
     }
 
-    switch (grid.datatype) {
-    case FS_UINT8:
-        buf->read_raw(grid.items_xx, GRID_SIZE_TOTAL);
-        break;
-    case FS_INT8:
-        buf->read_raw(grid.items_xx, GRID_SIZE_TOTAL);
-        break;
-    case FS_UINT16: {
-        uint16_t* dr_data = (uint16_t*)grid.items_xx;
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            dr_data[i] = buf->read_u16();
-        break;
-    }
-    case FS_INT16: {
-        int16_t* dr_data = (int16_t*)grid.items_xx;
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            dr_data[i] = buf->read_i16();
-        break;
-    }
-    case FS_UINT32: {
-        uint32_t* dr_data = (uint32_t*)grid.items_xx;
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            dr_data[i] = buf->read_u32();
-        break;
-    }
-    case FS_INT32: {
-        int32_t* dr_data = (int32_t*)grid.items_xx;
-        for (int i = 0; i < GRID_SIZE_TOTAL; i++)
-            dr_data[i] = buf->read_i32();
-        break;
-    }
-
-    default:
-        assert(false);
-    }
-    return;
+    assert(grid.size_field == 1 || grid.size_field == 2 || grid.size_field == 4);
+    buf->read_array(grid.items_xx, GRID_SIZE_TOTAL, grid.size_field);
 }
 
 bool map_grid_is_valid_offset(int grid_offset) {
@@ -3,6 +3,7 @@
 #include "graphics/animation.h"
 #include "io/io_buffer.h"
 #include "grid/grid.h"
+#include "widget/city/terrain_chunks.h"
 #include "image.h"
 
 grid_xx g_images_grid = {0, FS_UINT32};
@@ -20,11 +21,13 @@ int map_image_alt_at(int grid_offset) {
 
 void map_image_set(int grid_offset, int image_id) {
     map_grid_set(g_images_grid, grid_offset, image_id);
+    g_terrain_chunks.mark_dirty(grid_offset);
 }
 
 void map_image_set(tile2i tile, const animation_t &anim) {
     int image_id = image_id_from_group(anim.pack, anim.iid) + anim.offset;
     map_grid_set(g_images_grid, tile.grid_offset(), image_id);
+    g_terrain_chunks.mark_dirty(tile.grid_offset());
 }
 
 void map_image_alt_set(int grid_offset, int image_id, int alpha) {
@@ -37,6 +40,7 @@ void map_image_alt_set(int grid_offset, int image_id, int alpha) {
     }
     uint32_t value = (image_id & 0x00ffffff) | (((uint32_t)alpha) << 24);
     map_grid_set(g_images_alt_grid, grid_offset, value);
+    g_terrain_chunks.mark_dirty(grid_offset);
 }
 
 void map_image_backup() {
@@ -44,9 +48,11 @@ void map_image_backup() {
 }
 void map_image_restore() {
     map_grid_copy(g_images_grid_backup, g_images_grid);
+    g_terrain_chunks.invalidate();
 }
 void map_image_restore_at(int grid_offset) {
     map_grid_set(g_images_grid, grid_offset, map_grid_get(g_images_grid_backup, grid_offset));
+    g_terrain_chunks.mark_dirty(grid_offset);
 }
 
 void map_image_fix_icorrect_tiles() {
@@ -56,6 +62,7 @@ void map_image_fix_icorrect_tiles() {
 void map_image_clear(void) {
     map_grid_clear(g_images_grid);
     map_grid_clear(g_images_alt_grid);
+    g_terrain_chunks.invalidate();
 }
 
 void map_image_init_edges() {
@@ -71,6 +78,7 @@ void map_image_init_edges() {
     map_grid_set(g_images_grid, MAP_OFFSET(0, height), 3);
     map_grid_set(g_images_grid, MAP_OFFSET(width, 0), 4);
     map_grid_set(g_images_grid, MAP_OFFSET(width, height), 5);
+    g_terrain_chunks.invalidate();
 }
 
 static int image_shift = 0;
@@ -95,6 +103,7 @@ void io_image_grid::fix_incorrect_tiles_img() {
         nv = fix_img_index(grid_offset, nv);
         map_grid_set(g_images_grid, grid_offset, nv);
     }
+    g_terrain_chunks.invalidate();
 }
 
 void io_image_grid::bind_data(size_t version) {
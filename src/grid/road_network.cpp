@@ -7,18 +7,56 @@
 #include "grid/terrain.h"
 #include "scenario/map.h"
 
-#include <string.h>
-
-#define MAX_ROAD_QUEUE 1000
+#include <vector>
 
 static const int ADJACENT_OFFSETS_PH[] = {-GRID_LENGTH, 1, GRID_LENGTH, -1};
 
-static grid_xx network = {0, FS_UINT8};
+static grid_xx network = {0, FS_UINT16};
 
+// Road tiles are kept in disjoint sets which are merged when a road appears and
+// split again (by a local flood over the old set only) when a road disappears.
+// Every set keeps its tiles in a circular list, merging relabels the smaller set,
+// so the network grid always holds the final id and lookups stay a single read.
+// Tiles are queued by the citizen routing update when their state changes, so a
+// tick only touches those. The whole map is classified again after a clear and
+// whenever roads change without that update (road images recalculated, undo,
+// floods, load); only tiles whose state differs are relabelled.
 struct grid_road_network_t {
-    int items[MAX_ROAD_QUEUE];
-    int head;
-    int tail;
+    enum {
+        STATE_MEMBER = 1,
+        STATE_ROAD = 2,
+        STATE_QUEUED = 4,
+    };
+
+    struct network_t {
+        int head = -1;
+        int size = 0;
+        int roads = 0;
+        bool broken = false;
+    };
+
+    std::vector<uint8_t> state;
+    std::vector<int> next;
+    std::vector<network_t> networks;
+    std::vector<uint16_t> free_ids;
+    std::vector<int> removed;
+    std::vector<int> added;
+    std::vector<int> toggled;
+    std::vector<int> pending;
+    std::vector<uint16_t> broken;
+    std::vector<int> changed;
+    vec2i map_size = {0, 0};
+    bool rescan = true;
+
+    void reset();
+    void classify(int grid_offset, uint8_t new_state);
+    uint16_t alloc_id();
+    void release_id(uint16_t id);
+    void relabel(uint16_t from, uint16_t to);
+    void merge(uint16_t a, uint16_t b);
+    void add_tile(int grid_offset);
+    void rebuild(uint16_t id);
+    void flood(int grid_offset, uint16_t id);
 };
 
 grid_road_network_t grid_road_network;
@@ -27,67 +65,275 @@ int adjacent_offsets(int i) {
     return ADJACENT_OFFSETS_PH[i];
 }
 
-void map_road_network_clear() {
-    map_grid_clear(network);
+static uint16_t network_at(int grid_offset) {
+    return (uint16_t)map_grid_get(network, grid_offset);
 }
 
-int map_road_network_get(int grid_offset) {
-    return map_grid_get(network, grid_offset);
+void grid_road_network_t::reset() {
+    state.assign(GRID_SIZE_TOTAL, 0);
+    next.assign(GRID_SIZE_TOTAL, -1);
+    networks.assign(1, network_t{}); // id 0 is "no network"
+    free_ids.clear();
+    changed.clear();
+    rescan = true;
+}
+
+uint16_t grid_road_network_t::alloc_id() {
+    if (!free_ids.empty()) {
+        uint16_t id = free_ids.back();
+        free_ids.pop_back();
+        networks[id] = network_t{};
+        return id;
+    }
+
+    networks.push_back(network_t{});
+    return (uint16_t)(networks.size() - 1);
 }
 
-static int mark_road_network(int grid_offset, uint8_t network_id) {
-    memset(&grid_road_network, 0, sizeof(grid_road_network));
-    int guard = 0;
-    int next_offset;
-    int size = 1;
+void grid_road_network_t::release_id(uint16_t id) {
+    networks[id] = network_t{};
+    free_ids.push_back(id);
+}
+
+void grid_road_network_t::relabel(uint16_t from, uint16_t to) {
+    const int head = networks[from].head;
+    int grid_offset = head;
     do {
-        if (++guard >= GRID_SIZE_TOTAL)
-            break;
+        map_grid_set(network, grid_offset, to);
+        grid_offset = next[grid_offset];
+    } while (grid_offset != head);
+}
+
+void grid_road_network_t::merge(uint16_t a, uint16_t b) {
+    if (networks[a].size < networks[b].size) {
+        std::swap(a, b);
+    }
+
+    relabel(b, a);
+
+    // splice the two circular lists
+    network_t &big = networks[a];
+    network_t &small = networks[b];
+    std::swap(next[big.head], next[small.head]);
+    big.size += small.size;
+    big.roads += small.roads;
+    big.broken |= small.broken;
+    release_id(b);
+}
+
+void grid_road_network_t::add_tile(int grid_offset) {
+    uint16_t id = alloc_id();
+    network_t &net = networks[id];
+    net.head = grid_offset;
+    net.size = 1;
+    net.roads = (state[grid_offset] & STATE_ROAD) ? 1 : 0;
+    next[grid_offset] = grid_offset;
+    map_grid_set(network, grid_offset, id);
+
+    for (int i = 0; i < 4; i++) {
+        const int adjacent = grid_offset + adjacent_offsets(i);
+        if (!map_grid_is_valid_offset(adjacent) || !(state[adjacent] & STATE_MEMBER)) {
+            continue;
+        }
+
+        const uint16_t other = network_at(adjacent);
+        const uint16_t own = network_at(grid_offset);
+        if (other && other != own) {
+            merge(own, other);
+        }
+    }
+}
+
+void grid_road_network_t::flood(int grid_offset, uint16_t id) {
+    network_t &net = networks[id];
+    pending.clear();
+    pending.push_back(grid_offset);
+    map_grid_set(network, grid_offset, id);
+    while (!pending.empty()) {
+        const int current = pending.back();
+        pending.pop_back();
+
+        if (net.head < 0) {
+            net.head = current;
+            next[current] = current;
+        } else {
+            next[current] = next[net.head];
+            next[net.head] = current;
+        }
+        net.size++;
+        net.roads += (state[current] & STATE_ROAD) ? 1 : 0;
 
-        map_grid_set(network, grid_offset, network_id);
-        next_offset = -1;
         for (int i = 0; i < 4; i++) {
-            int new_offset = grid_offset + adjacent_offsets(i);
-            if (map_routing_citizen_is_passable(new_offset) && !map_grid_get(network, new_offset)) {
-                if (map_routing_citizen_is_road(new_offset) || map_terrain_is(new_offset, TERRAIN_ACCESS_RAMP)) {
-                    map_grid_set(network, new_offset, network_id);
-                    size++;
-                    if (next_offset == -1)
-                        next_offset = new_offset;
-                    else {
-                        grid_road_network.items[grid_road_network.tail++] = new_offset;
-                        if (grid_road_network.tail >= MAX_ROAD_QUEUE)
-                            grid_road_network.tail = 0;
-                    }
-                }
+            const int adjacent = current + adjacent_offsets(i);
+            if (map_grid_is_valid_offset(adjacent) && (state[adjacent] & STATE_MEMBER) && !network_at(adjacent)) {
+                map_grid_set(network, adjacent, id);
+                pending.push_back(adjacent);
             }
         }
-        if (next_offset == -1) {
-            if (grid_road_network.head == grid_road_network.tail)
-                return size;
+    }
+}
+
+void grid_road_network_t::rebuild(uint16_t id) {
+    // unlabel the whole old set, removed tiles are still linked in
+    std::vector<int> tiles;
+    tiles.reserve(networks[id].size);
+    const int head = networks[id].head;
+    int grid_offset = head;
+    do {
+        const int following = next[grid_offset];
+        map_grid_set(network, grid_offset, 0);
+        next[grid_offset] = -1;
+        if (state[grid_offset] & STATE_MEMBER) {
+            tiles.push_back(grid_offset);
+        }
+        grid_offset = following;
+    } while (grid_offset != head);
+    release_id(id);
 
-            next_offset = grid_road_network.items[grid_road_network.head++];
-            if (grid_road_network.head >= MAX_ROAD_QUEUE)
-                grid_road_network.head = 0;
+    for (int tile : tiles) {
+        if (!network_at(tile)) {
+            flood(tile, alloc_id());
         }
-        grid_offset = next_offset;
-    } while (next_offset > -1);
-    return size;
+    }
+}
+
+static bool is_road_network_tile(int grid_offset) {
+    if (map_terrain_is(grid_offset, TERRAIN_ROAD)) {
+        return true;
+    }
+
+    return map_routing_citizen_is_passable(grid_offset)
+            && (map_routing_citizen_is_road(grid_offset) || map_terrain_is(grid_offset, TERRAIN_ACCESS_RAMP));
+}
+
+static uint8_t road_network_state(int grid_offset) {
+    if (!is_road_network_tile(grid_offset)) {
+        return 0;
+    }
+
+    uint8_t state = grid_road_network_t::STATE_MEMBER;
+    state |= map_terrain_is(grid_offset, TERRAIN_ROAD) ? grid_road_network_t::STATE_ROAD : 0;
+    return state;
+}
+
+void grid_road_network_t::classify(int grid_offset, uint8_t new_state) {
+    const uint8_t old_state = state[grid_offset] & (STATE_MEMBER | STATE_ROAD);
+    if (new_state == old_state) {
+        return;
+    }
+
+    const bool was_member = (old_state & STATE_MEMBER);
+    const bool is_member = (new_state & STATE_MEMBER);
+    if (was_member && !is_member) {
+        removed.push_back(grid_offset);
+    } else if (!was_member && is_member) {
+        added.push_back(grid_offset);
+    } else {
+        toggled.push_back(grid_offset);
+    }
+}
+
+void map_road_network_update_tile(int grid_offset) {
+    auto &data = grid_road_network;
+    if (data.rescan || data.state.empty() || (data.state[grid_offset] & grid_road_network_t::STATE_QUEUED)) {
+        return;
+    }
+
+    if (road_network_state(grid_offset) != (data.state[grid_offset] & (grid_road_network_t::STATE_MEMBER | grid_road_network_t::STATE_ROAD))) {
+        data.state[grid_offset] |= grid_road_network_t::STATE_QUEUED;
+        data.changed.push_back(grid_offset);
+    }
+}
+
+void map_road_network_rescan() {
+    grid_road_network.rescan = true;
+}
+
+void map_road_network_clear() {
+    map_grid_clear(network);
+    grid_road_network.reset();
+}
+
+int map_road_network_get(int grid_offset) {
+    const uint16_t id = network_at(grid_offset);
+    if (!id || id >= grid_road_network.networks.size()) {
+        return 0;
+    }
+
+    // networks made only of ramps or road-like building tiles are not road networks
+    return grid_road_network.networks[id].roads > 0 ? id : 0;
 }
 
 void city_map_t::update_road_network() {
     OZZY_PROFILER_SECTION("Game/Run/Tick/Road Network Update");
-    g_city.map.clear_largest_road_networks();
-    map_grid_clear(network);
-    int network_id = 1;
-    int grid_offset = scenario_map_data()->start_offset;
-    for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
-        for (int x = 0; x < scenario_map_data()->width; x++, grid_offset++) {
-            if (map_terrain_is(grid_offset, TERRAIN_ROAD) && !map_grid_get(network, grid_offset)) {
-                int size = mark_road_network(grid_offset, network_id);
-                g_city.map.add_to_largest_road_networks(network_id, size);
-                network_id++;
+    auto &data = grid_road_network;
+    const vec2i map_size(scenario_map_data()->width, scenario_map_data()->height);
+    if (data.state.empty() || data.map_size != map_size) {
+        map_road_network_clear();
+        data.map_size = map_size;
+    }
+
+    data.removed.clear();
+    data.added.clear();
+    data.toggled.clear();
+    data.broken.clear();
+
+    for (int tile : data.changed) {
+        data.state[tile] &= ~grid_road_network_t::STATE_QUEUED;
+    }
+
+    if (data.rescan) {
+        int grid_offset = scenario_map_data()->start_offset;
+        for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
+            for (int x = 0; x < scenario_map_data()->width; x++, grid_offset++) {
+                data.classify(grid_offset, road_network_state(grid_offset));
             }
         }
+        data.rescan = false;
+    } else {
+        for (int tile : data.changed) {
+            data.classify(tile, road_network_state(tile));
+        }
+    }
+    data.changed.clear();
+
+    if (data.removed.empty() && data.added.empty() && data.toggled.empty()) {
+        return;
+    }
+
+    // removals may split a set: only sets which lost tiles are flooded again
+    for (int tile : data.removed) {
+        data.state[tile] = 0;
+        const uint16_t id = network_at(tile);
+        if (id && !data.networks[id].broken) {
+            data.networks[id].broken = true;
+            data.broken.push_back(id);
+        }
+    }
+
+    for (int tile : data.toggled) {
+        data.state[tile] ^= grid_road_network_t::STATE_ROAD;
+        auto &net = data.networks[network_at(tile)];
+        if (!net.broken) {
+            net.roads += (data.state[tile] & grid_road_network_t::STATE_ROAD) ? 1 : -1;
+        }
+    }
+
+    for (uint16_t id : data.broken) {
+        data.rebuild(id);
+    }
+
+    for (int tile : data.added) {
+        data.state[tile] = grid_road_network_t::STATE_MEMBER;
+        data.state[tile] |= map_terrain_is(tile, TERRAIN_ROAD) ? grid_road_network_t::STATE_ROAD : 0;
+        data.add_tile(tile);
+    }
+
+    g_city.map.clear_largest_road_networks();
+    for (int id = 1, count = (int)data.networks.size(); id < count; id++) {
+        const auto &net = data.networks[id];
+        if (net.size > 0 && net.roads > 0) {
+            g_city.map.add_to_largest_road_networks(id, net.size);
+        }
     }
 }
@@ -3,6 +3,9 @@
 #include "grid/point.h"
 
 void map_road_network_clear();
+void map_road_network_update_tile(int grid_offset);
+// terrain changed outside the citizen routing update, the next update classifies every tile again
+void map_road_network_rescan();
 
 int map_road_network_get(int grid_offset);
 
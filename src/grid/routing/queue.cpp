@@ -1,6 +1,8 @@
 #include "queue.h"
 #include "routing_grids.h"
 
+#include <memory>
+
 #define GUARD 50000
 
 // static const int ROUTE_OFFSETS[2][8] = {
@@ -33,31 +35,56 @@ static int ROUTE_OFFSETS(int i) {
     }
 }
 
-struct grid_rounting_t {
-    int head;
-    int tail;
-    int items[MAX_QUEUE];
+grid_rounting_t g_grid_rounting = {&routing_distance, false};
+
+struct grid_rounting_local_t {
+    grid_xx distance = {0, FS_INT16};
+    grid_rounting_t queue;
 };
 
-grid_rounting_t g_grid_rounting;
+static thread_local std::unique_ptr<grid_rounting_local_t> g_grid_rounting_local;
+static thread_local grid_rounting_t *g_grid_rounting_current = nullptr;
+
+grid_rounting_t &routing_queue() {
+    return g_grid_rounting_current ? *g_grid_rounting_current : g_grid_rounting;
+}
+
+grid_xx &routing_distances() {
+    return *routing_queue().distance;
+}
+
+void routing_use_local_buffers(bool enable) {
+    if (!enable) {
+        g_grid_rounting_current = nullptr;
+        return;
+    }
+
+    if (!g_grid_rounting_local) {
+        g_grid_rounting_local = std::make_unique<grid_rounting_local_t>();
+        g_grid_rounting_local->queue.distance = &g_grid_rounting_local->distance;
+        g_grid_rounting_local->queue.local = true;
+    }
+    g_grid_rounting_current = &g_grid_rounting_local->queue;
+}
 
 void clear_distances(void) {
-    map_grid_clear(routing_distance);
+    map_grid_clear(routing_distances());
 }
 
 int valid_offset(int grid_offset) {
-    return map_grid_is_valid_offset(grid_offset) && map_grid_get(routing_distance, grid_offset) == 0
+    return map_grid_is_valid_offset(grid_offset) && map_grid_get(routing_distances(), grid_offset) == 0
            && map_grid_inside_map_area(grid_offset, 1);
 }
 
 void enqueue(int offset, int distance) {
-    map_grid_set(routing_distance, offset, distance);
-    g_grid_rounting.items[g_grid_rounting.tail++] = offset;
-    if (g_grid_rounting.tail >= MAX_QUEUE)
-        g_grid_rounting.tail = 0;
+    auto &queue = routing_queue();
+    map_grid_set(*queue.distance, offset, distance);
+    queue.items[queue.tail++] = offset;
+    if (queue.tail >= MAX_QUEUE)
+        queue.tail = 0;
 }
 void route_queue(int source, int dest, void (*callback)(int next_offset, int distance)) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
@@ -65,7 +92,7 @@ void route_queue(int source, int dest, void (*callback)(int next_offset, int dis
         int offset = queue.items[queue.head];
         if (offset == dest)
             break;
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + map_grid_get(*queue.distance, offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i)))
                 callback(offset + ROUTE_OFFSETS(i), distance);
@@ -75,13 +102,13 @@ void route_queue(int source, int dest, void (*callback)(int next_offset, int dis
     }
 }
 void route_queue_until(int source, bool (*callback)(int next_offset, int distance)) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
     while (queue.head != queue.tail) {
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + map_grid_get(*queue.distance, offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i))) {
                 if (!callback(offset + ROUTE_OFFSETS(i), distance))
@@ -93,13 +120,13 @@ void route_queue_until(int source, bool (*callback)(int next_offset, int distanc
     }
 }
 bool route_queue_until_found(int source, tile2i &dst, bool (*callback)(int, int)) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
     while (queue.head != queue.tail) {
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + map_grid_get(*queue.distance, offset);
         for (int i = 0; i < 4; i++) {
             int next_offset = offset + ROUTE_OFFSETS(i);
             if (valid_offset(next_offset)) {
@@ -116,13 +143,13 @@ bool route_queue_until_found(int source, tile2i &dst, bool (*callback)(int, int)
     return false;
 }
 bool route_queue_until_terrain(int source, int terrain_type, tile2i* dst, bool (*callback)(int, int, int)) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
     while (queue.head != queue.tail) {
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + map_grid_get(*queue.distance, offset);
         for (int i = 0; i < 4; i++) {
             int next_offset = offset + ROUTE_OFFSETS(i);
             if (valid_offset(next_offset)) {
@@ -145,7 +172,7 @@ bool route_queue_until_terrain(int source, int terrain_type, tile2i* dst, bool (
     return false;
 }
 void route_queue_max(int source, int dest, int max_tiles, void (*callback)(int, int)) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
@@ -156,7 +183,7 @@ void route_queue_max(int source, int dest, int max_tiles, void (*callback)(int,
             break;
         if (++tiles > max_tiles)
             break;
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + map_grid_get(*queue.distance, offset);
         for (int i = 0; i < 4; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i)))
                 callback(offset + ROUTE_OFFSETS(i), distance);
@@ -167,7 +194,7 @@ void route_queue_max(int source, int dest, int max_tiles, void (*callback)(int,
 }
 
 void route_queue_boat(int source, void (*callback)(int, int)) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     clear_distances();
     map_grid_clear(water_drag);
     queue.head = queue.tail = 0;
@@ -185,7 +212,7 @@ void route_queue_boat(int source, void (*callback)(int, int)) {
             if (queue.tail >= MAX_QUEUE)
                 queue.tail = 0;
         } else {
-            int distance = 1 + map_grid_get(routing_distance, offset);
+            int distance = 1 + map_grid_get(*queue.distance, offset);
             for (int i = 0; i < 4; i++) {
                 if (valid_offset(offset + ROUTE_OFFSETS(i)))
                     callback(offset + ROUTE_OFFSETS(i), distance);
@@ -197,7 +224,7 @@ void route_queue_boat(int source, void (*callback)(int, int)) {
     }
 }
 void route_queue_dir8(int source, void (*callback)(int, int)) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     clear_distances();
     queue.head = queue.tail = 0;
     enqueue(source, 1);
@@ -206,7 +233,7 @@ void route_queue_dir8(int source, void (*callback)(int, int)) {
         if (++tiles > GUARD)
             break;
         int offset = queue.items[queue.head];
-        int distance = 1 + map_grid_get(routing_distance, offset);
+        int distance = 1 + map_grid_get(*queue.distance, offset);
         for (int i = 0; i < 8; i++) {
             if (valid_offset(offset + ROUTE_OFFSETS(i)))
                 callback(offset + ROUTE_OFFSETS(i), distance);
@@ -217,14 +244,14 @@ void route_queue_dir8(int source, void (*callback)(int, int)) {
 }
 
 bool queue_has(int offset) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     for (int i = 0; i < MAX_QUEUE; i++)
         if (queue.items[i] == offset)
             return true;
     return false;
 }
 int queue_get(int i) {
-    auto &queue = g_grid_rounting;
+    auto &queue = routing_queue();
     if (i < 0 || i >= MAX_QUEUE)
         return -1;
     return queue.items[i];
@@ -4,6 +4,23 @@
 
 #define MAX_QUEUE GRID_SIZE_TOTAL
 
+struct grid_rounting_t {
+    grid_xx *distance;
+    bool local;
+    int head;
+    int tail;
+    int through_building_id;
+    int total_routes;
+    int enemy_routes;
+    int items[MAX_QUEUE];
+};
+
+// queue and distance grid of the calling thread: the shared ones on the main thread,
+// own buffers on threads which called routing_use_local_buffers(true)
+grid_rounting_t &routing_queue();
+grid_xx &routing_distances();
+void routing_use_local_buffers(bool enable);
+
 void clear_distances(void);
 int valid_offset(int grid_offset);
 
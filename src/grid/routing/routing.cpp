@@ -5,7 +5,9 @@
 #include "grid/vegetation.h"
 #include "building/building.h"
 #include "city/city_buildings.h"
+#include "core/calc.h"
 #include "core/profiler.h"
+#include "dev/debug.h"
 #include "grid/building.h"
 #include "grid/figure.h"
 #include "grid/grid.h"
@@ -14,8 +16,11 @@
 #include "grid/water.h"
 #include "queue.h"
 #include "routing_grids.h"
+#include "scenario/map.h"
 
+#include <array>
 #include <cmath>
+#include <vector>
 
 struct routing_stats_t {
     int total_routes_calculated;
@@ -23,12 +28,33 @@ struct routing_stats_t {
 };
 
 routing_stats_t g_routing_stats = {0, 0};
+uint32_t g_routing_version = 0;
+
+// searches on worker threads keep their counts local, the caller adds them when it uses the result
+static void count_route(bool enemy) {
+    auto &queue = routing_queue();
+    if (queue.local) {
+        ++queue.total_routes;
+        queue.enemy_routes += enemy ? 1 : 0;
+        return;
+    }
 
-struct routing_state_data_t {
-    int through_building_id;
-};
+    ++g_routing_stats.total_routes_calculated;
+    g_routing_stats.enemy_routes_calculated += enemy ? 1 : 0;
+}
+
+void map_routing_add_stats(int total_routes, int enemy_routes) {
+    g_routing_stats.total_routes_calculated += total_routes;
+    g_routing_stats.enemy_routes_calculated += enemy_routes;
+}
 
-routing_state_data_t g_routing_state_data;
+void map_routing_version_bump() {
+    ++g_routing_version;
+}
+
+uint32_t map_routing_version() {
+    return g_routing_version;
+}
 
 static bool can_place_on_crossing_no_neighboring(int grid_offset, int terrain_underneath, int terrain_to_avoid, int d_x, int d_y, bool adjacent) {
     // this is similar to the way Pharaoh does it... it only allows to build in alternating rows/columns
@@ -80,7 +106,7 @@ static void callback_calc_distance(int next_offset, int dist) {
 }
 
 void map_routing_calculate_distances(tile2i tile) {
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     route_queue(tile.grid_offset(), -1, callback_calc_distance);
 }
 
@@ -89,9 +115,9 @@ static void callback_calc_distance_water_boat(int next_offset, int dist) {
         && map_grid_get(routing_tiles_water, next_offset) != WATER_N3_LOW_BRIDGE) {
         enqueue(next_offset, dist);
         if (map_grid_get(routing_tiles_water, next_offset) == WATER_N2_MAP_EDGE) {
-            int v = map_grid_get(routing_distance, next_offset);
+            int v = map_grid_get(routing_distances(), next_offset);
             //            safe_i16(routing_distance)->items[next_offset] += 4;
-            map_grid_set(routing_distance, next_offset, v + 4);
+            map_grid_set(routing_distances(), next_offset, v + 4);
         }
     }
 }
@@ -295,7 +321,7 @@ bool map_routing_calculate_distances_for_building(e_routed_mode type, tile2i til
     default:
         assert(false);
     }
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     return true;
 }
 
@@ -312,7 +338,7 @@ static bool callback_delete_wall_canal(int next_offset, int dist) {
 }
 
 void map_routing_delete_first_wall_or_aqueduct(int x, int y) {
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     route_queue_until(MAP_OFFSET(x, y), callback_delete_wall_canal);
 }
 
@@ -344,7 +370,7 @@ static bool callback_travel_found_terrain(int next_offset, int dist, int terrain
 
 bool map_routing_citizen_found_terrain(tile2i src, tile2i *dst, int terrain_type) {
     int src_offset = src.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     return route_queue_until_terrain(src_offset, terrain_type, dst, callback_travel_found_terrain);
 }
 
@@ -364,7 +390,7 @@ static bool callback_travel_found_reeds(int next_offset, int dist) {
 
 bool map_routing_citizen_found_reeds(tile2i src, tile2i &dst) {
     int src_offset = src.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     return route_queue_until_found(src_offset, dst, callback_travel_found_reeds);
 }
 
@@ -382,7 +408,7 @@ static bool callback_travel_found_timber(int next_offset, int dist) {
 
 bool map_routing_citizen_found_timber(tile2i src, tile2i &dst) {
     int src_offset = src.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     return route_queue_until_found(src_offset, dst, callback_travel_found_timber);
 }
 
@@ -397,9 +423,9 @@ static void callback_travel_citizen_land(int next_offset, int dist) {
 bool map_routing_citizen_can_travel_over_land(tile2i src, tile2i dst) {
     int src_offset = src.grid_offset();
     int dst_offset = dst.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     route_queue(src_offset, dst_offset, callback_travel_citizen_land);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return map_grid_get(routing_distances(), dst_offset) != 0;
 }
 
 static void callback_travel_citizen_road(int next_offset, int dist) {
@@ -411,9 +437,9 @@ static void callback_travel_citizen_road(int next_offset, int dist) {
 bool map_routing_citizen_can_travel_over_road(tile2i src, tile2i dst) {
     int src_offset = src.grid_offset();
     int dst_offset = dst.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     route_queue(src_offset, dst_offset, callback_travel_citizen_road);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return map_grid_get(routing_distances(), dst_offset) != 0;
 }
 
 static void callback_travel_citizen_road_garden(int next_offset, int dist) {
@@ -426,9 +452,9 @@ static void callback_travel_citizen_road_garden(int next_offset, int dist) {
 bool map_routing_citizen_can_travel_over_road_garden(int src_x, int src_y, int dst_x, int dst_y) {
     int src_offset = MAP_OFFSET(src_x, src_y);
     int dst_offset = MAP_OFFSET(dst_x, dst_y);
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     route_queue(src_offset, dst_offset, callback_travel_citizen_road_garden);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return map_grid_get(routing_distances(), dst_offset) != 0;
 }
 static void callback_travel_walls(int next_offset, int dist) {
     if (map_grid_get(routing_tiles_walls, next_offset) >= WALL_0_PASSABLE
@@ -440,9 +466,9 @@ static void callback_travel_walls(int next_offset, int dist) {
 bool map_routing_can_travel_over_walls(int src_x, int src_y, int dst_x, int dst_y) {
     int src_offset = MAP_OFFSET(src_x, src_y);
     int dst_offset = MAP_OFFSET(dst_x, dst_y);
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     route_queue(src_offset, dst_offset, callback_travel_walls);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return map_grid_get(routing_distances(), dst_offset) != 0;
 }
 
 static void callback_travel_noncitizen_land_through_building(int next_offset, int dist) {
@@ -450,7 +476,7 @@ static void callback_travel_noncitizen_land_through_building(int next_offset, in
         if (map_grid_get(routing_land_noncitizen, next_offset) == NONCITIZEN_0_PASSABLE
             || map_grid_get(routing_land_noncitizen, next_offset) == NONCITIZEN_2_CLEARABLE
             || (map_grid_get(routing_land_noncitizen, next_offset) == NONCITIZEN_1_BUILDING
-                && map_building_at(next_offset) == g_routing_state_data.through_building_id)) {
+                && map_building_at(next_offset) == routing_queue().through_building_id)) {
             enqueue(next_offset, dist);
         }
     }
@@ -468,16 +494,15 @@ static void callback_travel_noncitizen_land(int next_offset, int dist) {
 bool map_routing_noncitizen_can_travel_over_land(tile2i src, tile2i dst, int only_through_building_id, int max_tiles) {
     int src_offset = src.grid_offset();
     int dst_offset = dst.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
-    ++g_routing_stats.enemy_routes_calculated;
+    count_route(true);
     if (only_through_building_id) {
-        g_routing_state_data.through_building_id = only_through_building_id;
+        routing_queue().through_building_id = only_through_building_id;
         route_queue(src_offset, dst_offset, callback_travel_noncitizen_land_through_building);
     } else {
         route_queue_max(src_offset, dst_offset, max_tiles, callback_travel_noncitizen_land);
     }
 
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return map_grid_get(routing_distances(), dst_offset) != 0;
 }
 
 static void callback_travel_noncitizen_through_everything(int next_offset, int dist) {
@@ -488,9 +513,351 @@ static void callback_travel_noncitizen_through_everything(int next_offset, int d
 bool map_routing_noncitizen_can_travel_through_everything(tile2i src, tile2i dst) {
     int src_offset = src.grid_offset();
     int dst_offset = dst.grid_offset();
-    ++g_routing_stats.total_routes_calculated;
+    count_route(false);
     route_queue(src_offset, dst_offset, callback_travel_noncitizen_through_everything);
-    return map_grid_get(routing_distance, dst_offset) != 0;
+    return map_grid_get(routing_distances(), dst_offset) != 0;
+}
+
+// Flow fields: distances searched backwards from a destination, so all figures heading for the same
+// tile (enemies, soldiers and herds closing in on a target) share one field and only walk down it.
+// The search only runs as far as the requesting figures need (Dial's bucket queue, settled in
+// distance order). Every tile costs what it takes to get onto it. For enemies that replaces up to
+// three floods with growing permissions: open land costs 1, buildings, walls and gatehouses are
+// broken through at a higher cost and forts cost the most.
+struct route_flow_field_t {
+    enum {
+        COST_OPEN = 1,
+        COST_BUILDING = 4,
+        COST_FORT = 16,
+        NUM_BUCKETS = COST_FORT + 1,
+    };
+
+    int dst_offset = -1;
+    int terrain_usage = -1;
+    int destination_building_id = 0;
+    uint32_t version = 0;
+    uint32_t last_used = 0;
+    int current = 0;
+    int pending = 0;
+    std::vector<uint16_t> distance;
+    std::array<std::vector<int>, NUM_BUCKETS> buckets;
+
+    int cost(int grid_offset) const;
+    void start(int dst, int usage, int building_id, uint32_t v);
+    void push(int grid_offset, int dist);
+    int settle(int src_offset);
+};
+
+int route_flow_field_t::cost(int grid_offset) const {
+    if (terrain_usage == TERRAIN_USAGE_ANIMAL) {
+        const int noncitizen = map_grid_get(routing_land_noncitizen, grid_offset);
+        const bool passable = (noncitizen == NONCITIZEN_0_PASSABLE || noncitizen == NONCITIZEN_2_CLEARABLE);
+        return (passable && !has_fighting_enemy(grid_offset)) ? COST_OPEN : -1;
+    }
+
+    if (terrain_usage != TERRAIN_USAGE_ENEMY) {
+        const bool passable = map_grid_get(routing_land_citizen, grid_offset) >= CITIZEN_0_ROAD
+                                && (!map_terrain_is(grid_offset, TERRAIN_WATER) || map_terrain_is(grid_offset, TERRAIN_FERRY_ROUTE));
+        return (passable && !has_fighting_friendly(grid_offset)) ? COST_OPEN : -1;
+    }
+
+    switch (map_grid_get(routing_land_noncitizen, grid_offset)) {
+    case NONCITIZEN_0_PASSABLE:
+    case NONCITIZEN_2_CLEARABLE:
+        return COST_OPEN;
+
+    case NONCITIZEN_1_BUILDING:
+        return (destination_building_id && map_building_at(grid_offset) == destination_building_id) ? COST_OPEN : COST_BUILDING;
+
+    case NONCITIZEN_3_WALL:
+    case NONCITIZEN_4_GATEHOUSE:
+        return COST_BUILDING;
+
+    case NONCITIZEN_5_FORT:
+        return COST_FORT;
+    }
+
+    return -1;
+}
+
+void route_flow_field_t::start(int dst, int usage, int building_id, uint32_t v) {
+    dst_offset = dst;
+    terrain_usage = usage;
+    destination_building_id = building_id;
+    version = v;
+    distance.assign(GRID_SIZE_TOTAL, 0);
+    for (auto &bucket : buckets) {
+        bucket.clear();
+    }
+    pending = 0;
+    current = 1;
+    push(dst, 1);
+}
+
+void route_flow_field_t::push(int grid_offset, int dist) {
+    distance[grid_offset] = dist;
+    buckets[dist % NUM_BUCKETS].push_back(grid_offset);
+    pending++;
+}
+
+// returns the distance of the source once it is final, 0 when it can't be reached
+int route_flow_field_t::settle(int src_offset) {
+    while (pending > 0) {
+        const int known = distance[src_offset];
+        if (known > 0 && known < current) {
+            return known;
+        }
+
+        auto &bucket = buckets[current % NUM_BUCKETS];
+        for (size_t i = 0; i < bucket.size(); i++) {
+            const int offset = bucket[i];
+            pending--;
+            if (distance[offset] != current) {
+                continue; // reached again later with a shorter distance
+            }
+
+            // moving backwards: the neighbour steps onto this tile
+            const int step_cost = cost(offset);
+            const int next_dist = current + std::max<int>(step_cost, COST_OPEN);
+            if (next_dist >= UINT16_MAX) {
+                continue;
+            }
+
+            for (int d = 0; d < 8; d += 2) {
+                const int next_offset = offset + map_grid_direction_delta(d);
+                if (!map_grid_is_valid_offset(next_offset) || !map_grid_inside_map_area(next_offset, 1)) {
+                    continue;
+                }
+
+                if (cost(next_offset) < 0) {
+                    continue;
+                }
+
+                const int known_next = distance[next_offset];
+                if (known_next == 0 || next_dist < known_next) {
+                    push(next_offset, next_dist);
+                }
+            }
+        }
+        bucket.clear();
+        current++;
+    }
+
+    return distance[src_offset];
+}
+
+struct route_flow_fields_t {
+    enum { MAX_FIELDS = 8 };
+    std::array<route_flow_field_t, MAX_FIELDS> fields;
+    uint32_t use_counter = 0;
+
+    route_flow_field_t &get(int dst_offset, int terrain_usage, int building_id) {
+        const uint32_t version = map_routing_version();
+        route_flow_field_t *oldest = &fields[0];
+        for (auto &field : fields) {
+            if (field.dst_offset == dst_offset && field.terrain_usage == terrain_usage
+                && field.destination_building_id == building_id && field.version == version) {
+                field.last_used = ++use_counter;
+                return field;
+            }
+
+            if (field.last_used < oldest->last_used) {
+                oldest = &field;
+            }
+        }
+
+        oldest->start(dst_offset, terrain_usage, building_id, version);
+        oldest->last_used = ++use_counter;
+        return *oldest;
+    }
+};
+
+// fields are per thread, figure routes are also resolved on worker threads
+static thread_local route_flow_fields_t g_route_flow_fields;
+
+int map_routing_flow_field_get_path(uint8_t *path, tile2i src, tile2i dst, int terrain_usage, int destination_building_id) {
+    const int src_offset = src.grid_offset();
+    const int dst_offset = dst.grid_offset();
+    if (!map_grid_is_valid_offset(src_offset) || !map_grid_is_valid_offset(dst_offset)) {
+        return 0;
+    }
+
+    const bool enemy = (terrain_usage == TERRAIN_USAGE_ENEMY);
+    count_route(enemy);
+    if (!enemy) {
+        destination_building_id = 0; // only enemies may step into their target building
+    }
+
+    route_flow_field_t &field = g_route_flow_fields.get(dst_offset, terrain_usage, destination_building_id);
+    if (field.cost(dst_offset) < 0) {
+        return 0;
+    }
+
+    int num_tiles = 0;
+    int grid_offset = src_offset;
+    tile2i current = src;
+    int distance = 0;
+    if (field.cost(src_offset) >= 0) {
+        distance = field.settle(src_offset);
+    } else {
+        // a figure may stand on a tile it can't enter, like the serial search it leaves through the
+        // cheapest passable neighbour; the blocked tile itself never goes into the shared field
+        int direction = -1;
+        int best = 0;
+        const int general_direction = calc_general_direction(src, dst);
+        for (int d = 0; d < 8; d += 2) {
+            const int next_offset = src_offset + map_grid_direction_delta(d);
+            if (!map_grid_is_valid_offset(next_offset) || !map_grid_inside_map_area(next_offset, 1)) {
+                continue;
+            }
+
+            const int step_cost = field.cost(next_offset);
+            if (step_cost < 0) {
+                continue;
+            }
+
+            const int next_distance = field.settle(next_offset);
+            if (next_distance <= 0) {
+                continue;
+            }
+
+            const int total = next_distance + step_cost;
+            if (direction == -1 || total < best || (total == best && d == general_direction)) {
+                direction = d;
+                best = total;
+                distance = next_distance;
+            }
+        }
+
+        if (direction == -1) {
+            return 0;
+        }
+
+        path[num_tiles++] = direction;
+        map_routing_adjust_tile_in_direction(direction, current, grid_offset);
+    }
+
+    if (distance <= 0) {
+        return 0;
+    }
+
+    // walk down the field, every tile on the way has a lower neighbour until the destination
+    while (distance > 1) {
+        int direction = -1;
+        int best = distance;
+        const int general_direction = calc_general_direction(current, dst);
+        for (int d = 0; d < 8; d++) {
+            const int next_offset = grid_offset + map_grid_direction_delta(d);
+            if (!map_grid_is_valid_offset(next_offset)) {
+                continue;
+            }
+
+            const int next_distance = field.distance[next_offset];
+            if (!next_distance || next_distance >= distance) {
+                continue;
+            }
+
+            if (next_distance < best || (next_distance == best && d == general_direction)) {
+                best = next_distance;
+                direction = d;
+            }
+        }
+        distance = best;
+
+        if (direction == -1) {
+            return 0;
+        }
+
+        // same limit as the serial search, the end of a path means arrival for the figure
+        if (num_tiles >= MAX_PATH_LENGTH) {
+            return 0;
+        }
+
+        path[num_tiles++] = direction;
+        map_routing_adjust_tile_in_direction(direction, current, grid_offset);
+    }
+
+    return num_tiles;
+}
+
+// Compares the flow field with the serial search on a fixed fixture: a walled box split by a wall
+// with a gap at the bottom, put on a part of the map without figures and restored afterwards.
+// The blocked source asks first, so a later figure sharing the field can't be led through it.
+declare_console_command_p(testflowfield) {
+    enum { SIZE = 12, WALL_X = 6, GAP_Y = SIZE - 2 };
+    const auto *map = scenario_map_data();
+    auto fixture_blocked = [] (int x, int y) {
+        return x == 0 || y == 0 || x == SIZE - 1 || y == SIZE - 1 || (x == WALL_X && y < GAP_Y);
+    };
+
+    tile2i origin(-1, -1);
+    for (int y = 1; y + SIZE < map->height && origin.x() < 0; y += SIZE) {
+        for (int x = 1; x + SIZE < map->width && origin.x() < 0; x += SIZE) {
+            bool has_figures = false;
+            map_grid_area_foreach(tile2i(x, y), tile2i(x + SIZE - 1, y + SIZE - 1), [&has_figures] (tile2i t) {
+                has_figures |= map_has_figure_at(t);
+            });
+
+            if (!has_figures) {
+                origin = tile2i(x, y);
+            }
+        }
+    }
+
+    if (origin.x() < 0) {
+        os << "testflowfield: no free area for the fixture" << std::endl;
+        return;
+    }
+
+    const routing_stats_t saved_stats = g_routing_stats;
+    std::vector<int> saved;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            const int grid_offset = origin.shifted(x, y).grid_offset();
+            saved.push_back(map_grid_get(routing_land_noncitizen, grid_offset));
+            map_grid_set(routing_land_noncitizen, grid_offset, fixture_blocked(x, y) ? NONCITIZEN_N1_BLOCKED : NONCITIZEN_0_PASSABLE);
+        }
+    }
+    map_routing_version_bump();
+
+    tile2i dst = origin.shifted(SIZE - 3, 2);
+    const tile2i sources[] = {
+        origin.shifted(WALL_X, 2), // blocked source next to the destination side
+        origin.shifted(3, 2),      // has to go round through the gap, not through the tile above
+        origin.shifted(2, GAP_Y - 1),
+        dst,
+    };
+
+    bool passed = true;
+    for (tile2i src : sources) {
+        uint8_t path[MAX_PATH_LENGTH];
+        const int length = map_routing_flow_field_get_path(path, src, dst, TERRAIN_USAGE_ANIMAL, 0);
+        const bool reachable = map_routing_noncitizen_can_travel_over_land(src, dst, -1, 5000);
+        const int serial_distance = map_routing_distance(dst.grid_offset());
+
+        bool ok = reachable ? length <= serial_distance - 1 : length == 0;
+        tile2i tile = src;
+        int grid_offset = src.grid_offset();
+        for (int i = 0; i < length; i++) {
+            map_routing_adjust_tile_in_direction(path[i], tile, grid_offset);
+            ok &= !fixture_blocked(tile.x() - origin.x(), tile.y() - origin.y());
+        }
+        ok &= (!reachable || tile == dst);
+        passed &= ok;
+
+        os << "testflowfield: " << src.x() - origin.x() << "," << src.y() - origin.y() << " flow " << length << " serial " << serial_distance - 1 << (ok ? "" : ", failed") << std::endl;
+    }
+
+    int i = 0;
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            map_grid_set(routing_land_noncitizen, origin.shifted(x, y).grid_offset(), saved[i++]);
+        }
+    }
+    map_routing_version_bump();
+    g_routing_stats = saved_stats;
+
+    os << "testflowfield: " << (passed ? "passed" : "failed") << std::endl;
 }
 
 void map_routing_block(int x, int y, int size) {
@@ -499,13 +866,13 @@ void map_routing_block(int x, int y, int size) {
 
     for (int dy = 0; dy < size; dy++) {
         for (int dx = 0; dx < size; dx++) {
-            map_grid_set(routing_distance, MAP_OFFSET(x + dx, y + dy), 0);
+            map_grid_set(routing_distances(), MAP_OFFSET(x + dx, y + dy), 0);
         }
     }
 }
 
 int map_routing_distance(int grid_offset) {
-    return map_grid_get(routing_distance, grid_offset);
+    return map_grid_get(routing_distances(), grid_offset);
 }
 
 int map_citizen_grid(int grid_offset) {
@@ -36,5 +36,13 @@ bool map_routing_can_travel_over_walls(int src_x, int src_y, int dst_x, int dst_
 
 bool map_routing_noncitizen_can_travel_over_land(tile2i src, tile2i dst, int only_through_building_id, int max_tiles);
 bool map_routing_noncitizen_can_travel_through_everything(tile2i src, tile2i dst);
+// route over a destination field shared by all figures heading to the same tile
+int map_routing_flow_field_get_path(uint8_t *path, tile2i src, tile2i dst, int terrain_usage, int destination_building_id);
 
-void map_routing_block(int x, int y, int size);
\ No newline at end of file
+void map_routing_block(int x, int y, int size);
+
+// any change of passability (terrain, routing grids, buildings, fights) must bump the version,
+// route results computed for an older version are thrown away
+void map_routing_version_bump();
+uint32_t map_routing_version();
+void map_routing_add_stats(int total_routes, int enemy_routes);
\ No newline at end of file
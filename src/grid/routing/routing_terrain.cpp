@@ -12,6 +12,7 @@
 #include "grid/image.h"
 #include "grid/property.h"
 #include "grid/random.h"
+#include "grid/road_network.h"
 #include "grid/sprite.h"
 #include "grid/terrain.h"
 #include "grid/water.h"
@@ -286,11 +287,13 @@ int map_routing_tile_check(int routing_type, int grid_offset) {
 
 void map_routing_update_land_citizen(void) {
     OZZY_PROFILER_SECTION("Game/Run/Routing/Update land/Citizen");
+    map_routing_version_bump();
     map_grid_fill(routing_land_citizen, -1);
     int grid_offset = scenario_map_data()->start_offset;
     for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
         for (int x = 0; x < scenario_map_data()->width; x++, grid_offset++) {
             map_grid_set(routing_land_citizen, grid_offset, map_routing_tile_check(ROUTING_TYPE_CITIZEN, grid_offset));
+            map_road_network_update_tile(grid_offset);
             //            int terrain = map_terrain_get(grid_offset);
             //            if (terrain & TERRAIN_ROAD && !(terrain & TERRAIN_WATER)) {
             //                map_grid_set(&terrain_land_citizen, grid_offset, CITIZEN_0_ROAD);
@@ -323,6 +326,7 @@ void map_routing_update_land_citizen(void) {
 }
 static void map_routing_update_land_noncitizen(void) {
     OZZY_PROFILER_SECTION("Game/Run/Routing/Update land/Noncitizen");
+    map_routing_version_bump();
     map_grid_fill(routing_land_noncitizen, -1);
     int grid_offset = scenario_map_data()->start_offset;
     for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
@@ -409,6 +413,7 @@ void map_routing_update_ferry_routes() {
 }
 
 void map_routing_update_water(void) {
+    map_routing_version_bump();
     map_grid_fill(routing_tiles_water, -1);
     int grid_offset = scenario_map_data()->start_offset;
     for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
@@ -439,6 +444,7 @@ void map_routing_update_water(void) {
     }
 }
 void map_routing_update_walls(void) {
+    map_routing_version_bump();
     map_grid_fill(routing_tiles_walls, -1);
     int grid_offset = scenario_map_data()->start_offset;
     for (int y = 0; y < scenario_map_data()->height; y++, grid_offset += scenario_map_data()->border_size) {
@@ -461,6 +467,7 @@ void map_routing_update_walls(void) {
 
 void map_routing_update_all(void) {
     map_routing_update_land();
+    map_road_network_rescan();
     map_routing_update_water();
     map_routing_update_walls();
 }
@@ -0,0 +1,85 @@
+#include "service_coverage.h"
+
+#include "building/building_house.h"
+#include "city/city_buildings.h"
+#include "core/profiler.h"
+#include "grid/grid.h"
+
+#include <algorithm>
+
+service_coverage_t g_service_coverage;
+
+grid_xx g_service_coverage_grids[HOUSE_SERVICE_COUNT] = {
+    {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32},
+    {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32},
+    {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32},
+    {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32}, {0, FS_INT32},
+};
+
+void service_coverage_t::clear() {
+    for (auto &grid : g_service_coverage_grids) {
+        map_grid_clear(grid);
+    }
+    initialized = true;
+}
+
+void service_coverage_t::rebuild() {
+    OZZY_PROFILER_SECTION("Game/Houses/Service Coverage Rebuild");
+    clear();
+    for (building &b : city_buildings()) {
+        auto house = b.dcast_house();
+        if (!house || (b.state != BUILDING_STATE_VALID && b.state != BUILDING_STATE_CREATED)) {
+            continue;
+        }
+
+        const auto &d = house->runtime_data();
+        for (int i = 0; i < HOUSE_SERVICE_COUNT; ++i) {
+            set_level((e_house_service)i, b.tile, d.saved_services[i]);
+        }
+    }
+}
+
+void service_coverage_t::stamp(e_house_service service, tile2i tile) {
+    if (!initialized) {
+        clear();
+    }
+    map_grid_set(g_service_coverage_grids[service], tile, cycle);
+}
+
+void service_coverage_t::reset(tile2i tile) {
+    if (!initialized) {
+        clear();
+    }
+    for (auto &grid : g_service_coverage_grids) {
+        map_grid_set(grid, tile, 0);
+    }
+}
+
+void service_coverage_t::move(tile2i from, tile2i to) {
+    if (!initialized || from == to) {
+        return;
+    }
+    for (auto &grid : g_service_coverage_grids) {
+        map_grid_set(grid, to, map_grid_get(grid, from));
+    }
+}
+
+void service_coverage_t::set_level(e_house_service service, tile2i tile, uint8_t level) {
+    if (!initialized) {
+        clear();
+    }
+    // zero stays "never served", otherwise the cycle that leaves this level now
+    const int32_t stamp = level ? cycle - (MAX_COVERAGE - std::min(level, MAX_COVERAGE)) : 0;
+    map_grid_set(g_service_coverage_grids[service], tile, stamp);
+}
+
+uint8_t service_coverage_t::level(e_house_service service, tile2i tile) const {
+    if (!initialized) {
+        return 0;
+    }
+    const int32_t stamp = map_grid_get(g_service_coverage_grids[service], tile);
+    if (!stamp) {
+        return 0;
+    }
+    return (uint8_t)std::max<int32_t>(0, MAX_COVERAGE - (cycle - stamp));
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "grid/point.h"
+
+#include <stdint.h>
+
+constexpr uint8_t MAX_COVERAGE = 96;
+
+enum e_house_service {
+    HOUSE_SERVICE_BOOTH_JUGGLER = 0,
+    HOUSE_SERVICE_BANDSTAND_JUGGLER,
+    HOUSE_SERVICE_BANDSTAND_MUSICIAN,
+    HOUSE_SERVICE_PAVILLION_MUSICIAN,
+    HOUSE_SERVICE_SENET_PLAYER,
+    HOUSE_SERVICE_MAGISTRATE,
+    HOUSE_SERVICE_BULLFIGHTER,
+    HOUSE_SERVICE_SCHOOL,
+    HOUSE_SERVICE_LIBRARY,
+    HOUSE_SERVICE_ACADEMY,
+    HOUSE_SERVICE_APOTHECARY,
+    HOUSE_SERVICE_DENTIST,
+    HOUSE_SERVICE_MORTUARY,
+    HOUSE_SERVICE_PHYSICIAN,
+    HOUSE_SERVICE_TEMPLE_OSIRIS,
+    HOUSE_SERVICE_TEMPLE_RA,
+    HOUSE_SERVICE_TEMPLE_PTAH,
+    HOUSE_SERVICE_TEMPLE_SETH,
+    HOUSE_SERVICE_TEMPLE_BAST,
+    HOUSE_SERVICE_BAZAAR_ACCESS,
+    HOUSE_SERVICE_COUNT
+};
+
+// Per service grid of the cycle a walker last served the house whose main tile it is.
+// A house's level is MAX_COVERAGE less the cycles passed since then, so a new cycle only
+// bumps the counter instead of decaying every house. A new house clears its main tile,
+// a house whose main tile moves (merge, expansion) carries its stamps along.
+struct service_coverage_t {
+    int32_t cycle = MAX_COVERAGE; // stamps of saved levels stay positive
+
+    void clear();
+    void rebuild();
+    void next_cycle() { ++cycle; }
+    void stamp(e_house_service service, tile2i tile);
+    void reset(tile2i tile);
+    void move(tile2i from, tile2i to);
+    void set_level(e_house_service service, tile2i tile, uint8_t level);
+    uint8_t level(e_house_service service, tile2i tile) const;
+
+private:
+    bool initialized = false;
+};
+
+extern service_coverage_t g_service_coverage;
@@ -34,12 +34,15 @@ int map_terrain_get(int grid_offset) {
     return map_grid_get(g_terrain_grid, grid_offset);
 }
 void map_terrain_set(int grid_offset, int terrain) {
+    map_routing_version_bump();
     map_grid_set(g_terrain_grid, grid_offset, terrain);
 }
 void map_terrain_add(int grid_offset, int terrain) {
+    map_routing_version_bump();
     map_grid_or(g_terrain_grid, grid_offset, terrain);
 }
 void map_terrain_remove(int grid_offset, int terrain) {
+    map_routing_version_bump();
     map_grid_and(g_terrain_grid, grid_offset, ~terrain);
 }
 
@@ -67,6 +70,7 @@ void map_terrain_remove_with_radius(tile2i c, int size, int radius, int terrain)
 }
 
 void map_terrain_remove_all(int terrain) {
+    map_routing_version_bump();
     map_grid_and_all(g_terrain_grid, ~terrain);
 }
 
@@ -353,12 +357,15 @@ void map_terrain_backup(void) {
     map_grid_copy(g_terrain_grid, g_terrain_grid_backup);
 }
 void map_terrain_restore(void) {
+    map_routing_version_bump();
     map_grid_copy(g_terrain_grid_backup, g_terrain_grid);
 }
 void map_terrain_clear(void) {
+    map_routing_version_bump();
     map_grid_clear(g_terrain_grid);
 }
 void map_terrain_init_outside_map(void) {
+    map_routing_version_bump();
     int map_width = scenario_map_data()->width;
     int map_height = scenario_map_data()->height;
     //    int map_width, map_height;
@@ -22,6 +22,7 @@
 #include "building/building_garden.h"
 #include "building/building_plaza.h"
 #include "building/building_road.h"
+#include "grid/road_network.h"
 #include "city/city.h"
 #include "city/city_floods.h"
 #include "core/calc.h"
@@ -235,6 +236,7 @@ int map_tiles_set_canal(tile2i tile) {
 
 void map_tiles_update_all_roads() {
     map_tiles_foreach_map_tile(building_road::set_image);
+    map_road_network_rescan();
 }
 
 void map_tiles_update_area_roads(int x, int y, int size) {
@@ -3,6 +3,7 @@
 #include "building/building.h"
 #include "building/building_well.h"
 #include "building/building_house.h"
+#include "city/city_buildings.h"
 #include "core/svector.h"
 #include "core/profiler.h"
 #include "game/game_config.h"
@@ -22,6 +23,7 @@
 #include "scenario/scenario.h"
 #include "tiles.h"
 
+#include <algorithm>
 #include <string.h>
 
 e_well_status map_water_supply_is_well_unnecessary(int well_id, int radius) {
@@ -44,3 +46,184 @@ e_well_status map_water_supply_is_well_unnecessary(int well_id, int radius) {
     }
     return num_houses ? WELL_UNNECESSARY_FOUNTAIN : WELL_UNNECESSARY_NO_HOUSES;
 }
+
+well_coverage_t g_well_coverage;
+
+grid_xx g_well_range_grid = {0, FS_UINT8};  // wells in fixed range, gives has_water_access
+grid_xx g_well_access_grid = {0, FS_UINT8}; // wells in moisture radius, gives has_well_access
+
+static const int WELL_RANGE_RADIUS = 3;
+
+static int well_access_radius(building &well) {
+    int radius = 1;
+    if (!!game_features::gameplay_change_well_radius_depends_moisture) {
+        radius = (map_moisture_get(well.tile.grid_offset()) / 40);
+        radius = std::clamp(radius, 1, 4);
+    }
+    return radius;
+}
+
+static bool well_in_footprint(grid_xx &grid, tile2i tile, int size) {
+    for (int dy = 0; dy < size; dy++) {
+        for (int dx = 0; dx < size; dx++) {
+            if (map_grid_get(grid, tile.shifted(dx, dy))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void well_coverage_t::clear() {
+    map_grid_clear(g_well_range_grid);
+    map_grid_clear(g_well_access_grid);
+    wells.clear();
+    dirty.assign(MAX_BUILDINGS, 0);
+    evaluated_with.assign(MAX_BUILDINGS, UINT32_MAX);
+}
+
+void well_coverage_t::rebuild() {
+    OZZY_PROFILER_SECTION("Game/Water Supply/Wells Coverage Rebuild");
+    clear();
+    for (building &b : city_buildings()) {
+        if (b.type == BUILDING_WELL && (b.state == BUILDING_STATE_VALID || b.state == BUILDING_STATE_CREATED)) {
+            add_well(b);
+        }
+    }
+    sync_terrain();
+}
+
+void well_coverage_t::mark_building_dirty(int grid_offset) {
+    const int building_id = map_building_at(grid_offset);
+    if (building_id > 0) {
+        dirty[building_id] = 1;
+    }
+}
+
+void well_coverage_t::stamp(tile2i tile, int radius, bool access, int delta) {
+    grid_xx &grid = access ? g_well_access_grid : g_well_range_grid;
+    grid_xx &other = access ? g_well_range_grid : g_well_access_grid;
+    grid_area area = map_grid_get_area(tile, 1, radius);
+
+    map_grid_area_foreach(area.tmin, area.tmax, [&] (tile2i t) {
+        const int grid_offset = t.grid_offset();
+        const int count = map_grid_get(grid, grid_offset);
+        map_grid_set(grid, grid_offset, count + delta);
+        if ((count == 0) == (count + delta == 0)) {
+            return;
+        }
+
+        mark_building_dirty(grid_offset);
+        if (map_grid_get(other, grid_offset)) {
+            return;
+        }
+
+        if (delta > 0) {
+            map_terrain_add(grid_offset, TERRAIN_FOUNTAIN_RANGE);
+        } else {
+            map_terrain_remove(grid_offset, TERRAIN_FOUNTAIN_RANGE);
+        }
+    });
+}
+
+void well_coverage_t::add_well(building &b) {
+    if (b.id <= 0) {
+        return;
+    }
+
+    if (dirty.empty()) {
+        clear();
+    }
+
+    for (const auto &w : wells) {
+        if (w.id == b.id) {
+            return;
+        }
+    }
+
+    stamp_t w;
+    w.id = b.id;
+    w.tile = b.tile;
+    w.access_radius = well_access_radius(b);
+    stamp(w.tile, WELL_RANGE_RADIUS, false, 1);
+    stamp(w.tile, w.access_radius, true, 1);
+    wells.push_back(w);
+}
+
+void well_coverage_t::remove_well(building &b) {
+    for (auto it = wells.begin(); it != wells.end(); ++it) {
+        if (it->id == b.id) {
+            stamp(it->tile, WELL_RANGE_RADIUS, false, -1);
+            stamp(it->tile, it->access_radius, true, -1);
+            wells.erase(it);
+            return;
+        }
+    }
+}
+
+void well_coverage_t::reset_building(building &b) {
+    if (b.id <= 0 || dirty.empty()) {
+        return;
+    }
+
+    dirty[b.id] = 1;
+    evaluated_with[b.id] = UINT32_MAX;
+}
+
+void well_coverage_t::update_wells() {
+    for (auto it = wells.begin(); it != wells.end();) {
+        building *b = building_get(it->id);
+        if (b->type != BUILDING_WELL || b->tile != it->tile) {
+            // slot reused without going through remove_well
+            stamp(it->tile, WELL_RANGE_RADIUS, false, -1);
+            stamp(it->tile, it->access_radius, true, -1);
+            it = wells.erase(it);
+            continue;
+        }
+
+        const int radius = well_access_radius(*b);
+        if (radius != it->access_radius) {
+            stamp(it->tile, it->access_radius, true, -1);
+            stamp(it->tile, radius, true, 1);
+            it->access_radius = radius;
+        }
+        ++it;
+    }
+}
+
+void well_coverage_t::update_houses() {
+    if (dirty.empty()) {
+        clear();
+    }
+
+    buildings_valid_do([this] (building &b) {
+        auto house = b.dcast_house();
+        if (!house) {
+            return;
+        }
+
+        const bool water_supply = !!house->runtime_data().water_supply;
+        const uint32_t key = (b.tile.grid_offset() << 8) | (b.size << 1) | (water_supply ? 1 : 0);
+        if (!dirty[b.id] && evaluated_with[b.id] == key) {
+            return;
+        }
+
+        dirty[b.id] = 0;
+        evaluated_with[b.id] = key;
+        const bool water_access = water_supply || well_in_footprint(g_well_range_grid, b.tile, b.size);
+        const bool well_access = well_in_footprint(g_well_access_grid, b.tile, b.size);
+        if (water_access != b.has_water_access || well_access != b.has_well_access) {
+            house->runtime_data().evolve_checked = 0;
+        }
+        b.has_water_access = water_access;
+        b.has_well_access = well_access;
+    });
+}
+
+void well_coverage_t::sync_terrain() {
+    OZZY_PROFILER_SECTION("Game/Water Supply/Wells Terrain Sync");
+    map_terrain_remove_all(TERRAIN_FOUNTAIN_RANGE);
+    for (const auto &w : wells) {
+        map_terrain_add_with_radius(w.tile, 1, std::max<int>(WELL_RANGE_RADIUS, w.access_radius), TERRAIN_FOUNTAIN_RANGE);
+    }
+}
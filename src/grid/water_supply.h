@@ -1,5 +1,12 @@
 #pragma once
 
+#include "building/building_type.h"
+#include "grid/point.h"
+
+#include <vector>
+
+class building;
+
 enum e_well_status {
     WELL_NECESSARY = 0,
     WELL_UNNECESSARY_FOUNTAIN = 1,
@@ -7,3 +14,34 @@ enum e_well_status {
 };
 
 e_well_status map_water_supply_is_well_unnecessary(int well_id, int radius);
+
+// Per tile count of the wells covering it, adjusted when a well is placed, restored by undo,
+// removed or its moisture radius changes, instead of wiping and re-stamping the whole map.
+// TERRAIN_FOUNTAIN_RANGE is kept in sync on the tiles where a count goes from/to zero,
+// and only the buildings on those tiles are queued to refresh their water access.
+struct well_coverage_t {
+    struct stamp_t {
+        building_id id;
+        tile2i tile;
+        int8_t access_radius; // moisture dependent, gives has_well_access
+    };
+
+    std::vector<stamp_t> wells;
+    std::vector<uint8_t> dirty;           // per building id, footprint coverage changed
+    std::vector<uint32_t> evaluated_with; // per building id, footprint and water supply of the last evaluation
+
+    void clear();
+    void rebuild();
+    void add_well(building &b);
+    void remove_well(building &b);
+    void reset_building(building &b); // slot created or freed, its next evaluation must not be skipped
+    void update_wells();
+    void update_houses();
+    void sync_terrain();
+
+private:
+    void stamp(tile2i tile, int radius, bool access, int delta);
+    void mark_building_dirty(int grid_offset);
+};
+
+extern well_coverage_t g_well_coverage;
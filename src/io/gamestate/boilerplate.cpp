@@ -73,6 +73,7 @@
 #include "city/city_floods.h"
 #include "io/io.h"
 #include "io/manager.h"
+#include "io/gamestate/save_index.h"
 
 #include <cassert>
 #include <filesystem>
@@ -253,104 +254,107 @@ static void post_load() {
 }
 
 // set up list of io_buffer chunks in correct order for specific file format read/write operations
-static void file_schema(e_file_format file_format, const int file_version) {
+static void file_schema(FileIOManager &io, e_file_format file_format, const int file_version) {
+    // expanded saves store the large chunks raw up to 167, compressed with the recorded codec after
+    const bool packed = file_version >= chunk_codec_save_version;
+
     switch (file_format) {
     default:
         assert(false);
         break;
 
     case FILE_FORMAT_MAP_FILE:
-        FILEIO.push_chunk(4, false, "scenario_mission_index", iob_scenario_mission_id);
-        FILEIO.push_chunk(4, false, "file_version", iob_file_version);
-        FILEIO.push_chunk(6004, false, "chunks_schema", iob_chunks_schema);
-
-        FILEIO.push_chunk(207936, false, "image_grid", &io_image_grid::instance());
-        FILEIO.push_chunk(51984, false, "edge_grid", iob_edge_grid);
-        FILEIO.push_chunk(207936, false, "terrain_grid", iob_terrain_grid);
-        FILEIO.push_chunk(51984, false, "bitfields_grid", iob_bitfields_grid);
-        FILEIO.push_chunk(51984, false, "random_grid", iob_random_grid);
-        FILEIO.push_chunk(51984, false, "elevation_grid", iob_elevation_grid);
-
-        FILEIO.push_chunk(8, false, "random_iv", iob_random_iv);
-        FILEIO.push_chunk(8, false, "city_view_camera", iob_city_view_camera);
-        FILEIO.push_chunk(1592, false, "scenario_info", iob_scenario_info);
-
-        FILEIO.push_chunk(51984, false, "soil_fertility_grid", iob_soil_fertility_grid);
-        FILEIO.push_chunk(18600, false, "scenario_events", iob_scenario_events);
-        FILEIO.push_chunk(28, false, "scenario_events_extra", iob_scenario_events_extra);
-        FILEIO.push_chunk(1280, true, "junk11", iob_junk11);
-        FILEIO.push_chunk(file_version < 160 ? 15200 : 19600, true, "empire_map_objects", iob_empire_map_objects);
-        FILEIO.push_chunk(16200, true, "empire_map_routes", iob_empire_map_routes);
-        FILEIO.push_chunk(51984, false, "vegetation_growth", iob_vegetation_growth); // not sure what's the point of this in MAP...
-
-        FILEIO.push_chunk(file_version < 147 ? 32 : 36, true, "floodplain_settings", iob_floodplain_settings);
-        FILEIO.push_chunk(288, false, "trade_prices", iob_trade_prices);
-        FILEIO.push_chunk(51984, true, "moisture_grid", iob_moisture_grid);
+        io.push_chunk(4, false, "scenario_mission_index", iob_scenario_mission_id);
+        io.push_chunk(4, false, "file_version", iob_file_version);
+        io.push_chunk(6004, false, "chunks_schema", iob_chunks_schema);
+
+        io.push_chunk(207936, false, "image_grid", &io_image_grid::instance());
+        io.push_chunk(51984, false, "edge_grid", iob_edge_grid);
+        io.push_chunk(207936, false, "terrain_grid", iob_terrain_grid);
+        io.push_chunk(51984, false, "bitfields_grid", iob_bitfields_grid);
+        io.push_chunk(51984, false, "random_grid", iob_random_grid);
+        io.push_chunk(51984, false, "elevation_grid", iob_elevation_grid);
+
+        io.push_chunk(8, false, "random_iv", iob_random_iv);
+        io.push_chunk(8, false, "city_view_camera", iob_city_view_camera);
+        io.push_chunk(1592, false, "scenario_info", iob_scenario_info);
+
+        io.push_chunk(51984, false, "soil_fertility_grid", iob_soil_fertility_grid);
+        io.push_chunk(18600, false, "scenario_events", iob_scenario_events);
+        io.push_chunk(28, false, "scenario_events_extra", iob_scenario_events_extra);
+        io.push_chunk(1280, true, "junk11", iob_junk11);
+        io.push_chunk(file_version < 160 ? 15200 : 19600, true, "empire_map_objects", iob_empire_map_objects);
+        io.push_chunk(16200, true, "empire_map_routes", iob_empire_map_routes);
+        io.push_chunk(51984, false, "vegetation_growth", iob_vegetation_growth); // not sure what's the point of this in MAP...
+
+        io.push_chunk(file_version < 147 ? 32 : 36, true, "floodplain_settings", iob_floodplain_settings);
+        io.push_chunk(288, false, "trade_prices", iob_trade_prices);
+        io.push_chunk(51984, true, "moisture_grid", iob_moisture_grid);
 
         break;
     case FILE_FORMAT_MISSION_PAK:
     case FILE_FORMAT_SAVE_FILE:
-        FILEIO.push_chunk(4, false, "scenario_mission_index", iob_scenario_mission_id);
-        FILEIO.push_chunk(4, false, "file_version", iob_file_version);
-        FILEIO.push_chunk(6004, false, "chunks_schema", iob_chunks_schema);
-
-        FILEIO.push_chunk(207936, true, "image_grid", &io_image_grid::instance());        // (228²) * 4 <<
-        FILEIO.push_chunk(51984, true, "edge_grid", iob_edge_grid);                       // (228²) * 1
-        FILEIO.push_chunk(103968, true, "building_grid", iob_building_grid);              // (228²) * 2
-        FILEIO.push_chunk(207936, true, "terrain_grid", iob_terrain_grid);                // (228²) * 4 <<
-        FILEIO.push_chunk(51984, true, "aqueduct_grid", iob_aqueduct_grid);               // (228²) * 1
-        FILEIO.push_chunk(103968, true, "figure_grid", iob_figure_grid);                  // (228²) * 2
-        FILEIO.push_chunk(51984, true, "bitfields_grid", iob_bitfields_grid);             // (228²) * 1
-        FILEIO.push_chunk(51984, true, "sprite_grid", iob_sprite_grid);                   // (228²) * 1
-        FILEIO.push_chunk(51984, false, "random_grid", iob_random_grid);                  // (228²) * 1
-        FILEIO.push_chunk(51984, true, "desirability_grid", iob_desirability_grid);       // (228²) * 1
-        FILEIO.push_chunk(51984, true, "elevation_grid", iob_elevation_grid);             // (228²) * 1
-        FILEIO.push_chunk(103968, true, "building_damage_grid", iob_damage_grid);         // (228²) * 2 <<
-        FILEIO.push_chunk(51984, true, "aqueduct_backup_grid", iob_aqueduct_backup_grid); // (228²) * 1
-        FILEIO.push_chunk(51984, true, "sprite_backup_grid", iob_sprite_backup_grid);     // (228²) * 1
-        FILEIO.push_chunk(776000, true, "figures", iob_figures);
-        FILEIO.push_chunk(2000, true, "route_figures", iob_route_figures);
-        FILEIO.push_chunk(500000, true, "route_paths", iob_route_paths);
-        FILEIO.push_chunk(7200, true, "formations", iob_formations);
-        FILEIO.push_chunk(12, false, "formations_info", iob_formations_info);
-        FILEIO.push_chunk(37808, true, "city_data", iob_city_data);
-        FILEIO.push_chunk(72, false, "city_data_extra", iob_city_data_extra);
-        FILEIO.push_chunk(1056000, true, "buildings", iob_buildings);
-        FILEIO.push_chunk(4, false, "city_view_orientation", iob_city_view_orientation);             // ok
-        FILEIO.push_chunk(20, false, "game_time", iob_game_time);                                    // ok
-        FILEIO.push_chunk(8, false, "building_extra_highest_id_ever", iob_building_highest_id_ever); // ok
-        FILEIO.push_chunk(8, false, "random_iv", iob_random_iv);                                     // ok
-        FILEIO.push_chunk(8, false, "city_view_camera", iob_city_view_camera);                       // ok
+        io.push_chunk(4, false, "scenario_mission_index", iob_scenario_mission_id);
+        io.push_chunk(4, false, "file_version", iob_file_version);
+        io.push_chunk(6004, false, "chunks_schema", iob_chunks_schema);
+
+        io.push_chunk(207936, true, "image_grid", &io_image_grid::instance());        // (228²) * 4 <<
+        io.push_chunk(51984, true, "edge_grid", iob_edge_grid);                       // (228²) * 1
+        io.push_chunk(103968, true, "building_grid", iob_building_grid);              // (228²) * 2
+        io.push_chunk(207936, true, "terrain_grid", iob_terrain_grid);                // (228²) * 4 <<
+        io.push_chunk(51984, true, "aqueduct_grid", iob_aqueduct_grid);               // (228²) * 1
+        io.push_chunk(103968, true, "figure_grid", iob_figure_grid);                  // (228²) * 2
+        io.push_chunk(51984, true, "bitfields_grid", iob_bitfields_grid);             // (228²) * 1
+        io.push_chunk(51984, true, "sprite_grid", iob_sprite_grid);                   // (228²) * 1
+        io.push_chunk(51984, false, "random_grid", iob_random_grid);                  // (228²) * 1
+        io.push_chunk(51984, true, "desirability_grid", iob_desirability_grid);       // (228²) * 1
+        io.push_chunk(51984, true, "elevation_grid", iob_elevation_grid);             // (228²) * 1
+        io.push_chunk(103968, true, "building_damage_grid", iob_damage_grid);         // (228²) * 2 <<
+        io.push_chunk(51984, true, "aqueduct_backup_grid", iob_aqueduct_backup_grid); // (228²) * 1
+        io.push_chunk(51984, true, "sprite_backup_grid", iob_sprite_backup_grid);     // (228²) * 1
+        io.push_chunk(776000, true, "figures", iob_figures);
+        io.push_chunk(2000, true, "route_figures", iob_route_figures);
+        io.push_chunk(500000, true, "route_paths", iob_route_paths);
+        io.push_chunk(7200, true, "formations", iob_formations);
+        io.push_chunk(12, false, "formations_info", iob_formations_info);
+        io.push_chunk(37808, true, "city_data", iob_city_data);
+        io.push_chunk(72, false, "city_data_extra", iob_city_data_extra);
+        io.push_chunk(1056000, true, "buildings", iob_buildings);
+        io.push_chunk(4, false, "city_view_orientation", iob_city_view_orientation);             // ok
+        io.push_chunk(20, false, "game_time", iob_game_time);                                    // ok
+        io.push_chunk(8, false, "building_extra_highest_id_ever", iob_building_highest_id_ever); // ok
+        io.push_chunk(8, false, "random_iv", iob_random_iv);                                     // ok
+        io.push_chunk(8, false, "city_view_camera", iob_city_view_camera);                       // ok
         //                state->building_count_culture1 = create_savegame_piece(132, false, ""); // MISSING
-        FILEIO.push_chunk(8, false, "city_graph_order", iob_city_graph_order); // I guess ????
+        io.push_chunk(8, false, "city_graph_order", iob_city_graph_order); // I guess ????
         //                state->emperor_change_time = create_savegame_piece(8, false, ""); // MISSING
-        FILEIO.push_chunk(12, false, "empire_map_params", iob_empire_map_params);              // ok ???
-        FILEIO.push_chunk(6466, true, "empire_cities", iob_empire_cities);                     // 83920 + 7681 --> 91601
-        FILEIO.push_chunk(288, false, "building_count_industry", iob_building_count_industry); // 288 bytes ??????
-        FILEIO.push_chunk(288, false, "trade_prices", iob_trade_prices);
-        FILEIO.push_chunk(84, false, "figure_names", iob_figure_names);
+        io.push_chunk(12, false, "empire_map_params", iob_empire_map_params);              // ok ???
+        io.push_chunk(6466, true, "empire_cities", iob_empire_cities);                     // 83920 + 7681 --> 91601
+        io.push_chunk(288, false, "building_count_industry", iob_building_count_industry); // 288 bytes ??????
+        io.push_chunk(288, false, "trade_prices", iob_trade_prices);
+        io.push_chunk(84, false, "figure_names", iob_figure_names);
 
         //                state->culture_coverage = create_savegame_piece(60, false, ""); // MISSING
-        FILEIO.push_chunk(1592, false, "scenario_info", iob_scenario_info);
+        io.push_chunk(1592, false, "scenario_info", iob_scenario_info);
 
         /////////////////////
 
-        FILEIO.push_chunk(4, false, "max_year", iob_max_year);
-        FILEIO.push_chunk(48000, true, "messages", iob_messages);          // 94000 + 533 --> 94532 + 4 = 94536
-        FILEIO.push_chunk(182, false, "message_extra", iob_message_extra); // ok
+        io.push_chunk(4, false, "max_year", iob_max_year);
+        io.push_chunk(48000, true, "messages", iob_messages);          // 94000 + 533 --> 94532 + 4 = 94536
+        io.push_chunk(182, false, "message_extra", iob_message_extra); // ok
 
-        FILEIO.push_chunk(8, false, "building_burning_list_info", iob_building_burning_list_info); // ok
-        FILEIO.push_chunk(4, false, "figure_sequence", iob_figure_sequence);                       // ok
-        FILEIO.push_chunk(12, false, "scenario_carry_settings", iob_scenario_carry_settings);      // ok
-        FILEIO.push_chunk(3232, true, "invasion_warnings", iob_invasion_warnings); // 94743 + 31 --> 94774 + 4 = 94778
-        FILEIO.push_chunk(4, false, "scenario_is_custom", iob_scenario_is_custom); // ok
-        FILEIO.push_chunk(8960, false, "city_sounds", iob_city_sounds);            // ok
-        FILEIO.push_chunk(4, false, "building_extra_highest_id", iob_building_highest_id); // ok
-        FILEIO.push_chunk(8804, false, "figure_traders", iob_figure_traders);              // +4000 ???
+        io.push_chunk(8, false, "building_burning_list_info", iob_building_burning_list_info); // ok
+        io.push_chunk(4, false, "figure_sequence", iob_figure_sequence);                       // ok
+        io.push_chunk(12, false, "scenario_carry_settings", iob_scenario_carry_settings);      // ok
+        io.push_chunk(3232, true, "invasion_warnings", iob_invasion_warnings); // 94743 + 31 --> 94774 + 4 = 94778
+        io.push_chunk(4, false, "scenario_is_custom", iob_scenario_is_custom); // ok
+        io.push_chunk(8960, false, "city_sounds", iob_city_sounds);            // ok
+        io.push_chunk(4, false, "building_extra_highest_id", iob_building_highest_id); // ok
+        io.push_chunk(8804, false, "figure_traders", iob_figure_traders);              // +4000 ???
 
-        FILEIO.push_chunk(1000, true, "building_list_burning", iob_building_list_burning); // ok
-        FILEIO.push_chunk(1000, true, "building_list_small", iob_building_list_small);     // ok
-        FILEIO.push_chunk(8000, true, "building_list_large", iob_building_list_large);     // ok
+        io.push_chunk(1000, true, "building_list_burning", iob_building_list_burning); // ok
+        io.push_chunk(1000, true, "building_list_small", iob_building_list_small);     // ok
+        io.push_chunk(8000, true, "building_list_large", iob_building_list_large);     // ok
 
         //                state->tutorial_part1 = create_savegame_piece(32, false, "");
         //                state->building_count_military = create_savegame_piece(16, false, "");
@@ -363,12 +367,12 @@ static void file_schema(e_file_format file_format, const int file_version) {
 
         // 32 bytes     00 00 00 00 ??? 8 x int
         // 24 bytes     00 00 00 00 ??? 6 x int
-        FILEIO.push_chunk(32, false, "junk7a", iob_junk7a);                          // unknown bytes
-        FILEIO.push_chunk(24, false, "junk7b", iob_junk7b);                          // unknown bytes
-        FILEIO.push_chunk(39200, false, "building_storages", iob_building_storages); // storage instructions
+        io.push_chunk(32, false, "junk7a", iob_junk7a);                          // unknown bytes
+        io.push_chunk(24, false, "junk7b", iob_junk7b);                          // unknown bytes
+        io.push_chunk(39200, false, "building_storages", iob_building_storages); // storage instructions
 
-        FILEIO.push_chunk(2880, true, "trade_routes_limits", iob_trade_routes_limits); // ok
-        FILEIO.push_chunk(2880, true, "trade_routes_traded", iob_trade_routes_traded); // ok
+        io.push_chunk(2880, true, "trade_routes_limits", iob_trade_routes_limits); // ok
+        io.push_chunk(2880, true, "trade_routes_traded", iob_trade_routes_traded); // ok
 
         //                state->building_barracks_tower_sentry = create_savegame_piece(4, false, "");
         //                state->building_extra_sequence = create_savegame_piece(4, false, "");
@@ -381,83 +385,83 @@ static void file_schema(e_file_format file_format, const int file_version) {
         // 12 bytes     00 00 00 00 ??? 3 x int
         //  2 bytes     00 00       ??? 1 x short
         //  8 bytes     00 00 00 00 ??? 2 x int
-        FILEIO.push_chunk(50, false, "junk8", iob_routing_stats); // unknown bytes
+        io.push_chunk(50, false, "junk8", iob_routing_stats); // unknown bytes
 
         //                state->last_invasion_id = create_savegame_piece(2, false, "");
         //                state->building_extra_corrupt_houses = create_savegame_piece(8, false, "");
 
-        FILEIO.push_chunk(65, false, "scenario_map_name", iob_scenario_map_name); // ok
-        FILEIO.push_chunk(32, false, "bookmarks", iob_city_bookmarks);                 // ok
+        io.push_chunk(65, false, "scenario_map_name", iob_scenario_map_name); // ok
+        io.push_chunk(32, false, "bookmarks", iob_city_bookmarks);                 // ok
 
         // 12 bytes     00 00 00 00 ??? 3 x int
         // 396 bytes    00 00 00 00 ??? 99 x int
-        FILEIO.push_chunk(12, false, "junk9a", iob_junk9a); // ok ????
-        FILEIO.push_chunk(396, false, "junk9b", iob_junk9b);
+        io.push_chunk(12, false, "junk9a", iob_junk9a); // ok ????
+        io.push_chunk(396, false, "junk9b", iob_junk9b);
 
         // 51984 bytes  00 00 00 00 ???
-        FILEIO.push_chunk(51984, false, "soil_fertility_grid", iob_soil_fertility_grid);
+        io.push_chunk(51984, false, "soil_fertility_grid", iob_soil_fertility_grid);
 
         // 18600 bytes  00 00 00 00 ??? 150 x 124-byte chunk
         // 28 bytes     2F 01 00 00 ???
-        FILEIO.push_chunk(18600, false, "scenario_events", iob_scenario_events);
-        FILEIO.push_chunk(28, false, "scenario_events_extra", iob_scenario_events_extra);
+        io.push_chunk(18600, false, "scenario_events", iob_scenario_events);
+        io.push_chunk(28, false, "scenario_events_extra", iob_scenario_events_extra);
 
         // 11000 bytes  00 00 00 00 ??? 50 x 224-byte chunk (50 x 220 for old version)
         // 2200 bytes   00 00 00 00 ??? 50 x 44-byte chunk
         // 16 bytes     00 00 00 00 ??? 4 x int
         // 8200 bytes   00 00 00 00 ??? 10 x 820-byte chunk
-        FILEIO.push_chunk(file_version < 149 ? 11000 : 11200, false, "junk10a", iob_junk10a);
-        FILEIO.push_chunk(2200, false, "junk10b", iob_junk10b);
-        FILEIO.push_chunk(16, false, "junk10c", iob_junk10c);
-        FILEIO.push_chunk(8200, false, "junk10d", iob_junk10d);
+        io.push_chunk(file_version < 149 ? 11000 : 11200, false, "junk10a", iob_junk10a);
+        io.push_chunk(2200, false, "junk10b", iob_junk10b);
+        io.push_chunk(16, false, "junk10c", iob_junk10c);
+        io.push_chunk(8200, false, "junk10d", iob_junk10d);
 
         // 1280 bytes   00 00 00 00 ??? 40 x 32-byte chunk
-        FILEIO.push_chunk(1280, true, "junk11", iob_junk11); // unknown compressed data
+        io.push_chunk(1280, true, "junk11", iob_junk11); // unknown compressed data
 
-        FILEIO.push_chunk(file_version < 160 ? 15200 : 19600, true, "empire_map_objects", iob_empire_map_objects);
-        FILEIO.push_chunk(16200, true, "empire_map_routes", iob_empire_map_routes);
+        io.push_chunk(file_version < 160 ? 15200 : 19600, true, "empire_map_objects", iob_empire_map_objects);
+        io.push_chunk(16200, true, "empire_map_routes", iob_empire_map_routes);
 
         // 51984 bytes  FF FF FF FF ???          // (228²) * 1 ?????????????????
-        FILEIO.push_chunk(51984, false, "vegetation_growth", iob_vegetation_growth); // todo: 1-byte grid
+        io.push_chunk(51984, false, "vegetation_growth", iob_vegetation_growth); // todo: 1-byte grid
 
         // 20 bytes     19 00 00 00 ???
-        FILEIO.push_chunk(20, false, "junk14", iob_junk14);
+        io.push_chunk(20, false, "junk14", iob_junk14);
 
         // 528 bytes    00 00 00 00 ??? 22 x 24-byte chunk
-        FILEIO.push_chunk(528, false, "bizarre_ordered_fields_1", iob_bizarre_ordered_fields_1);
+        io.push_chunk(528, false, "bizarre_ordered_fields_1", iob_bizarre_ordered_fields_1);
 
-        FILEIO.push_chunk(file_version < 147 ? 32 : 36,
+        io.push_chunk(file_version < 147 ? 32 : 36,
                           true,
                           "floodplain_settings",
                           iob_floodplain_settings);                        // floodplain_settings
-        FILEIO.push_chunk(207936, true, "GRID03_32BIT", iob_GRID03_32BIT); // todo: 4-byte grid
+        io.push_chunk(207936, true, "GRID03_32BIT", iob_GRID03_32BIT); // todo: 4-byte grid
 
         // 312 bytes    2B 00 00 00 ??? 13 x 24-byte chunk
-        FILEIO.push_chunk(312,
+        io.push_chunk(312,
                           false,
                           "bizarre_ordered_fields_4",
                           iob_bizarre_ordered_fields_4); // 71x 4-bytes emptiness
 
         // 64 bytes     00 00 00 00 ???
-        FILEIO.push_chunk(64, false, "junk16", iob_junk16);                        // 71x 4-bytes emptiness
-        FILEIO.push_chunk(41, false, "tutorial_flags_struct", iob_tutorial_flags); // 41 x 1-byte flag fields
-        FILEIO.push_chunk(51984, true, "GRID04_8BIT", iob_GRID04_8BIT);
+        io.push_chunk(64, false, "junk16", iob_junk16);                        // 71x 4-bytes emptiness
+        io.push_chunk(41, false, "tutorial_flags_struct", iob_tutorial_flags); // 41 x 1-byte flag fields
+        io.push_chunk(51984, true, "GRID04_8BIT", iob_GRID04_8BIT);
 
         // lone byte ???
-        FILEIO.push_chunk(1, false, "junk17", iob_junk17);
-        FILEIO.push_chunk(51984, true, "moisture_grid", iob_moisture_grid);
+        io.push_chunk(1, false, "junk17", iob_junk17);
+        io.push_chunk(51984, true, "moisture_grid", iob_moisture_grid);
 
         // 240 bytes    0F 00 00 00 ??? 10 x 24-byte chunk
         // 432 bytes    0F 00 00 00 ??? 18 x 24-byte chunk
-        FILEIO.push_chunk(240, false, "bizarre_ordered_fields_2", iob_bizarre_ordered_fields_2);
-        FILEIO.push_chunk(432, false, "bizarre_ordered_fields_3", iob_bizarre_ordered_fields_3);
+        io.push_chunk(240, false, "bizarre_ordered_fields_2", iob_bizarre_ordered_fields_2);
+        io.push_chunk(432, false, "bizarre_ordered_fields_3", iob_bizarre_ordered_fields_3);
 
         // 8 bytes      00 00 00 00 ??? 2 x int
-        FILEIO.push_chunk(8, false, "junk18", iob_junk18);
+        io.push_chunk(8, false, "junk18", iob_junk18);
 
         if (file_version >= 160) {
             // 12 bytes     00 00 00 00 ??? 3 x int
-            FILEIO.push_chunk(20, false, "junk19", iob_junk19);
+            io.push_chunk(20, false, "junk19", iob_junk19);
 
             // 648 bytes   00 00 00 00 ??? 27 x 24-byte chunk
             // 648 bytes   00 00 00 00 ??? 27 x 24-byte chunk
@@ -465,110 +469,114 @@ static void file_schema(e_file_format file_format, const int file_version) {
             // 1344 bytes  00 00 00 00 ??? 56 x 24-byte chunk
             // 1800 bytes  00 00 00 00 ??? 75 x 24-byte chunk <--- I can't even... their own schema is wrong. it's >>
             // 74! <<
-            FILEIO.push_chunk(648, false, "bizarre_ordered_fields_5", iob_bizarre_ordered_fields_5);
-            FILEIO.push_chunk(648, false, "bizarre_ordered_fields_6", iob_bizarre_ordered_fields_6);
-            FILEIO.push_chunk(360, false, "bizarre_ordered_fields_7", iob_bizarre_ordered_fields_7);
-            FILEIO.push_chunk(1344, false, "bizarre_ordered_fields_8", iob_bizarre_ordered_fields_8);
-            FILEIO.push_chunk(1776, false, "bizarre_ordered_fields_9", iob_bizarre_ordered_fields_9);
+            io.push_chunk(648, false, "bizarre_ordered_fields_5", iob_bizarre_ordered_fields_5);
+            io.push_chunk(648, false, "bizarre_ordered_fields_6", iob_bizarre_ordered_fields_6);
+            io.push_chunk(360, false, "bizarre_ordered_fields_7", iob_bizarre_ordered_fields_7);
+            io.push_chunk(1344, false, "bizarre_ordered_fields_8", iob_bizarre_ordered_fields_8);
+            io.push_chunk(1776, false, "bizarre_ordered_fields_9", iob_bizarre_ordered_fields_9);
         }
         break;
 
     case FILE_FORMAT_SAVE_FILE_EXT:
-        FILEIO.push_chunk(4, false, "scenario_mission_index", iob_scenario_mission_id);
-        FILEIO.push_chunk(4, false, "file_version", iob_file_version);
-        FILEIO.push_chunk(6004, false, "chunks_schema", iob_chunks_schema);
-        FILEIO.push_chunk(51984 * 4, false, "image_grid", &io_image_grid::instance());        // (228²) * 4 <<
-        FILEIO.push_chunk(51984, false, "edge_grid", iob_edge_grid);                       // (228²) * 1
-        FILEIO.push_chunk(103968, false, "building_grid", iob_building_grid);              // (228²) * 2
-        FILEIO.push_chunk(51984 * 4, false, "terrain_grid", iob_terrain_grid);                // (228²) * 4 <<
-        FILEIO.push_chunk(51984, false, "aqueduct_grid", iob_aqueduct_grid);               // (228²) * 1
-        FILEIO.push_chunk(103968, false, "figure_grid", iob_figure_grid);                  // (228²) * 2
-        FILEIO.push_chunk(51984, false, "bitfields_grid", iob_bitfields_grid);             // (228²) * 1
-        FILEIO.push_chunk(51984, false, "sprite_grid", iob_sprite_grid);                   // (228²) * 1
-        FILEIO.push_chunk(51984, false, "random_grid", iob_random_grid);                   // (228²) * 1
-        FILEIO.push_chunk(51984, false, "desirability_grid", iob_desirability_grid);       // (228²) * 1
-        FILEIO.push_chunk(51984, false, "elevation_grid", iob_elevation_grid);             // (228²) * 1
-        FILEIO.push_chunk(103968, false, "building_damage_grid", iob_damage_grid);         // (228²) * 2 <<
-        FILEIO.push_chunk(51984, false, "aqueduct_backup_grid", iob_aqueduct_backup_grid); // (228²) * 1
-        FILEIO.push_chunk(51984, false, "sprite_backup_grid", iob_sprite_backup_grid);     // (228²) * 1
-        FILEIO.push_chunk(776000, false, "figures", iob_figures);
-        FILEIO.push_chunk(2000, false, "route_figures", iob_route_figures);
-        FILEIO.push_chunk(500000, false, "route_paths", iob_route_paths);
-        FILEIO.push_chunk(7200, false, "formations", iob_formations);
-        FILEIO.push_chunk(12, false, "formations_info", iob_formations_info);
-        FILEIO.push_chunk(37808, false, "city_data", iob_city_data);
-        FILEIO.push_chunk(72, false, "city_data_extra", iob_city_data_extra);
-        FILEIO.push_chunk(1056000, false, "buildings", iob_buildings);
-        FILEIO.push_chunk(4, false, "city_view_orientation", iob_city_view_orientation);             // ok
-        FILEIO.push_chunk(20, false, "game_time", iob_game_time);                                    // ok
-        FILEIO.push_chunk(8, false, "building_extra_highest_id_ever", iob_building_highest_id_ever); // ok
-        FILEIO.push_chunk(8, false, "random_iv", iob_random_iv);                                     // ok
-        FILEIO.push_chunk(8, false, "city_view_camera", iob_city_view_camera);                       // ok
-        FILEIO.push_chunk(8, false, "city_graph_order", iob_city_graph_order);                       // I guess ????
-        FILEIO.push_chunk(12, false, "empire_map_params", iob_empire_map_params);                    // ok ???
-        FILEIO.push_chunk(6466, false, "empire_cities", iob_empire_cities);                    // 83920 + 7681 --> 91601
-        FILEIO.push_chunk(288, false, "building_count_industry", iob_building_count_industry); // 288 bytes ??????
-        FILEIO.push_chunk(288, false, "trade_prices", iob_trade_prices);
-        FILEIO.push_chunk(84, false, "figure_names", iob_figure_names);
-        FILEIO.push_chunk(1592, false, "scenario_info", iob_scenario_info);
-        FILEIO.push_chunk(4, false, "max_year", iob_max_year);
-        FILEIO.push_chunk(48000, false, "messages", iob_messages);         // 94000 + 533 --> 94532 + 4 = 94536
-        FILEIO.push_chunk(182, false, "message_extra", iob_message_extra); // ok
-        FILEIO.push_chunk(8, false, "building_burning_list_info", iob_building_burning_list_info); // ok
-        FILEIO.push_chunk(4, false, "figure_sequence", iob_figure_sequence);                       // ok
-        FILEIO.push_chunk(12, false, "scenario_carry_settings", iob_scenario_carry_settings);      // ok
-        FILEIO.push_chunk(3232, false, "invasion_warnings", iob_invasion_warnings); // 94743 + 31 --> 94774 + 4 = 94778
-        FILEIO.push_chunk(4, false, "scenario_is_custom", iob_scenario_is_custom);  // ok
-        FILEIO.push_chunk(8960, false, "city_sounds", iob_city_sounds);             // ok
-        FILEIO.push_chunk(4, false, "building_extra_highest_id", iob_building_highest_id);  // ok
-        FILEIO.push_chunk(8804, false, "figure_traders", iob_figure_traders);               // +4000 ???
-        FILEIO.push_chunk(1000, false, "building_list_burning", iob_building_list_burning); // ok
-        FILEIO.push_chunk(1000, false, "building_list_small", iob_building_list_small);     // ok
-        FILEIO.push_chunk(8000, false, "building_list_large", iob_building_list_large);     // ok
-        FILEIO.push_chunk(32, false, "junk7a", iob_junk7a);                                 // unknown bytes
-        FILEIO.push_chunk(24, false, "junk7b", iob_junk7b);                                 // unknown bytes
-        FILEIO.push_chunk(39200, false, "building_storages", iob_building_storages);        // storage instructions
-        FILEIO.push_chunk(2880, false, "trade_routes_limits", iob_trade_routes_limits);     // ok
-        FILEIO.push_chunk(2880, false, "trade_routes_traded", iob_trade_routes_traded);     // ok
-        FILEIO.push_chunk(50, false, "junk8", iob_routing_stats);                           // unknown bytes
-        FILEIO.push_chunk(65, false, "scenario_map_name", iob_scenario_map_name);           // ok
-        FILEIO.push_chunk(32, false, "bookmarks", iob_city_bookmarks);                           // ok
-        FILEIO.push_chunk(12, false, "junk9a", iob_junk9a);                                 // ok ????
-        FILEIO.push_chunk(396, false, "junk9b", iob_junk9b);
-        FILEIO.push_chunk(51984, false, "soil_fertility_grid", iob_soil_fertility_grid);
-        FILEIO.push_chunk(18600, false, "scenario_events", iob_scenario_events);
-        FILEIO.push_chunk(28, false, "scenario_events_extra", iob_scenario_events_extra);
-        FILEIO.push_chunk(11200, false, "junk10a", iob_junk10a);
-        FILEIO.push_chunk(2200, false, "junk10b", iob_junk10b);
-        FILEIO.push_chunk(16, false, "junk10c", iob_junk10c);
-        FILEIO.push_chunk(8200, false, "junk10d", iob_junk10d);
-        FILEIO.push_chunk(1280, false, "junk11", iob_junk11); // unknown compressed data
-        FILEIO.push_chunk(19600, true, "empire_map_objects", iob_empire_map_objects);
-        FILEIO.push_chunk(16200, false, "empire_map_routes", iob_empire_map_routes);
-        FILEIO.push_chunk(51984, false, "vegetation_growth", iob_vegetation_growth); // todo: 1-byte grid
-        FILEIO.push_chunk(20, false, "junk14", iob_junk14);
-        FILEIO.push_chunk(528, false, "bizarre_ordered_fields_1", iob_bizarre_ordered_fields_1);
-        FILEIO.push_chunk(36, false, "floodplain_settings", iob_floodplain_settings); // floodplain_settings
-        FILEIO.push_chunk(51984 * 4, false, "GRID03_32BIT", iob_GRID03_32BIT);           // todo: 4-byte grid
-        FILEIO.push_chunk(312, false, "bizarre_ordered_fields_4", iob_bizarre_ordered_fields_4);                           // 71x 4-bytes emptiness
-        FILEIO.push_chunk(64, false, "junk16", iob_junk16);                        // 71x 4-bytes emptiness
-        FILEIO.push_chunk(41, false, "tutorial_flags_struct", iob_tutorial_flags); // 41 x 1-byte flag fields
-        FILEIO.push_chunk(51984, false, "GRID04_8BIT", iob_GRID04_8BIT);
-        FILEIO.push_chunk(1, false, "junk17", iob_junk17);
-        FILEIO.push_chunk(51984, false, "moisture_grid", iob_moisture_grid);
-        FILEIO.push_chunk(240, false, "bizarre_ordered_fields_2", iob_bizarre_ordered_fields_2);
-        FILEIO.push_chunk(432, false, "bizarre_ordered_fields_3", iob_bizarre_ordered_fields_3);
-        FILEIO.push_chunk(8, false, "junk18", iob_junk18);
-        FILEIO.push_chunk(20, false, "junk19", iob_junk19);
-        FILEIO.push_chunk(648, false, "bizarre_ordered_fields_5", iob_bizarre_ordered_fields_5);
-        FILEIO.push_chunk(648, false, "bizarre_ordered_fields_6", iob_bizarre_ordered_fields_6);
-        FILEIO.push_chunk(360, false, "bizarre_ordered_fields_7", iob_bizarre_ordered_fields_7);
-        FILEIO.push_chunk(1344, false, "bizarre_ordered_fields_8", iob_bizarre_ordered_fields_8);
-        FILEIO.push_chunk(1776, false, "bizarre_ordered_fields_9", iob_bizarre_ordered_fields_9);
-        FILEIO.push_chunk(51984, false, "terrain_floodplain_growth", iob_terrain_floodplain_growth);
-        FILEIO.push_chunk(51984 * 4, false, "monuments_progress", iob_monuments_progress_grid); // (228²) * 4
+        io.push_chunk(4, false, "scenario_mission_index", iob_scenario_mission_id);
+        io.push_chunk(4, false, "file_version", iob_file_version);
+        io.push_chunk(6004, false, "chunks_schema", iob_chunks_schema);
+        io.push_chunk(51984 * 4, packed, "image_grid", &io_image_grid::instance());        // (228²) * 4 <<
+        io.push_chunk(51984, packed, "edge_grid", iob_edge_grid);                       // (228²) * 1
+        io.push_chunk(103968, packed, "building_grid", iob_building_grid);              // (228²) * 2
+        io.push_chunk(51984 * 4, packed, "terrain_grid", iob_terrain_grid);                // (228²) * 4 <<
+        io.push_chunk(51984, packed, "aqueduct_grid", iob_aqueduct_grid);               // (228²) * 1
+        io.push_chunk(103968, packed, "figure_grid", iob_figure_grid);                  // (228²) * 2
+        io.push_chunk(51984, packed, "bitfields_grid", iob_bitfields_grid);             // (228²) * 1
+        io.push_chunk(51984, packed, "sprite_grid", iob_sprite_grid);                   // (228²) * 1
+        io.push_chunk(51984, packed, "random_grid", iob_random_grid);                   // (228²) * 1
+        io.push_chunk(51984, packed, "desirability_grid", iob_desirability_grid);       // (228²) * 1
+        io.push_chunk(51984, packed, "elevation_grid", iob_elevation_grid);             // (228²) * 1
+        io.push_chunk(103968, packed, "building_damage_grid", iob_damage_grid);         // (228²) * 2 <<
+        io.push_chunk(51984, packed, "aqueduct_backup_grid", iob_aqueduct_backup_grid); // (228²) * 1
+        io.push_chunk(51984, packed, "sprite_backup_grid", iob_sprite_backup_grid);     // (228²) * 1
+        io.push_chunk(776000, packed, "figures", iob_figures);
+        if (file_version > 166) {
+            io.push_chunk(768002, true, "route_paths_packed", iob_route_paths_packed); // 2 + 3000 * (6 + 250)
+        } else {
+            io.push_chunk(2000, false, "route_figures", iob_route_figures);
+            io.push_chunk(500000, false, "route_paths", iob_route_paths);
+        }
+        io.push_chunk(7200, packed, "formations", iob_formations);
+        io.push_chunk(12, false, "formations_info", iob_formations_info);
+        io.push_chunk(37808, packed, "city_data", iob_city_data);
+        io.push_chunk(72, false, "city_data_extra", iob_city_data_extra);
+        io.push_chunk(1056000, packed, "buildings", iob_buildings);
+        io.push_chunk(4, false, "city_view_orientation", iob_city_view_orientation);             // ok
+        io.push_chunk(20, false, "game_time", iob_game_time);                                    // ok
+        io.push_chunk(8, false, "building_extra_highest_id_ever", iob_building_highest_id_ever); // ok
+        io.push_chunk(8, false, "random_iv", iob_random_iv);                                     // ok
+        io.push_chunk(8, false, "city_view_camera", iob_city_view_camera);                       // ok
+        io.push_chunk(8, false, "city_graph_order", iob_city_graph_order);                       // I guess ????
+        io.push_chunk(12, false, "empire_map_params", iob_empire_map_params);                    // ok ???
+        io.push_chunk(6466, packed, "empire_cities", iob_empire_cities);                    // 83920 + 7681 --> 91601
+        io.push_chunk(288, false, "building_count_industry", iob_building_count_industry); // 288 bytes ??????
+        io.push_chunk(288, false, "trade_prices", iob_trade_prices);
+        io.push_chunk(84, false, "figure_names", iob_figure_names);
+        io.push_chunk(1592, packed, "scenario_info", iob_scenario_info);
+        io.push_chunk(4, false, "max_year", iob_max_year);
+        io.push_chunk(48000, packed, "messages", iob_messages);         // 94000 + 533 --> 94532 + 4 = 94536
+        io.push_chunk(182, false, "message_extra", iob_message_extra); // ok
+        io.push_chunk(8, false, "building_burning_list_info", iob_building_burning_list_info); // ok
+        io.push_chunk(4, false, "figure_sequence", iob_figure_sequence);                       // ok
+        io.push_chunk(12, false, "scenario_carry_settings", iob_scenario_carry_settings);      // ok
+        io.push_chunk(3232, packed, "invasion_warnings", iob_invasion_warnings); // 94743 + 31 --> 94774 + 4 = 94778
+        io.push_chunk(4, false, "scenario_is_custom", iob_scenario_is_custom);  // ok
+        io.push_chunk(8960, packed, "city_sounds", iob_city_sounds);             // ok
+        io.push_chunk(4, false, "building_extra_highest_id", iob_building_highest_id);  // ok
+        io.push_chunk(8804, packed, "figure_traders", iob_figure_traders);               // +4000 ???
+        io.push_chunk(1000, packed, "building_list_burning", iob_building_list_burning); // ok
+        io.push_chunk(1000, packed, "building_list_small", iob_building_list_small);     // ok
+        io.push_chunk(8000, packed, "building_list_large", iob_building_list_large);     // ok
+        io.push_chunk(32, false, "junk7a", iob_junk7a);                                 // unknown bytes
+        io.push_chunk(24, false, "junk7b", iob_junk7b);                                 // unknown bytes
+        io.push_chunk(39200, packed, "building_storages", iob_building_storages);        // storage instructions
+        io.push_chunk(2880, packed, "trade_routes_limits", iob_trade_routes_limits);     // ok
+        io.push_chunk(2880, packed, "trade_routes_traded", iob_trade_routes_traded);     // ok
+        io.push_chunk(50, false, "junk8", iob_routing_stats);                           // unknown bytes
+        io.push_chunk(65, false, "scenario_map_name", iob_scenario_map_name);           // ok
+        io.push_chunk(32, false, "bookmarks", iob_city_bookmarks);                           // ok
+        io.push_chunk(12, false, "junk9a", iob_junk9a);                                 // ok ????
+        io.push_chunk(396, false, "junk9b", iob_junk9b);
+        io.push_chunk(51984, packed, "soil_fertility_grid", iob_soil_fertility_grid);
+        io.push_chunk(18600, packed, "scenario_events", iob_scenario_events);
+        io.push_chunk(28, false, "scenario_events_extra", iob_scenario_events_extra);
+        io.push_chunk(11200, packed, "junk10a", iob_junk10a);
+        io.push_chunk(2200, packed, "junk10b", iob_junk10b);
+        io.push_chunk(16, false, "junk10c", iob_junk10c);
+        io.push_chunk(8200, packed, "junk10d", iob_junk10d);
+        io.push_chunk(1280, packed, "junk11", iob_junk11); // unknown compressed data
+        io.push_chunk(19600, true, "empire_map_objects", iob_empire_map_objects);
+        io.push_chunk(16200, packed, "empire_map_routes", iob_empire_map_routes);
+        io.push_chunk(51984, packed, "vegetation_growth", iob_vegetation_growth); // todo: 1-byte grid
+        io.push_chunk(20, false, "junk14", iob_junk14);
+        io.push_chunk(528, false, "bizarre_ordered_fields_1", iob_bizarre_ordered_fields_1);
+        io.push_chunk(36, false, "floodplain_settings", iob_floodplain_settings); // floodplain_settings
+        io.push_chunk(51984 * 4, packed, "GRID03_32BIT", iob_GRID03_32BIT);           // todo: 4-byte grid
+        io.push_chunk(312, false, "bizarre_ordered_fields_4", iob_bizarre_ordered_fields_4);                           // 71x 4-bytes emptiness
+        io.push_chunk(64, false, "junk16", iob_junk16);                        // 71x 4-bytes emptiness
+        io.push_chunk(41, false, "tutorial_flags_struct", iob_tutorial_flags); // 41 x 1-byte flag fields
+        io.push_chunk(51984, packed, "GRID04_8BIT", iob_GRID04_8BIT);
+        io.push_chunk(1, false, "junk17", iob_junk17);
+        io.push_chunk(51984, packed, "moisture_grid", iob_moisture_grid);
+        io.push_chunk(240, false, "bizarre_ordered_fields_2", iob_bizarre_ordered_fields_2);
+        io.push_chunk(432, false, "bizarre_ordered_fields_3", iob_bizarre_ordered_fields_3);
+        io.push_chunk(8, false, "junk18", iob_junk18);
+        io.push_chunk(20, false, "junk19", iob_junk19);
+        io.push_chunk(648, false, "bizarre_ordered_fields_5", iob_bizarre_ordered_fields_5);
+        io.push_chunk(648, false, "bizarre_ordered_fields_6", iob_bizarre_ordered_fields_6);
+        io.push_chunk(360, false, "bizarre_ordered_fields_7", iob_bizarre_ordered_fields_7);
+        io.push_chunk(1344, packed, "bizarre_ordered_fields_8", iob_bizarre_ordered_fields_8);
+        io.push_chunk(1776, packed, "bizarre_ordered_fields_9", iob_bizarre_ordered_fields_9);
+        io.push_chunk(51984, packed, "terrain_floodplain_growth", iob_terrain_floodplain_growth);
+        io.push_chunk(51984 * 4, packed, "monuments_progress", iob_monuments_progress_grid); // (228²) * 4
         if (file_version > 165) {
-            FILEIO.push_chunk(51984, false, "rubble_type_grid", iob_rubble_type_grid); //  (228²) * 1
+            io.push_chunk(51984, packed, "rubble_type_grid", iob_rubble_type_grid); //  (228²) * 1
         }
         break;
     }
@@ -579,14 +587,16 @@ bool GamestateIO::write_mission(const int scenario_id) {
     return false;
 }
 
-bool GamestateIO::write_savegame(pcstr filename_short) {
+bool GamestateIO::write_savegame(pcstr filename_short, bool autosave) {
     vfs::path full = fullpath_saves(filename_short);
 
-    // write file
+    // write file, autosaves happen during play so they take the fastest level
     e_file_format format = get_format_from_file(filename_short);
     assert(format == FILE_FORMAT_SAVE_FILE_EXT);
+    FILEIO.set_save_codec(CHUNK_CODEC_ZLIB, autosave ? 1 : 6);
     bool save_ok = FILEIO.serialize(full, 0, format, latest_save_version, file_schema);
     if (save_ok) {
+        g_save_index.on_save_written(full);
         //vfs::path fs_path = vfs::content_path(full);
         game_features::gameopt_last_save_filename = full.c_str();
         game_features::gameopt_last_player = g_settings.player_name.c_str();
@@ -633,7 +643,7 @@ bool GamestateIO::load_mission(const int scenario_id, bool start_immediately) {
 
         // replay mission autosave file
         bstring256 filename("autosave_replay.", saved_game_data_expanded.extension);
-        GamestateIO::write_savegame(filename);
+        GamestateIO::write_savegame(filename, /*autosave*/true);
     }
 
     return true;
@@ -681,12 +691,39 @@ bool GamestateIO::load_map(pcstr filename_short, bool start_immediately) {
     if (start_immediately) {
         start_loaded_file();
         // replay mission autosave file
-        GamestateIO::write_savegame("autosave_replay.sav");
+        GamestateIO::write_savegame("autosave_replay.sav", /*autosave*/true);
     }
 
     return true;
 }
 
+bool GamestateIO::load_mission_preview(const int scenario_id) {
+    int offset = get_campaign_scenario_offset(scenario_id);
+    if (offset <= 0) {
+        return false;
+    }
+
+    if (!FILEIO.unserialize_chunks(MISSION_PACK_FILE, offset, FILE_FORMAT_MISSION_PAK, GamestateIO::read_file_version, file_schema, {"scenario_mission_index", "scenario_info"})) {
+        return false;
+    }
+
+    scenario_set_campaign_scenario(scenario_id);
+    return true;
+}
+
+bool GamestateIO::load_map_preview(pcstr filename_short) {
+    char full[MAX_FILE_NAME] = {0};
+    fullpath_maps(full, filename_short);
+
+    return FILEIO.unserialize_chunks(full, 0, FILE_FORMAT_MAP_FILE, GamestateIO::read_file_version, file_schema, {"scenario_mission_index", "scenario_info"});
+}
+
+bool GamestateIO::read_savegame_chunks(FileIOManager &reader, pcstr filename_short, std::initializer_list<pcstr> names) {
+    bstring256 full = fullpath_saves(filename_short);
+    e_file_format file_format = get_format_from_file(filename_short);
+    return reader.unserialize_chunks(full, 0, file_format, GamestateIO::read_file_version, file_schema, names);
+}
+
 void GamestateIO::start_loaded_file() {
     // build the map grids when loading MAP files
     if (game.session.last_loaded != e_session_save) {
@@ -780,7 +817,12 @@ bool GamestateIO::delete_savegame(const char* filename_short) {
     bstring256 full = fullpath_saves(filename_short);
 
     // delete file
-    return vfs::file_remove(full);
+    if (!vfs::file_remove(full)) {
+        return false;
+    }
+
+    g_save_index.on_save_removed(full);
+    return true;
 }
 
 bool GamestateIO::delete_map(const char* filename_short) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <initializer_list>
 #include "content/dir.h"
 
 // file versions found so far:
@@ -15,7 +16,19 @@
 //  163 akhenaten: save bazaar_days in house
 //  164 akhenaten: save water_supply in house
 //  165 akhenaten: save house health option
-constexpr uint32_t latest_save_version = 166;
+//  167 akhenaten: save figure routes packed, only the routes in use
+//  168 akhenaten: codec id in compressed chunk headers, large chunks compressed with zlib
+constexpr uint32_t latest_save_version = 168;
+constexpr uint32_t chunk_codec_save_version = 168;
+
+// fields read straight from the raw chunks of a save by the save index,
+// iob_game_time and iob_city_data assert these against their bind layout
+constexpr int game_time_month_offset = 8;
+constexpr int game_time_year_offset = 12;
+constexpr int city_data_population_offset = 18940;
+constexpr int city_data_treasury_offset = 30408;
+
+class FileIOManager;
 
 vfs::path fullpath_saves(const char* filename);
 void fullpath_maps(char* full, const char* filename);
@@ -25,7 +38,7 @@ const int get_campaign_scenario_offset(int scenario_id);
 const int read_file_version(const char* filename, int offset);
 
 bool write_mission(const int scenario_id);
-bool write_savegame(const char* filename_short);
+bool write_savegame(const char* filename_short, bool autosave = false);
 
 bool write_map(const char* filename_short);
 
@@ -33,6 +46,13 @@ bool load_mission(const int scenario_id, bool start_immediately);
 bool load_savegame(pcstr filename_short, bool start_immediately = true);
 bool load_map(pcstr filename_short, bool start_immediately = true);
 
+// read only the scenario header chunks for the selection screens, no city reset
+bool load_mission_preview(const int scenario_id);
+bool load_map_preview(pcstr filename_short);
+
+// fill only the named chunk buffers of a savegame, reader must be a detached FileIOManager
+bool read_savegame_chunks(FileIOManager &reader, pcstr filename_short, std::initializer_list<pcstr> names);
+
 void start_loaded_file();
 
 bool delete_mission(const int scenario_id);
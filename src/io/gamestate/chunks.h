@@ -25,6 +25,7 @@ extern io_buffer* iob_sprite_backup_grid;
 extern io_buffer* iob_figures;
 extern io_buffer* iob_route_figures;
 extern io_buffer* iob_route_paths;
+extern io_buffer* iob_route_paths_packed;
 extern io_buffer* iob_formations;
 extern io_buffer* iob_formations_info;
 extern io_buffer* iob_city_data;
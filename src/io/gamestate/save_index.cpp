@@ -0,0 +1,283 @@
+#include "save_index.h"
+
+#include "city/city.h"
+#include "core/log.h"
+#include "core/profiler.h"
+#include "game/game.h"
+#include "io/gamestate/boilerplate.h"
+#include "io/manager.h"
+#include "scenario/scenario.h"
+#include "window/file_dialog.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <string.h>
+
+namespace fs = std::filesystem;
+
+save_index_t g_save_index;
+
+static const char SAVE_INDEX_FILE[] = "saves.idx";
+static const uint32_t SAVE_INDEX_MAGIC = 0x58444953; // "SIDX"
+static const uint32_t SAVE_INDEX_VERSION = 1;
+
+static bool is_savegame(pcstr filename) {
+    return vfs::file_has_extension(filename, saved_game_data.extension)
+            || vfs::file_has_extension(filename, saved_game_data_expanded.extension);
+}
+
+static bool file_stat(const fs::path &path, uint64_t &size, int64_t &time) {
+    std::error_code ec;
+    size = fs::file_size(path, ec);
+    if (ec) {
+        return false;
+    }
+
+    const auto write_time = fs::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+
+    time = (int64_t)write_time.time_since_epoch().count();
+    return true;
+}
+
+static void split_path(pcstr full_path, vfs::path &folder, pcstr &filename) {
+    pcstr slash = strrchr(full_path, '/');
+    filename = slash ? slash + 1 : full_path;
+    folder = full_path;
+    folder.resize(filename - full_path);
+}
+
+void save_index_t::open(pcstr folder_path, const std::vector<pcstr> &filenames, pcstr only_extension) {
+    OZZY_PROFILER_SECTION("Game/Save Index/Open");
+    if (!folder.equals(folder_path)) {
+        folder = folder_path;
+        load();
+    }
+
+    auto is_listed_kind = [only_extension] (pcstr filename) {
+        return only_extension ? vfs::file_has_extension(filename, only_extension) : is_savegame(filename);
+    };
+
+    // the folder was listed by the caller, only size and time are asked here, no file is opened
+    std::vector<bool> present(entries.size(), false);
+    bool changed = false;
+    for (pcstr filename : filenames) {
+        if (!is_listed_kind(filename)) {
+            continue;
+        }
+
+        uint64_t size = 0;
+        int64_t time = 0;
+        if (!file_stat(fs::path(vfs::content_path(vfs::path(folder, filename)).c_str()), size, time)) {
+            continue;
+        }
+
+        entry_t *entry = find_or_add(filename);
+        const size_t index = entry - entries.data();
+        present.resize(entries.size(), false);
+        present[index] = true;
+        if (entry->file_size != size || entry->file_time != time) {
+            entry->file_size = size;
+            entry->file_time = time;
+            entry->stale = true;
+            changed = true;
+        }
+    }
+
+    // forget files removed behind our back
+    for (int i = (int)entries.size() - 1; i >= 0; --i) {
+        if (!present[i] && is_listed_kind(entries[i].filename)) {
+            entries.erase(entries.begin() + i);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        write();
+    }
+}
+
+const save_index_t::entry_t *save_index_t::find(pcstr filename) const {
+    for (const auto &entry : entries) {
+        if (strcmp(entry.filename, filename) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+save_index_t::entry_t *save_index_t::find_or_add(pcstr filename) {
+    if (const entry_t *entry = find(filename)) {
+        return const_cast<entry_t *>(entry);
+    }
+
+    entries.emplace_back();
+    entry_t &entry = entries.back();
+    strncpy_safe(entry.filename, filename, MAX_FILE_NAME);
+    return &entry;
+}
+
+bool save_index_t::refresh(FileIOManager &reader, entry_t &entry) {
+    entry.stale = false;
+    const vfs::path full(folder, entry.filename);
+    if (!GamestateIO::read_savegame_chunks(reader, full, {"scenario_map_name", "game_time", "city_data"})) {
+        logs::info("Save index: unable to read header of %s", full.c_str());
+        entry.version = -1;
+        return false;
+    }
+
+    entry.version = reader.get_file_version();
+
+    buffer *name = reader.find_chunk("scenario_map_name")->buf;
+    name->reset_offset();
+    name->read_raw(entry.scenario_name, MAX_SCENARIO_NAME);
+    entry.scenario_name[MAX_SCENARIO_NAME - 1] = 0;
+
+    buffer *time = reader.find_chunk("game_time")->buf;
+    time->set_offset(game_time_month_offset);
+    entry.month = time->read_i16();
+    time->set_offset(game_time_year_offset);
+    entry.year = time->read_i16();
+
+    buffer *city = reader.find_chunk("city_data")->buf;
+    city->set_offset(city_data_population_offset);
+    entry.population = city->read_i32();
+    city->set_offset(city_data_treasury_offset);
+    entry.treasury = city->read_i32();
+    return true;
+}
+
+void save_index_t::refresh_stale(int budget) {
+    const bool any_stale = std::any_of(entries.begin(), entries.end(), [] (const entry_t &entry) { return entry.stale; });
+    if (!any_stale) {
+        reader.reset(); // the chunk buffers of a whole save schema are not worth keeping around
+        return;
+    }
+
+    // headers are read by a reader of our own, FILEIO keeps the state of the game in play
+    if (!reader) {
+        reader = std::make_unique<FileIOManager>(/*detached*/true);
+    }
+
+    bool changed = false;
+    for (auto &entry : entries) {
+        if (budget <= 0) {
+            break;
+        }
+
+        if (entry.stale) {
+            refresh(*reader, entry);
+            changed = true;
+            --budget;
+        }
+    }
+
+    if (changed) {
+        write();
+    }
+}
+
+void save_index_t::on_save_written(pcstr full_path) {
+    vfs::path save_folder;
+    pcstr filename = nullptr;
+    split_path(full_path, save_folder, filename);
+    if (!folder.equals(save_folder)) {
+        folder = save_folder;
+        load();
+    }
+
+    // the city in memory is exactly what was written, no need to read it back
+    entry_t &entry = *find_or_add(filename);
+    file_stat(fs::path(vfs::content_path(full_path).c_str()), entry.file_size, entry.file_time);
+    entry.version = latest_save_version;
+    memcpy(entry.scenario_name, scenario_name(), MAX_SCENARIO_NAME);
+    entry.month = game.simtime.month;
+    entry.year = game.simtime.year;
+    entry.population = g_city.population.current;
+    entry.treasury = g_city.finance.treasury.value;
+    entry.stale = false;
+    write();
+}
+
+void save_index_t::on_save_removed(pcstr full_path) {
+    vfs::path save_folder;
+    pcstr filename = nullptr;
+    split_path(full_path, save_folder, filename);
+    if (!folder.equals(save_folder)) {
+        return;
+    }
+
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (strcmp(it->filename, filename) == 0) {
+            entries.erase(it);
+            write();
+            return;
+        }
+    }
+}
+
+void save_index_t::load() {
+    entries.clear();
+    const vfs::path index_path(folder, SAVE_INDEX_FILE);
+    FILE *fp = vfs::file_open_os(vfs::content_path(index_path), "rb");
+    if (!fp) {
+        return;
+    }
+
+    uint32_t header[3] = {0};
+    if (fread(header, sizeof(uint32_t), 3, fp) != 3 || header[0] != SAVE_INDEX_MAGIC || header[1] != SAVE_INDEX_VERSION) {
+        vfs::file_close(fp);
+        return;
+    }
+
+    entries.resize(header[2]);
+    for (auto &entry : entries) {
+        bool ok = fread(entry.filename, MAX_FILE_NAME, 1, fp) == 1;
+        ok = ok && fread(&entry.file_size, sizeof(entry.file_size), 1, fp) == 1;
+        ok = ok && fread(&entry.file_time, sizeof(entry.file_time), 1, fp) == 1;
+        ok = ok && fread(&entry.version, sizeof(entry.version), 1, fp) == 1;
+        ok = ok && fread(entry.scenario_name, MAX_SCENARIO_NAME, 1, fp) == 1;
+        ok = ok && fread(&entry.month, sizeof(entry.month), 1, fp) == 1;
+        ok = ok && fread(&entry.year, sizeof(entry.year), 1, fp) == 1;
+        ok = ok && fread(&entry.population, sizeof(entry.population), 1, fp) == 1;
+        ok = ok && fread(&entry.treasury, sizeof(entry.treasury), 1, fp) == 1;
+        if (!ok) {
+            entries.clear();
+            break;
+        }
+        entry.filename[MAX_FILE_NAME - 1] = 0;
+        entry.stale = false;
+    }
+
+    vfs::file_close(fp);
+}
+
+void save_index_t::write() {
+    const vfs::path index_path(folder, SAVE_INDEX_FILE);
+    FILE *fp = vfs::file_open_os(vfs::content_path(index_path), "wb");
+    if (!fp) {
+        logs::info("Save index: unable to write %s", index_path.c_str());
+        return;
+    }
+
+    // stale entries are written with a zero time, so they are re-read next time
+    const uint32_t header[3] = {SAVE_INDEX_MAGIC, SAVE_INDEX_VERSION, (uint32_t)entries.size()};
+    fwrite(header, sizeof(uint32_t), 3, fp);
+    for (const auto &entry : entries) {
+        const int64_t file_time = entry.stale ? 0 : entry.file_time;
+        fwrite(entry.filename, MAX_FILE_NAME, 1, fp);
+        fwrite(&entry.file_size, sizeof(entry.file_size), 1, fp);
+        fwrite(&file_time, sizeof(file_time), 1, fp);
+        fwrite(&entry.version, sizeof(entry.version), 1, fp);
+        fwrite(entry.scenario_name, MAX_SCENARIO_NAME, 1, fp);
+        fwrite(&entry.month, sizeof(entry.month), 1, fp);
+        fwrite(&entry.year, sizeof(entry.year), 1, fp);
+        fwrite(&entry.population, sizeof(entry.population), 1, fp);
+        fwrite(&entry.treasury, sizeof(entry.treasury), 1, fp);
+    }
+
+    vfs::file_close(fp);
+    vfs::sync_em_fs();
+}
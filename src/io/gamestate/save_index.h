@@ -0,0 +1,51 @@
+#pragma once
+
+#include "content/dir.h"
+#include "content/vfs.h"
+#include "game/game_environment.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class FileIOManager;
+
+// Per-folder cache of savegame details, kept next to the saves in "saves.idx".
+// Entries written by this game are filled from the live city when the save is written,
+// files found on disk with another size or time are marked stale and re-read later,
+// a few per frame, from their header chunks only.
+struct save_index_t {
+    struct entry_t {
+        char filename[MAX_FILE_NAME] = "";
+        uint64_t file_size = 0;
+        int64_t file_time = 0;
+        int32_t version = -1;
+        uint8_t scenario_name[MAX_SCENARIO_NAME] = {0};
+        int16_t month = 0;
+        int16_t year = 0;
+        int32_t population = 0;
+        int32_t treasury = 0;
+        bool stale = true;
+    };
+
+    vfs::path folder;
+    std::vector<entry_t> entries;
+    std::unique_ptr<FileIOManager> reader;
+
+    // filenames come from the listing the dialog already made, only entries with
+    // only_extension (or any savegame extension when null) are checked against it
+    void open(pcstr folder_path, const std::vector<pcstr> &filenames, pcstr only_extension = nullptr);
+    const entry_t *find(pcstr filename) const;
+    void refresh_stale(int budget);
+
+    void on_save_written(pcstr full_path);
+    void on_save_removed(pcstr full_path);
+
+private:
+    entry_t *find_or_add(pcstr filename);
+    bool refresh(FileIOManager &reader, entry_t &entry);
+    void load();
+    void write();
+};
+
+extern save_index_t g_save_index;
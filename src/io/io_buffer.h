@@ -58,6 +58,32 @@ private:
     // into a single generalized form.
     bool io_sync(chunk_buffer_access_e flag, size_t version);
 
+    template <bind_signature_e S>
+    auto read_field() {
+        if constexpr (S == BIND_SIGNATURE_INT8) return p_buf->read_i8();
+        else if constexpr (S == BIND_SIGNATURE_UINT8) return p_buf->read_u8();
+        else if constexpr (S == BIND_SIGNATURE_INT16) return p_buf->read_i16();
+        else if constexpr (S == BIND_SIGNATURE_UINT16) return p_buf->read_u16();
+        else if constexpr (S == BIND_SIGNATURE_INT32) return p_buf->read_i32();
+        else if constexpr (S == BIND_SIGNATURE_UINT32) return p_buf->read_u32();
+        else if constexpr (S == BIND_SIGNATURE_INT64) return p_buf->read_i64();
+        else if constexpr (S == BIND_SIGNATURE_UINT64) return p_buf->read_u64();
+        else static_assert(S == BIND_SIGNATURE_INT8, "not a scalar bind signature");
+    }
+
+    template <bind_signature_e S, typename T>
+    void write_field(const T &value) {
+        if constexpr (S == BIND_SIGNATURE_INT8) p_buf->write_i8(value);
+        else if constexpr (S == BIND_SIGNATURE_UINT8) p_buf->write_u8(value);
+        else if constexpr (S == BIND_SIGNATURE_INT16) p_buf->write_i16(value);
+        else if constexpr (S == BIND_SIGNATURE_UINT16) p_buf->write_u16(value);
+        else if constexpr (S == BIND_SIGNATURE_INT32) p_buf->write_i32(value);
+        else if constexpr (S == BIND_SIGNATURE_UINT32) p_buf->write_u32(value);
+        else if constexpr (S == BIND_SIGNATURE_INT64) p_buf->write_i64(value);
+        else if constexpr (S == BIND_SIGNATURE_UINT64) p_buf->write_u64(value);
+        else static_assert(S == BIND_SIGNATURE_INT8, "not a scalar bind signature");
+    }
+
 protected:
     bool inherited = false;
     virtual void bind_data(size_t version) {
@@ -75,32 +101,33 @@ public:
     // this will CHECK that the buffer is valid and RESET the buffer pointer
     bool validate();
 
-    // called for every data field in the chunk.
-    // writes/reads from the buffer depending on the signature
-    // and the selected access type -- must be implemented HERE
-    // in the header file, since it's a TEMPLATE function.
-    template <typename T>
-    void bind(bind_signature_e signature, T* ext) {
+    // called for every data field in the chunk, with the field type known at compile time,
+    // so record schemas like buildings and figures compile down to straight reads/writes.
+    template <bind_signature_e S, typename T>
+    void bind(T* ext) {
         if (ext == nullptr)
             return;
 
+        if (access_type == CHUNK_ACCESS_READ) {
+            *ext = (T)read_field<S>();
+        } else if (access_type == CHUNK_ACCESS_WRITE) {
+            write_field<S>(*ext);
+        }
+    }
+
+    // runtime signature variant of the above, for the chunks that are not per record.
+    // must be implemented HERE in the header file, since it's a TEMPLATE function.
+    template <typename T>
+    void bind(bind_signature_e signature, T* ext) {
         switch (signature) {
-        case BIND_SIGNATURE_INT8:
-            IO_BRANCH(*ext = (T)p_buf->read_i8(), p_buf->write_i8(*ext))
-        case BIND_SIGNATURE_UINT8:
-            IO_BRANCH(*ext = (T)p_buf->read_u8(), p_buf->write_u8(*ext))
-        case BIND_SIGNATURE_INT16:
-            IO_BRANCH(*ext = (T)p_buf->read_i16(), p_buf->write_i16(*ext))
-        case BIND_SIGNATURE_UINT16:
-            IO_BRANCH(*ext = (T)p_buf->read_u16(), p_buf->write_u16(*ext))
-        case BIND_SIGNATURE_INT32:
-            IO_BRANCH(*ext = (T)p_buf->read_i32(), p_buf->write_i32(*ext))
-        case BIND_SIGNATURE_UINT32:
-            IO_BRANCH(*ext = (T)p_buf->read_u32(), p_buf->write_u32(*ext))
-        case BIND_SIGNATURE_INT64:
-            IO_BRANCH(*ext = (T)p_buf->read_i64(), p_buf->write_i64(*ext))
-        case BIND_SIGNATURE_UINT64:
-            IO_BRANCH(*ext = (T)p_buf->read_u64(), p_buf->write_u64(*ext))
+        case BIND_SIGNATURE_INT8: return bind<BIND_SIGNATURE_INT8>(ext);
+        case BIND_SIGNATURE_UINT8: return bind<BIND_SIGNATURE_UINT8>(ext);
+        case BIND_SIGNATURE_INT16: return bind<BIND_SIGNATURE_INT16>(ext);
+        case BIND_SIGNATURE_UINT16: return bind<BIND_SIGNATURE_UINT16>(ext);
+        case BIND_SIGNATURE_INT32: return bind<BIND_SIGNATURE_INT32>(ext);
+        case BIND_SIGNATURE_UINT32: return bind<BIND_SIGNATURE_UINT32>(ext);
+        case BIND_SIGNATURE_INT64: return bind<BIND_SIGNATURE_INT64>(ext);
+        case BIND_SIGNATURE_UINT64: return bind<BIND_SIGNATURE_UINT64>(ext);
 
         default:
             assert(false);
@@ -2,11 +2,16 @@
 #include "core/string.h"
 #include "core/log.h"
 #include "core/zip.h"
+#include "core/profiler.h"
 #include "io/gamestate/boilerplate.h"
 #include "platform/platform.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <string.h>
+#include <chrono>
+
+#include "zlib/zlib.h"
 
 #define COMPRESS_BUFFER_SIZE 3000000
 #define UNCOMPRESSED 0x80000000
@@ -51,7 +56,8 @@ buffer* FileIOManager::push_chunk(int size, bool compressed, const char* name, i
     strncpy(chunk.name, name, 99);
 
     // fill io_buffer content
-    if (iob != nullptr) {
+    chunk.iob = nullptr;
+    if (iob != nullptr && !detached) {
         iob->hook(chunk.buf, size, compressed, name);
         chunk.iob = iob;
         chunk.VALID = true;
@@ -110,7 +116,62 @@ static void log_hex(file_chunk_t* chunk, int i, int offs, int num_chunks) {
 }
 
 static char compress_buffer[COMPRESS_BUFFER_SIZE];
-static bool read_compressed_chunk(FILE* fp, buffer* buf, int filepiece_size) {
+
+static bool zlib_compress(const void *input, int input_length, void *output, int *output_length, int level) {
+    z_stream stream = {};
+    if (deflateInit(&stream, level) != Z_OK) {
+        return false;
+    }
+
+    stream.next_in = (Bytef *)input;
+    stream.avail_in = input_length;
+    stream.next_out = (Bytef *)output;
+    stream.avail_out = *output_length;
+    const int err = deflate(&stream, Z_FINISH);
+    *output_length = (int)stream.total_out;
+    deflateEnd(&stream);
+    return err == Z_STREAM_END;
+}
+
+static int zlib_decompress(const void *input, int input_length, void *output, int output_length) {
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK) {
+        return -1;
+    }
+
+    stream.next_in = (Bytef *)input;
+    stream.avail_in = input_length;
+    stream.next_out = (Bytef *)output;
+    stream.avail_out = output_length;
+    const int err = inflate(&stream, Z_FINISH);
+    const int result = (err == Z_STREAM_END) ? (int)stream.total_out : -1;
+    inflateEnd(&stream);
+    return result;
+}
+
+static bool chunk_compress(e_chunk_codec codec, int level, const void *input, int input_length, void *output, int *output_length) {
+    switch (codec) {
+    case CHUNK_CODEC_PKWARE: return zip_compress(input, input_length, output, output_length);
+    case CHUNK_CODEC_ZLIB: return zlib_compress(input, input_length, output, output_length, level);
+    }
+    return false;
+}
+
+static int chunk_decompress(e_chunk_codec codec, const void *input, int input_length, void *output, int output_length) {
+    switch (codec) {
+    case CHUNK_CODEC_PKWARE: return zip_decompress(input, input_length, output, &output_length);
+    case CHUNK_CODEC_ZLIB: return zlib_decompress(input, input_length, output, output_length);
+    }
+    return -1;
+}
+
+// compressed chunk header: 32-bit size of the compressed data (or UNCOMPRESSED),
+// followed since chunk_codec_save_version by the 32-bit codec id
+static int chunk_header_size(int file_version) {
+    return file_version >= chunk_codec_save_version ? 8 : 4;
+}
+
+static bool read_compressed_chunk(FILE* fp, buffer* buf, int filepiece_size, int file_version) {
     // check that the stream size isn't above maximum temp buffer
     if (filepiece_size > COMPRESS_BUFFER_SIZE)
         return false;
@@ -119,6 +180,11 @@ static bool read_compressed_chunk(FILE* fp, buffer* buf, int filepiece_size) {
     uint32_t chunk_size = 0;
     fread(&chunk_size, 4, 1, fp);
 
+    uint32_t codec = CHUNK_CODEC_PKWARE;
+    if (file_version >= chunk_codec_save_version) {
+        fread(&codec, 4, 1, fp);
+    }
+
     // if file signature says "uncompressed" well man, it's uncompressed. read as normal ignoring the directive
     if ((unsigned int)chunk_size == UNCOMPRESSED) {
         if (buf->from_file(filepiece_size, fp) != filepiece_size)
@@ -130,35 +196,40 @@ static bool read_compressed_chunk(FILE* fp, buffer* buf, int filepiece_size) {
             logs::info("Incorrect chunk size, expected %i, found %i", chunk_size, csize);
             return false;
         }
-        int bsize = zip_decompress(compress_buffer, chunk_size, buf->data_unsafe_pls_use_carefully(), &filepiece_size);
+        int bsize = chunk_decompress((e_chunk_codec)codec, compress_buffer, chunk_size, buf->data_unsafe_pls_use_carefully(), filepiece_size);
         if (bsize != buf->size()) {
-            logs::info("Incorrect buffer size, expected %u, found %i", buf->size(), bsize);
+            logs::info("Incorrect buffer size, expected %u, found %i (codec %u)", buf->size(), bsize, codec);
             return false;
         }
-        //        if (fread(compress_buffer, 1, chunk_size, fp) != chunk_size
-        //            || zip_decompress(compress_buffer, chunk_size, buf->data_unsafe_pls_use_carefully(),
-        //            &filepiece_size) !=
-        //               buf->size())
-        //            return 0;
     }
     //    buf->force_validate_unsafe_pls_use_carefully();
 
     return true;
 }
-static bool write_compressed_chunk(FILE* fp, buffer* buf, int bytes_to_write) {
+static bool write_compressed_chunk(FILE* fp, buffer* buf, int bytes_to_write, int file_version, e_chunk_codec codec, int level) {
     if (bytes_to_write > COMPRESS_BUFFER_SIZE)
         return false;
 
+    const bool has_codec = file_version >= chunk_codec_save_version;
+    if (!has_codec) {
+        codec = CHUNK_CODEC_PKWARE;
+    }
+
     int output_size = COMPRESS_BUFFER_SIZE;
-    if (zip_compress(buf->get_data(), bytes_to_write, compress_buffer, &output_size)) {
-        //        write_int32(fp, output_size);
+    const uint32_t codec_id = codec;
+    if (chunk_compress(codec, level, buf->get_data(), bytes_to_write, compress_buffer, &output_size) && output_size < bytes_to_write) {
         fwrite(&output_size, 4, 1, fp);
+        if (has_codec) {
+            fwrite(&codec_id, 4, 1, fp);
+        }
         fwrite(compress_buffer, 1, output_size, fp);
     } else {
         // unable to compress: write uncompressed
-        //        write_int32(fp, UNCOMPRESSED);
         output_size = UNCOMPRESSED;
         fwrite(&output_size, 4, 1, fp);
+        if (has_codec) {
+            fwrite(&codec_id, 4, 1, fp);
+        }
         fwrite(buf->get_data(), 1, bytes_to_write, fp);
     }
     return true;
@@ -177,7 +248,7 @@ bool FileIOManager::io_failure_cleanup(const char* action, const char* reason) {
     return false;
 }
 
-bool FileIOManager::serialize(const char* filename, int offset, e_file_format format, const int version, void (*init_schema)(e_file_format _format, const int _version)) {
+bool FileIOManager::serialize(const char* filename, int offset, e_file_format format, const int version, void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version)) {
     // first, clear up the manager data and set the new file info
     clear();
     strncpy_safe(file_path, filename, MAX_FILE_NAME);
@@ -196,7 +267,7 @@ bool FileIOManager::serialize(const char* filename, int offset, e_file_format fo
 
     // init file chunks and buffer collection
     if (init_schema != nullptr) {
-        init_schema(file_format, file_version);
+        init_schema(*this, file_format, file_version);
     } else {
         return io_failure_cleanup("write", "provided schema is invalid");
     }
@@ -213,7 +284,7 @@ bool FileIOManager::serialize(const char* filename, int offset, e_file_format fo
 
         int result = 0;
         if (chunk->compressed) {
-            result = write_compressed_chunk(fp, chunk->buf, chunk->buf->size());
+            result = write_compressed_chunk(fp, chunk->buf, chunk->buf->size(), file_version, save_codec, save_level);
         } else {
             result = chunk->buf->to_file(chunk->buf->size(), fp);
         }
@@ -238,9 +309,9 @@ bool FileIOManager::serialize(const char* filename, int offset, e_file_format fo
     return true;
 }
 
-bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format,
-                                const int (*determine_file_version)(pcstr fnm, int ofst),
-                                void (*init_schema)(e_file_format _format, const int _version)) {
+bool FileIOManager::open_for_read(FILE*& fp, pcstr filename, int offset, e_file_format format,
+                                  const int (*determine_file_version)(pcstr fnm, int ofst),
+                                  void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version)) {
     // first, clear up the manager data and set the new file info
     clear();
     strncpy_safe(file_path, filename, MAX_FILE_NAME);
@@ -249,7 +320,7 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
 
     // open file handle
     vfs::path fs_path = vfs::content_file(file_path);
-    FILE* fp = vfs::file_open_os(fs_path, "rb");
+    fp = vfs::file_open_os(fs_path, "rb");
     if (!fp) {
         logs::error("Unable to read file [%s], file could not be accessed.", fs_path.c_str());
         clear();
@@ -265,6 +336,7 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
         file_version = determine_file_version(file_path, offset);
         if (file_version == -1) {
             logs::info("Unable to read file [%s], file version/format is invalid ", filename);
+            vfs::file_close(fp);
             clear();
             return false;
         }
@@ -272,13 +344,123 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
 
     // init file chunks and buffer collection
     if (init_schema != nullptr) {
-        init_schema(file_format, file_version);
+        init_schema(*this, file_format, file_version);
     } else {
         logs::error("Unable to read file [%s], provided schema is invalid.", fs_path.c_str());
+        vfs::file_close(fp);
         clear();
         return false;
     }
 
+    for (int i = 0; i < num_chunks(); ++i) {
+        file_chunks.at(i).file_pos = -1;
+        file_chunks.at(i).stored_size = 0;
+    }
+
+    return true;
+}
+
+bool FileIOManager::index_chunks(FILE* fp) {
+    // walk the chunk sequence reading only the size headers of compressed chunks
+    for (int i = 0; i < num_chunks(); i++) {
+        file_chunk_t* chunk = &file_chunks.at(i);
+        chunk->file_pos = ftell(fp);
+        chunk->stored_size = (int)chunk->buf->size();
+        if (chunk->compressed) {
+            uint32_t chunk_size = 0;
+            if (fread(&chunk_size, 4, 1, fp) != 1) {
+                return false;
+            }
+            chunk->stored_size = chunk_header_size(file_version) + (chunk_size == UNCOMPRESSED ? (int)chunk->buf->size() : (int)chunk_size);
+        }
+
+        if (fseek(fp, chunk->file_pos + chunk->stored_size, SEEK_SET) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+const file_chunk_t* FileIOManager::find_chunk(pcstr name) {
+    for (int i = 0; i < num_chunks(); ++i) {
+        if (strcmp(file_chunks.at(i).name, name) == 0) {
+            return &file_chunks.at(i);
+        }
+    }
+    return nullptr;
+}
+
+bool FileIOManager::unserialize_chunks(pcstr filename, int offset, e_file_format format,
+                                       const int (*determine_file_version)(pcstr fnm, int ofst),
+                                       void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version),
+                                       std::initializer_list<pcstr> names) {
+    FILE* fp = nullptr;
+    if (!open_for_read(fp, filename, offset, format, determine_file_version, init_schema)) {
+        return false;
+    }
+
+    if (!index_chunks(fp)) {
+        logs::error("Unable to index file [%s], chunk headers are truncated.", file_path);
+        vfs::file_close(fp);
+        clear();
+        return false;
+    }
+
+    // read only the requested chunks, in schema order
+    std::vector<file_chunk_t*> selected;
+    for (pcstr name : names) {
+        file_chunk_t* chunk = const_cast<file_chunk_t*>(find_chunk(name));
+        if (!chunk) {
+            logs::error("Unable to read file [%s], chunk [%s] is not in the schema.", file_path, name);
+            vfs::file_close(fp);
+            clear();
+            return false;
+        }
+        selected.push_back(chunk);
+    }
+    std::sort(selected.begin(), selected.end(), [] (const file_chunk_t* a, const file_chunk_t* b) { return a->file_pos < b->file_pos; });
+
+    for (file_chunk_t* chunk : selected) {
+        fseek(fp, chunk->file_pos, SEEK_SET);
+        const bool result = chunk->compressed
+                                ? read_compressed_chunk(fp, chunk->buf, chunk->buf->size(), file_version)
+                                : chunk->buf->from_file(chunk->buf->size(), fp) == chunk->buf->size();
+        if (!result) {
+            logs::error("Unable to read file [%s] chunk [%s].", file_path, chunk->name);
+            vfs::file_close(fp);
+            clear();
+            return false;
+        }
+    }
+
+    vfs::file_close(fp);
+
+    for (file_chunk_t* chunk : selected) {
+        if (chunk->VALID) {
+            chunk->iob->read(file_version);
+        }
+    }
+
+    logs::info("File chunks read: %s %i@ (%u of %i chunks) --- VERSION HEADER: %i ---",
+               file_path,
+               file_offset,
+               (unsigned)selected.size(),
+               num_chunks(),
+               file_version);
+
+    return true;
+}
+
+bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format,
+                                const int (*determine_file_version)(pcstr fnm, int ofst),
+                                void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version)) {
+    FILE* fp = nullptr;
+    if (!open_for_read(fp, filename, offset, format, determine_file_version, init_schema)) {
+        return false;
+    }
+    vfs::path fs_path = vfs::content_file(file_path);
+
     // read file contents into buffers
     for (int i = 0; i < num_chunks(); i++) {
         file_chunk_t* chunk = &file_chunks.at(i);
@@ -286,10 +468,11 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
         fname = chunk->name;
 
         long offs = ftell(fp);
+        chunk->file_pos = offs;
 
         bool result = false;
         if (chunk->compressed) {
-            result = read_compressed_chunk(fp, chunk->buf, chunk->buf->size());
+            result = read_compressed_chunk(fp, chunk->buf, chunk->buf->size(), file_version);
             if (!result) {
                 logs::error("Unable to read file[%s] chunk[%s], decompression failed.", fs_path.c_str(), chunk->name);
                 clear();
@@ -307,6 +490,8 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
             }
         }
 
+        chunk->stored_size = (int)(ftell(fp) - offs);
+
         // ******** DEBUGGING ********
         export_unzipped(chunk); // export uncompressed buffer data to zip folder
         if (true) {
@@ -331,4 +516,60 @@ bool FileIOManager::unserialize(pcstr filename, int offset, e_file_format format
                file_version);
 
     return true;
-}
\ No newline at end of file
+}
+
+std::vector<chunk_codec_benchmark_t> FileIOManager::benchmark_codecs() {
+    OZZY_PROFILER_SECTION("Game/Save/Codec Benchmark");
+    struct variant_t {
+        pcstr name;
+        e_chunk_codec codec;
+        int level;
+    };
+
+    const variant_t variants[] = {
+        {"pkware", CHUNK_CODEC_PKWARE, 0},
+        {"zlib-1", CHUNK_CODEC_ZLIB, 1},
+        {"zlib-6", CHUNK_CODEC_ZLIB, 6},
+        {"zlib-9", CHUNK_CODEC_ZLIB, 9},
+    };
+
+    using clock = std::chrono::steady_clock;
+    auto elapsed_ms = [] (clock::time_point from) {
+        return std::chrono::duration<float, std::milli>(clock::now() - from).count();
+    };
+
+    std::vector<chunk_codec_benchmark_t> result;
+    std::vector<uint8_t> unpacked;
+    for (const auto &variant : variants) {
+        chunk_codec_benchmark_t bench = {variant.name, 0, 0, 0.f, 0.f};
+        for (int i = 0; i < num_chunks(); ++i) {
+            const buffer *buf = file_chunks.at(i).buf;
+            const int size = (int)buf->size();
+            if (size > COMPRESS_BUFFER_SIZE) {
+                continue;
+            }
+
+            int packed = COMPRESS_BUFFER_SIZE;
+            auto start = clock::now();
+            const bool ok = chunk_compress(variant.codec, variant.level, buf->get_data(), size, compress_buffer, &packed) && packed < size;
+            bench.compress_ms += elapsed_ms(start);
+            bench.raw_size += size;
+            if (!ok) {
+                bench.packed_size += size;
+                continue;
+            }
+
+            unpacked.resize(size);
+            start = clock::now();
+            const int unpacked_size = chunk_decompress(variant.codec, compress_buffer, packed, unpacked.data(), size);
+            bench.decompress_ms += elapsed_ms(start);
+            if (unpacked_size != size || memcmp(unpacked.data(), buf->get_data(), size) != 0) {
+                logs::error("Codec %s: chunk %s does not round trip", variant.name, file_chunks.at(i).name);
+            }
+            bench.packed_size += packed;
+        }
+        result.push_back(bench);
+    }
+
+    return result;
+}
@@ -5,14 +5,34 @@
 #include "content/file_formats.h"
 #include "io/io_buffer.h"
 
+#include <initializer_list>
 #include <vector>
 
+// compression of the chunks flagged as compressed, recorded in the chunk header since chunk_codec_save_version;
+// older files are always PKWare DCL implode, as written by the original game
+enum e_chunk_codec : uint32_t {
+    CHUNK_CODEC_PKWARE = 0,
+    CHUNK_CODEC_ZLIB = 1,
+};
+
+struct chunk_codec_benchmark_t {
+    pcstr name;
+    int64_t raw_size;
+    int64_t packed_size;
+    float compress_ms;
+    float decompress_ms;
+};
+
 struct file_chunk_t {
     bool VALID = false;
     buffer* buf = nullptr;
     io_buffer* iob = nullptr;
     int compressed;
     char name[100];
+
+    // chunk directory, filled when the file is read or indexed
+    long file_pos = -1;   // position of the chunk in the file (its size header for compressed chunks)
+    int stored_size = 0;  // bytes the chunk takes on disk, size header included
 };
 
 // Robust class system needed for reading/writing savestate files.
@@ -31,6 +51,9 @@ struct file_chunk_t {
 //      > read the file contents into the chunk cache (io_buffer sequence)
 //      > close the file handle
 //      > load the GAME STATE into the engine from the chunk cache
+// - for previews only a few named chunks can be read: the file is indexed first
+//   (size headers only, nothing is decompressed), then only those chunks are read
+//   and loaded, the rest of the game state is left alone
 
 class FileIOManager {
 private:
@@ -45,9 +68,22 @@ private:
     std::vector<file_chunk_t> file_chunks;
     int alloc_index = 0;
 
+    e_chunk_codec save_codec = CHUNK_CODEC_ZLIB;
+    int save_level = 1;
+    bool detached = false;
+
     void clear();
     bool io_failure_cleanup(const char* action, const char* reason); // because I'm anal about reusing code...
+    bool open_for_read(FILE*& fp, pcstr filename, int offset, e_file_format format, const int (*determine_file_version)(pcstr _filename, int _offset),
+                       void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version));
+    bool index_chunks(FILE* fp);
 public:
+    FileIOManager() = default;
+
+    // a detached manager only fills its own chunk buffers, its schema never hooks the game state
+    // io_buffers, so it can read file headers (see find_chunk) while FILEIO stays untouched
+    explicit FileIOManager(bool detached_reader) : detached(detached_reader) {}
+
     // push parametric chunk onto the schema
     buffer* push_chunk(int size, bool compressed, const char* name, io_buffer* iob);
 
@@ -60,9 +96,21 @@ public:
     }
 
     // write/read internal chunk cache (io_buffer sequence) to/from disk file
-    bool serialize(const char* filename, int offset, e_file_format format, const int version, void (*init_schema)(e_file_format _format, const int _version));
+    bool serialize(const char* filename, int offset, e_file_format format, const int version, void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version));
     bool unserialize(pcstr filename, int offset, e_file_format format, const int (*determine_file_version)(pcstr _filename, int _offset),
-                     void (*init_schema)(e_file_format _format, const int _version));
+                     void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version));
+
+    // read and load only the named chunks, seeking over all the others
+    bool unserialize_chunks(pcstr filename, int offset, e_file_format format, const int (*determine_file_version)(pcstr _filename, int _offset),
+                            void (*init_schema)(FileIOManager &io, e_file_format _format, const int _version), std::initializer_list<pcstr> names);
+
+    const file_chunk_t* find_chunk(pcstr name);
+
+    // codec for the compressed chunks of the next serialize(), the level is codec specific
+    void set_save_codec(e_chunk_codec codec, int level) { save_codec = codec; save_level = level; }
+
+    // compresses and decompresses the chunk buffers of the last file read or written with every codec
+    std::vector<chunk_codec_benchmark_t> benchmark_codecs();
 };
 
 extern FileIOManager FILEIO;
@@ -2,7 +2,11 @@
 
 #include "core/log.h"
 
-#ifdef GAME_PLATFORM_WIN
+#ifdef GAME_HAS_FFMPEG
+
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include <string.h>
 
 extern "C" {
 	//#include <x264.h>
@@ -10,17 +14,15 @@ extern "C" {
 	#include <libavcodec/avcodec.h>
 	#include <libavutil/mathematics.h>
 	#include <libavformat/avformat.h>
-	#include <libavformat/avio_internal.h>
-	#include <libavformat/url.h>
 	#include <libavutil/opt.h>
 }
 
 MovieWriter::MovieWriter(const std::string& filename, const unsigned int width_, const unsigned int height_, const int frameRate_) :
-	width(width_), height(height_), iframe(0), frameRate(frameRate_), pixels(4 * width * height) 
+	width(width_), height(height_), iframe(0), frameRate(frameRate_)
 {
-	// Preparing to convert my generated RGB images to YUV frames.
-	swsCtx = sws_getContext(width, height, AV_PIX_FMT_RGB24, width, height, AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR, NULL, NULL, NULL);
-	pkt = new AVPacket();
+	// Screen readback is BGRA, convert it straight to YUV frames.
+	swsCtx = sws_getContext(width, height, AV_PIX_FMT_BGRA, width, height, AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR, NULL, NULL, NULL);
+	pkt = av_packet_alloc();
 
 	// Preparing the data concerning the format and codec,
 	// in order to write properly the header, frame data and end of file.
@@ -33,8 +35,24 @@ MovieWriter::MovieWriter(const std::string& filename, const unsigned int width_,
 	fmt = av_guess_format(ext.c_str(), NULL, NULL);
 	avformat_alloc_output_context2(&fc, NULL, NULL, filename.c_str());
 
-	// Setting up the codec.
+	if (!fc) {
+		logs::error("Could not allocate output context for %s", filename.c_str());
+		return;
+	}
+
+	// Setting up the codec, linux builds often come without libvpx so fall back to the container default.
 	const AVCodec* codec = avcodec_find_encoder_by_name("libvpx-vp9");
+	if (!codec) {
+		codec = avcodec_find_encoder(fc->oformat->video_codec);
+	}
+
+	if (!codec) {
+		logs::error("Could not find video encoder for %s", filename.c_str());
+		avformat_free_context(fc);
+		fc = nullptr;
+		return;
+	}
+
 	AVDictionary* codec_options = NULL;
 	av_dict_set(&codec_options, "crf", "0.5", 0);
 
@@ -44,22 +62,32 @@ MovieWriter::MovieWriter(const std::string& filename, const unsigned int width_,
 	ctx = avcodec_alloc_context3(codec);
 	if (!ctx) {
 		logs::info("Could not allocate video codec context\n");
+		avformat_free_context(fc);
+		fc = nullptr;
+		return;
 	}
 
 	ctx->width = width;
 	ctx->height = height;
 	ctx->pix_fmt = AV_PIX_FMT_YUV420P;
 	ctx->time_base = AVRational{ 1, frameRate };
+	if (fc->oformat->flags & AVFMT_GLOBALHEADER) {
+		ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+	}
 
 	if (avcodec_open2(ctx, codec, &codec_options) < 0) {
 		logs::info("Could not open codec\n");
+		av_dict_free(&codec_options);
+		avcodec_free_context(&ctx);
+		avformat_free_context(fc);
+		fc = nullptr;
+		return;
 	}
 
 	if (avcodec_parameters_from_context(stream->codecpar, ctx) < 0) {
 		logs::info("Could not initialize stream parameters\n");
 	}
 
-	avcodec_open2(ctx, codec, &codec_options);
 	av_dict_free(&codec_options);
 
 	// Once the codec is set up, we need to let the container know
@@ -71,14 +99,6 @@ MovieWriter::MovieWriter(const std::string& filename, const unsigned int width_,
 	int ret = avformat_write_header(fc, &codec_options);
 	av_dict_free(&codec_options);
 
-	// Preparing the containers of the frame data:
-	// Allocating memory for each RGB frame, which will be lately converted to YUV.
-	rgbpic = av_frame_alloc();
-	rgbpic->format = AV_PIX_FMT_RGB24;
-	rgbpic->width = width;
-	rgbpic->height = height;
-	ret = av_frame_get_buffer(rgbpic, 1);
-
 	// Allocating memory for each conversion output YUV frame.
 	yuvpic = av_frame_alloc();
 	yuvpic->format = AV_PIX_FMT_YUV420P;
@@ -91,21 +111,22 @@ MovieWriter::MovieWriter(const std::string& filename, const unsigned int width_,
 	// std::vector<uint8_t> B(width*height*3);
 }
 
-void MovieWriter::addFrame(const uint8_t* pixels, AVFrame** yuvout) {
-	// The AVFrame data will be stored as RGBRGBRGB... row-wise,
-	// from left to right and from top to bottom.
-	for (unsigned int y = 0; y < height; y++) {
-		for (unsigned int x = 0; x < width; x++) {
-			// rgbpic->linesize[0] is equal to width.
-			rgbpic->data[0][y * rgbpic->linesize[0] + 3 * x + 0] = pixels[y * 4 * width + 4 * x + 2];
-			rgbpic->data[0][y * rgbpic->linesize[0] + 3 * x + 1] = pixels[y * 4 * width + 4 * x + 1];
-			rgbpic->data[0][y * rgbpic->linesize[0] + 3 * x + 2] = pixels[y * 4 * width + 4 * x + 0];
-		}
+bool MovieWriter::addFrame(const uint8_t* pixels, AVFrame** yuvout) {
+	if (!valid()) {
+		return false;
+	}
+
+	// encoder may still reference the previous frame buffers
+	if (av_frame_make_writable(yuvpic) < 0) {
+		logs::info("Could not make video frame writable\n");
+		return false;
 	}
 
 	// Not actually scaling anything, but just converting
-	// the RGB data to YUV and store it in yuvpic.
-	sws_scale(swsCtx, rgbpic->data, rgbpic->linesize, 0, height, yuvpic->data, yuvpic->linesize);
+	// the BGRA data to YUV and store it in yuvpic.
+	const uint8_t *src_data[1] = { pixels };
+	const int src_linesize[1] = { 4 * width };
+	sws_scale(swsCtx, src_data, src_linesize, 0, height, yuvpic->data, yuvpic->linesize);
 	
 	if (yuvout) {
 		// The user may be willing to keep the YUV frame
@@ -113,110 +134,326 @@ void MovieWriter::addFrame(const uint8_t* pixels, AVFrame** yuvout) {
 		*yuvout = yuvpic;
 	}
 	
-	addFrame(yuvpic);
+	return addFrame(yuvpic);
 }
 
-// Function to flush the encoder and write remaining frames to disk
-void flush_encoder(AVFormatContext *fmt_ctx, AVCodecContext *codec_ctx, int stream_index) {
-	int ret;
-	AVPacket pkt = {0};
-	av_init_packet(&pkt);
-
-	// Send NULL packet to flush the encoder
-	ret = avcodec_send_frame(codec_ctx, nullptr);
-
-	while (ret >= 0) {
-		ret = avcodec_receive_packet(codec_ctx, &pkt);
+void MovieWriter::writePackets() {
+	while (true) {
+		int ret = avcodec_receive_packet(ctx, pkt);
 		if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-			break;
+			return;
+		}
+
+		if (ret < 0) {
+			logs::info("Error receiving packet from codec, errcode = %d\n", ret);
+			return;
 		}
 
-		// Write the packet to the output file
-		av_packet_rescale_ts(&pkt, codec_ctx->time_base, fmt_ctx->streams[stream_index]->time_base);
-		pkt.stream_index = stream_index;
-		ret = av_interleaved_write_frame(fmt_ctx, &pkt);
+		// We set the packet PTS and DTS taking in the account our FPS (second argument),
+		// and the time base that our selected format uses (third argument).
+		av_packet_rescale_ts(pkt, AVRational{ 1, frameRate }, stream->time_base);
+		pkt->stream_index = stream->index;
 
-		av_packet_unref(&pkt);
+		// Write the encoded frame to the file.
+		av_interleaved_write_frame(fc, pkt);
+		av_packet_unref(pkt);
 	}
 }
 
-void MovieWriter::addFrame(AVFrame* yuvframe) {
-	av_init_packet(pkt);
-	pkt->data = NULL;
-	pkt->size = 0;
+bool MovieWriter::addFrame(AVFrame* yuvframe) {
+	if (!valid()) {
+		return false;
+	}
 
 	// The PTS of the frame are just in a reference unit,
 	// unrelated to the format we are using. We set them,
 	// for instance, as the corresponding frame number.
-	yuvframe->pts = iframe;
+	yuvframe->pts = iframe++;
 
 	int ret = avcodec_send_frame(ctx, yuvframe);
 	if (ret < 0) {
 		logs::info("Error sending frame to codec, errcode = %d\n", ret);
-		return;
+		return false;
 	}
-	
-	ret = avcodec_receive_packet(ctx, pkt);
-	if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
-		logs::info("Error receiving packet from codec, errcode = %d\n", ret);
-		return;
 
-	} else if (ret >= 0) {
-		// We set the packet PTS and DTS taking in the account our FPS (second argument),
-		// and the time base that our selected format uses (third argument).
-		av_packet_rescale_ts(pkt, AVRational{ 1, frameRate }, stream->time_base);
+	writePackets();
+	return true;
+}
 
-		pkt->stream_index = stream->index;
-		logs::info("Writing frame %d (size = %d)\n", iframe++, pkt->size);
+MovieWriter::~MovieWriter() {
+	if (valid()) {
+		// Flushing the encoder and writing the end of the file.
+		if (avcodec_send_frame(ctx, NULL) >= 0) {
+			writePackets();
+		}
+		av_write_trailer(fc);
 
-		// Write the encoded frame to the mp4 file.
-		av_interleaved_write_frame(fc, pkt);
-		av_packet_unref(pkt);
+		if (!(fc->oformat->flags & AVFMT_NOFILE)) {
+			avio_closep(&fc->pb);
+		}
 	}
+
+	// Freeing all the allocated memory:
+	sws_freeContext(swsCtx);
+	av_frame_free(&yuvpic);
+	avcodec_free_context(&ctx);
+	avformat_free_context(fc);
+	av_packet_free(&pkt);
 }
 
-MovieWriter::~MovieWriter() {
-	while (1) {
-		int ret = avcodec_send_frame(ctx, NULL);
-		if (ret == AVERROR_EOF) {
-			break;
-		} else if (ret < 0) {
-			logs::info("Error sending frame to codec, errcode = %d\n", ret);
+// Asynchronous screen readback through pixel buffer objects. glReadPixels into a bound
+// pack buffer returns without waiting for the GPU, the buffer is mapped PBO_COUNT - 1 frames later.
+struct MovieCapture::gl_readback_t {
+	enum { PBO_COUNT = 3 };
+
+	typedef void (APIENTRY *gen_buffers_t)(GLsizei, GLuint *);
+	typedef void (APIENTRY *delete_buffers_t)(GLsizei, const GLuint *);
+	typedef void (APIENTRY *bind_buffer_t)(GLenum, GLuint);
+	typedef void (APIENTRY *buffer_data_t)(GLenum, ptrdiff_t, const void *, GLenum);
+	typedef void *(APIENTRY *map_buffer_range_t)(GLenum, ptrdiff_t, ptrdiff_t, GLbitfield);
+	typedef GLboolean (APIENTRY *unmap_buffer_t)(GLenum);
+	typedef void (APIENTRY *read_pixels_t)(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void *);
+	typedef void (APIENTRY *pixel_store_t)(GLenum, GLint);
+
+	gen_buffers_t gen_buffers = nullptr;
+	delete_buffers_t delete_buffers = nullptr;
+	bind_buffer_t bind_buffer = nullptr;
+	buffer_data_t buffer_data = nullptr;
+	map_buffer_range_t map_buffer_range = nullptr;
+	unmap_buffer_t unmap_buffer = nullptr;
+	read_pixels_t read_pixels = nullptr;
+	pixel_store_t pixel_store = nullptr;
+
+	SDL_Renderer *renderer = nullptr;
+	SDL_Texture *activator = nullptr; // binding it makes the renderer's GL context current
+	GLuint pbos[PBO_COUNT] = {0};
+	bool bottom_up[PBO_COUNT] = {false};
+	uint32_t issued = 0;
+	uint32_t collected = 0;
+	int width = 0;
+	int height = 0;
+
+	bool init(SDL_Renderer *r, int w, int h) {
+		SDL_RendererInfo info;
+		if (SDL_GetRendererInfo(r, &info) != 0 || strcmp(info.name, "opengl") != 0) {
+			return false;
+		}
+
+		gen_buffers = (gen_buffers_t)SDL_GL_GetProcAddress("glGenBuffers");
+		delete_buffers = (delete_buffers_t)SDL_GL_GetProcAddress("glDeleteBuffers");
+		bind_buffer = (bind_buffer_t)SDL_GL_GetProcAddress("glBindBuffer");
+		buffer_data = (buffer_data_t)SDL_GL_GetProcAddress("glBufferData");
+		map_buffer_range = (map_buffer_range_t)SDL_GL_GetProcAddress("glMapBufferRange");
+		unmap_buffer = (unmap_buffer_t)SDL_GL_GetProcAddress("glUnmapBuffer");
+		read_pixels = (read_pixels_t)SDL_GL_GetProcAddress("glReadPixels");
+		pixel_store = (pixel_store_t)SDL_GL_GetProcAddress("glPixelStorei");
+		if (!gen_buffers || !delete_buffers || !bind_buffer || !buffer_data || !map_buffer_range || !unmap_buffer || !read_pixels || !pixel_store) {
+			return false;
+		}
+
+		activator = SDL_CreateTexture(r, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 1, 1);
+		if (!activator) {
+			return false;
+		}
+
+		renderer = r;
+		width = w;
+		height = h;
+		activate();
+		gen_buffers(PBO_COUNT, pbos);
+		for (GLuint pbo : pbos) {
+			bind_buffer(GL_PIXEL_PACK_BUFFER, pbo);
+			buffer_data(GL_PIXEL_PACK_BUFFER, (ptrdiff_t)4 * width * height, nullptr, GL_STREAM_READ);
+		}
+		bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+		return true;
+	}
+
+	void activate() {
+		SDL_RenderFlush(renderer);
+		SDL_GL_BindTexture(activator, nullptr, nullptr);
+		SDL_GL_UnbindTexture(activator);
+	}
+
+	void issue() {
+		activate();
+		const int slot = issued % PBO_COUNT;
+		pixel_store(GL_PACK_ALIGNMENT, 4);
+		pixel_store(GL_PACK_ROW_LENGTH, 0);
+		bind_buffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+		read_pixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, nullptr);
+		bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+		// the default framebuffer is stored bottom-up, render targets are drawn top-down
+		bottom_up[slot] = (SDL_GetRenderTarget(renderer) == nullptr);
+		++issued;
+	}
+
+	// copies the oldest pending readback into dst (may be null to discard it)
+	void collect(uint8_t *dst) {
+		const int slot = collected % PBO_COUNT;
+		++collected;
+		if (!dst) {
 			return;
 		}
 
-		ret = avcodec_receive_packet(ctx, pkt);
-		if (ret < 0 && ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
-			logs::info("Error receiving packet from codec, errcode = %d\n", ret);
+		const size_t pitch = (size_t)4 * width;
+		bind_buffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+		const uint8_t *src = (const uint8_t *)map_buffer_range(GL_PIXEL_PACK_BUFFER, 0, (ptrdiff_t)pitch * height, GL_MAP_READ_BIT);
+		if (src) {
+			for (int y = 0; y < height; ++y) {
+				const int src_y = bottom_up[slot] ? (height - 1 - y) : y;
+				memcpy(dst + pitch * y, src + pitch * src_y, pitch);
+			}
+			unmap_buffer(GL_PIXEL_PACK_BUFFER);
+		}
+		bind_buffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	uint32_t pending() const { return issued - collected; }
+
+	~gl_readback_t() {
+		if (renderer) {
+			activate();
+			delete_buffers(PBO_COUNT, pbos);
+		}
+		if (activator) {
+			SDL_DestroyTexture(activator);
+		}
+	}
+};
+
+MovieCapture::MovieCapture(const std::string &filename, const unsigned int width, const unsigned int height, const int frameRate)
+	: writer(filename, width, height, frameRate)
+{
+	for (auto &slot : ring) {
+		slot.resize(4 * width * height);
+	}
+
+	worker = std::thread([this] { run(); });
+}
+
+MovieCapture::~MovieCapture() {
+	flushReadback();
+	readback.reset();
+
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		stop = true;
+	}
+	pending.notify_one();
+	worker.join();
+
+	logs::info("Video capture finished: %u frames written, %u dropped", written.load(), dropped.load());
+}
+
+void MovieCapture::dropFrame(const char *reason) {
+	const uint32_t total = ++dropped;
+	if (total == 1 || total % 100 == 0) {
+		logs::warn("Video capture: %s, %u frames dropped so far", reason, total);
+	}
+}
+
+uint8_t *MovieCapture::acquireFrame() {
+	std::unique_lock<std::mutex> guard(lock);
+	if (head - tail >= RING_SIZE) {
+		return nullptr;
+	}
+
+	return ring[head % RING_SIZE].data();
+}
+
+void MovieCapture::captureFrame(SDL_Renderer *renderer, vec2i screen_size) {
+	const vec2i frame_size = frameSize();
+	if (frame_size.x != screen_size.x || frame_size.y != screen_size.y) {
+		dropFrame("screen size differs from the video size");
+		return;
+	}
+
+	if (!readback) {
+		readback.reset(new gl_readback_t());
+		if (!readback->init(renderer, frame_size.x, frame_size.y)) {
+			readback.reset();
+		}
+	}
+
+	if (readback && readback->renderer == renderer) {
+		readback->issue();
+		if (readback->pending() < gl_readback_t::PBO_COUNT) {
+			return; // the oldest readback may still be in flight
+		}
+
+		uint8_t *pixels = acquireFrame();
+		readback->collect(pixels);
+		if (!pixels) {
+			dropFrame("encoder is behind");
 			return;
-		} else if (ret >= 0) {
-			//fflush(stdout);
-			av_packet_rescale_ts(pkt, AVRational{ 1, frameRate }, stream->time_base);
-			pkt->stream_index = stream->index;
-			logs::info("Writing frame %d (size = %d)\n", iframe++, pkt->size);
-			av_interleaved_write_frame(fc, pkt);
-			av_packet_unref(pkt);
-		} else {
-			break;
 		}
+
+		submitFrame();
+		return;
 	}
 
-	// Writing the end of the file.
-	av_write_trailer(fc);
+	// renderers without pixel buffers read synchronously
+	uint8_t *pixels = acquireFrame();
+	if (!pixels) {
+		dropFrame("encoder is behind");
+		return;
+	}
 
-	// Closing the file.
-	if (!(fmt->flags & AVFMT_NOFILE)) {
-		avio_closep(&fc->pb);
+	SDL_Rect rect = { 0, 0, frame_size.x, frame_size.y };
+	if (SDL_RenderReadPixels(renderer, &rect, SDL_PIXELFORMAT_ARGB8888, pixels, 4 * frame_size.x) != 0) {
+		dropFrame("screen readback failed");
+		return;
 	}
 
-	// Freeing all the allocated memory:
-	sws_freeContext(swsCtx);
-	av_frame_free(&rgbpic);
-	av_frame_free(&yuvpic);
-	avcodec_free_context(&ctx);
-	avformat_free_context(fc);
+	submitFrame();
+}
 
-	delete pkt;
+void MovieCapture::flushReadback() {
+	if (!readback) {
+		return;
+	}
+
+	while (readback->pending() > 0) {
+		uint8_t *pixels = acquireFrame();
+		while (!pixels) { // let the encoder make room, the capture is closing anyway
+			std::this_thread::yield();
+			pixels = acquireFrame();
+		}
+		readback->collect(pixels);
+		submitFrame();
+	}
+}
+
+void MovieCapture::submitFrame() {
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		++head;
+	}
+	pending.notify_one();
+}
+
+void MovieCapture::run() {
+	while (true) {
+		uint8_t *pixels = nullptr;
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			pending.wait(guard, [this] { return stop || head != tail; });
+			if (head == tail) {
+				return; // stopped and drained
+			}
+			pixels = ring[tail % RING_SIZE].data();
+		}
+
+		if (writer.addFrame(pixels)) {
+			++written;
+		} else {
+			dropFrame("frame was not encoded");
+		}
+
+		std::unique_lock<std::mutex> guard(lock);
+		++tail;
+	}
 }
 
-#endif // GAME_PLATFORM_WIN
+#endif // GAME_HAS_FFMPEG
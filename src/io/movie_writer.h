@@ -7,8 +7,16 @@
 #include "platform/platform.h"
 
 struct AVFrame;
+struct SDL_Renderer;
 
-#ifdef GAME_PLATFORM_WIN
+#ifdef GAME_HAS_FFMPEG
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 struct SwsContext;
 struct AVOutputFormat;
@@ -19,7 +27,7 @@ struct AVPacket;
 
 class MovieWriter {
 	const uint16_t width, height;
-	uint16_t iframe;
+	uint32_t iframe;
 	uint16_t frameRate;
 
 	SwsContext* swsCtx = nullptr;
@@ -29,31 +37,84 @@ class MovieWriter {
 	AVCodecContext* ctx = nullptr;
 	AVPacket *pkt = nullptr;
 
-	AVFrame *rgbpic = nullptr;
 	AVFrame *yuvpic = nullptr;
 
-	std::vector<uint8_t> pixels;
+	void writePackets();
 
 public:
 	MovieWriter(const std::string& filename, const unsigned int width, const unsigned int height, const int frameRate = 25);
 
-	void addFrame(const uint8_t* pixels, AVFrame** yuvout = nullptr);
-	void addFrame(AVFrame* yuvframe);
+	// pixels are 32bit BGRA rows as read back from the renderer, returns false when the frame was not encoded
+	bool addFrame(const uint8_t* pixels, AVFrame** yuvout = nullptr);
+	bool addFrame(AVFrame* yuvframe);
 	vec2i frameSize() const { return {width, height}; }
-	
+	bool valid() const { return ctx != nullptr && fc != nullptr; }
+
 	~MovieWriter();
 };
+
+// Readback ring in front of MovieWriter: conversion and encoding run on a worker thread.
+// With the OpenGL renderer the screen is read into pixel buffer objects and picked up a few
+// frames later, so the main thread does not wait for the GPU; other renderers read synchronously.
+// Every frame which is not encoded (ring full, resolution changed, encoder error) counts as dropped.
+class MovieCapture {
+public:
+	enum { RING_SIZE = 4 };
+
+	MovieCapture(const std::string &filename, const unsigned int width, const unsigned int height, const int frameRate);
+	~MovieCapture();
+
+	void captureFrame(SDL_Renderer *renderer, vec2i screen_size);
+
+	vec2i frameSize() const { return writer.frameSize(); }
+	uint32_t droppedFrames() const { return dropped; }
+	uint32_t writtenFrames() const { return written; }
+
+private:
+	struct gl_readback_t;
+
+	uint8_t *acquireFrame();
+	void submitFrame();
+	void dropFrame(const char *reason);
+	void flushReadback();
+	void run();
+
+	MovieWriter writer;
+	std::unique_ptr<gl_readback_t> readback;
+	std::array<std::vector<uint8_t>, RING_SIZE> ring;
+	uint32_t head = 0; // next slot to fill, main thread
+	uint32_t tail = 0; // next slot to encode, worker thread
+	std::mutex lock;
+	std::condition_variable pending;
+	std::atomic<uint32_t> dropped{0};
+	std::atomic<uint32_t> written{0};
+	bool stop = false;
+	std::thread worker;
+};
+
 #else
 
 class MovieWriter {
 public:
 	MovieWriter(const std::string &, const unsigned int, const unsigned int, const int) {}
 
-	void addFrame(const uint8_t *pixels, AVFrame **yuvout = nullptr) {}
-	void addFrame(AVFrame *yuvframe) {}
+	bool addFrame(const uint8_t *pixels, AVFrame **yuvout = nullptr) { return false; }
+	bool addFrame(AVFrame *yuvframe) { return false; }
 	vec2i frameSize() const { return {0, 0}; }
+	bool valid() const { return false; }
 
 	~MovieWriter() {};
 };
 
-#endif // GAME_PLATFORM_WIN
+class MovieCapture {
+public:
+	MovieCapture(const std::string &, const unsigned int, const unsigned int, const int) {}
+
+	void captureFrame(SDL_Renderer *, vec2i) {}
+
+	vec2i frameSize() const { return {0, 0}; }
+	uint32_t droppedFrames() const { return 0; }
+	uint32_t writtenFrames() const { return 0; }
+};
+
+#endif // GAME_HAS_FFMPEG
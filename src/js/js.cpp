@@ -1,6 +1,7 @@
 #include "js.h"
 
 #include "content/dir.h"
+#include "core/archive_snapshot.h"
 #include "core/log.h"
 #include "graphics/window.h"
 #include "js/js_constants.h"
@@ -24,6 +25,8 @@
 
 #define MAX_FILES_RELOAD 255
 
+static const char CONFIG_SNAPSHOT_FILE[] = "akhenaten.snapshot";
+
 struct {
     svector<vfs::path, 4> scripts_folders;
     vfs::path files2load[MAX_FILES_RELOAD];
@@ -31,9 +34,13 @@ struct {
     int have_error;
     bstring256 error_str;
     js_State *J;
+    std::vector<vfs::path> sources; // every script read since the last reset, found or not
+    uint32_t env_hash;              // hash of the globals registered from code
+    bool from_snapshot;             // config is served from the snapshot, scripts were not run
 } vm;
 
-void js_reset_vm_state();
+void js_reset_vm_state(bool load_modules = true);
+void js_vm_save_snapshot();
 
 int js_vm_trypcall(js_State *J, int params) {
     if (vm.have_error) {
@@ -80,6 +87,9 @@ int js_vm_load_file_and_exec(pcstr path) {
     vfs::reader reader = vfs::file_open(rpath, "rt");
     if (!reader) {
         reader = vfs::file_open(path, "rt");
+        vm.sources.push_back(reader ? vfs::path(path) : rpath);
+    } else {
+        vm.sources.push_back(rpath);
     }
 
     if (!reader) {
@@ -115,8 +125,10 @@ bool js_vm_sync() {
         return false;
     }
 
-    if (vm.have_error) {
+    if (vm.have_error || vm.from_snapshot) {
+        // the snapshot has no sources for a partial reload, so all scripts are run once
         js_reset_vm_state();
+        g_config_snapshot.clear();
     }
 
     if (vm.files2load_num > 0) {
@@ -131,6 +143,9 @@ bool js_vm_sync() {
     }
 
     config::refresh(vm.J);
+    if (!vm.have_error) {
+        js_vm_save_snapshot();
+    }
 
     vm.files2load_num = 0;
     vm.have_error = 0;
@@ -226,7 +241,7 @@ void js_register_vm_functions(js_State *J) {
     REGISTER_GLOBAL_FUNCTION(J, js_vm_load_module, "include", 1);
 }
 
-void js_reset_vm_state() {
+void js_reset_vm_state(bool load_modules) {
     if (vm.J) {
         js_freestate(vm.J);
         vm.J = NULL;
@@ -237,6 +252,8 @@ void js_reset_vm_state() {
     }
     vm.files2load_num = 0;
     vm.have_error = 0;
+    vm.sources.clear();
+    vm.from_snapshot = false;
 
     vm.J = js_newstate(NULL, NULL, JS_STRICT);
     js_atpanic(vm.J, js_game_panic);
@@ -251,6 +268,13 @@ void js_reset_vm_state() {
     js_register_city_advisors(vm.J);
     js_register_menu(vm.J);
 
+    archive_snapshot env;
+    env.build(vm.J);
+    vm.env_hash = env.hash();
+    if (!load_modules) {
+        return;
+    }
+
     int ok = js_vm_load_file_and_exec(":modules.js");
     if (ok) {
         js_pop(vm.J, 2); //restore stack after call js-function
@@ -307,9 +331,28 @@ vfs::path js_vm_get_absolute_path(vfs::path path) {
     return path;
 }
 
+void js_vm_save_snapshot() {
+    archive_snapshot snapshot;
+    snapshot.build(vm.J);
+    snapshot.env_hash = vm.env_hash;
+    for (const auto &source : vm.sources) {
+        snapshot.add_source(source);
+    }
+    snapshot.save(CONFIG_SNAPSHOT_FILE);
+}
+
 void js_vm_setup() {
     vm.J = nullptr;
-    js_reset_vm_state();
+
+    // the engine is still created for image pak configs and hot reload, but the
+    // config scripts are only run when the snapshot is missing or out of date
+    js_reset_vm_state(false);
+    if (g_config_snapshot.load(CONFIG_SNAPSHOT_FILE, vm.env_hash)) {
+        vm.from_snapshot = true;
+        config::refresh(archive{&g_config_snapshot});
+    } else {
+        js_reset_vm_state();
+    }
 
     vfs::path abspath = js_vm_get_absolute_path("");
     vfs::path modules_file(abspath, "/modules.js");
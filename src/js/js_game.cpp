@@ -97,7 +97,7 @@ void config::refresh(archive arch) {
     }
 }
 
-archive config::load(pcstr filename) {
+g_archive config::load(pcstr filename) {
     vfs::path fspath = vfs::content_path(filename);
     js_vm_load_file_and_exec(fspath);
     return {js_vm_state()};
@@ -15,7 +15,7 @@
 namespace config {
 
 void refresh(archive);
-archive load(pcstr filename);
+g_archive load(pcstr filename);
 
 using config_iterator_function_cb = void ();
 using ArchiveIterator = FuncLinkedList<config_iterator_function_cb*>;
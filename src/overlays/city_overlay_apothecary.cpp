@@ -22,12 +22,12 @@ xstring city_overlay_apothecary::get_tooltip_for_building(tooltip_context* c, co
         return ui::str(66, 34);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.apothecary <= 0)
+    const int apothecary = house->service_level(HOUSE_SERVICE_APOTHECARY);
+    if (apothecary <= 0)
         return ui::str(66, 31);
-    else if (housed.apothecary >= 80)
+    else if (apothecary >= 80)
         return ui::str(66, 32);
-    else if (housed.apothecary < 20)
+    else if (apothecary < 20)
         return ui::str(66, 33);
     else {
         return ui::str(66, 34);
@@ -41,8 +41,8 @@ int city_overlay_apothecary::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
+    const int apothecary = house->service_level(HOUSE_SERVICE_APOTHECARY);
     return house->house_population() > 0
-                ? housed.apothecary / 10 
+                ? apothecary / 10 
                 : COLUMN_TYPE_NONE;
 }
@@ -17,8 +17,7 @@ xstring city_overlay_bandstand::get_tooltip_for_building(tooltip_context *c, con
         return ui::str(66, 82);
     }
 
-    auto &housed = house->runtime_data();
-    const int musician_value = std::max<int>(housed.bandstand_musician, housed.pavillion_musician);
+    const int musician_value = std::max<int>(house->service_level(HOUSE_SERVICE_BANDSTAND_MUSICIAN), house->service_level(HOUSE_SERVICE_PAVILLION_MUSICIAN));
     if (musician_value <= 0)
         return ui::str(66, 79);
     else if (musician_value >= 80)
@@ -44,8 +43,7 @@ int city_overlay_bandstand::get_column_height(const building *b) const {
     }
 
     if (house->house_population()) {
-        auto &housed = house->runtime_data();
-        const int musician_value = std::max<int>(housed.bandstand_musician, housed.pavillion_musician);
+        const int musician_value = std::max<int>(house->service_level(HOUSE_SERVICE_BANDSTAND_MUSICIAN), house->service_level(HOUSE_SERVICE_PAVILLION_MUSICIAN));
         return musician_value / 10;
     }
 
@@ -26,8 +26,7 @@ int city_overlay_bazaar_access::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    return std::clamp<int>(housed.bazaar_access / 10, 0, 8);
+    return std::clamp<int>(house->service_level(HOUSE_SERVICE_BAZAAR_ACCESS) / 10, 0, 8);
 }
 
 xstring city_overlay_bazaar_access::get_tooltip_for_building(tooltip_context *c, const building *b) const {
@@ -14,9 +14,9 @@ int city_overlay_courthouse::get_column_height(const building *b) const {
     auto house = ((building*)b)->dcast_house();
 
     if (house && house->house_population() > 0) {
-        auto &housed = house->runtime_data();
-        if (housed.magistrate) {
-            return housed.magistrate / 10;
+        const int magistrate = house->service_level(HOUSE_SERVICE_MAGISTRATE);
+        if (magistrate) {
+            return magistrate / 10;
         }
         return 0;
     }
@@ -30,12 +30,12 @@ xstring city_overlay_courthouse::get_tooltip_for_building(tooltip_context *c, co
         return  ui::str(66, 159);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.magistrate <= 0) {
+    const int magistrate = house->service_level(HOUSE_SERVICE_MAGISTRATE);
+    if (magistrate <= 0) {
         return ui::str(66, 158);
-    } else if (housed.magistrate <= 33) {
+    } else if (magistrate <= 33) {
         return ui::str(66, 161);
-    } else if (housed.magistrate <= 66) {
+    } else if (magistrate <= 66) {
         return ui::str(66, 160);
     } else {
         return ui::str(66, 159);
@@ -15,8 +15,8 @@ int city_overlay_dentist::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    return housed.dentist > 0 ? housed.dentist / 10 : COLUMN_TYPE_NONE;
+    const int dentist = house->service_level(HOUSE_SERVICE_DENTIST);
+    return dentist > 0 ? dentist / 10 : COLUMN_TYPE_NONE;
 }
 
 xstring city_overlay_dentist::get_tooltip_for_building(tooltip_context *c, const building *b) const {
@@ -26,12 +26,12 @@ xstring city_overlay_dentist::get_tooltip_for_building(tooltip_context *c, const
         return ui::str(66, 11);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.dentist <= 0)
+    const int dentist = house->service_level(HOUSE_SERVICE_DENTIST);
+    if (dentist <= 0)
         return ui::str(66, 8);
-    else if (housed.dentist >= 80)
+    else if (dentist >= 80)
         return ui::str(66, 9);
-    else if (housed.dentist >= 20)
+    else if (dentist >= 20)
         return ui::str(66, 10);
     else {
         return ui::str(66, 11);
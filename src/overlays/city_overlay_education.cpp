@@ -50,12 +50,12 @@ xstring city_overlay_academy::get_tooltip_for_building(tooltip_context *c, const
         return ui::str(66, 30);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.academy <= 0)
+    const int academy = house->service_level(HOUSE_SERVICE_ACADEMY);
+    if (academy <= 0)
         return ui::str(66, 27);
-    else if (housed.academy >= 80)
+    else if (academy >= 80)
         return ui::str(66, 28);
-    else if (housed.academy >= 20)
+    else if (academy >= 20)
         return ui::str(66, 29);
     
     return ui::str(66, 30);
@@ -68,8 +68,8 @@ int city_overlay_academy::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    return (housed.academy > 0) ? housed.academy / 10 : COLUMN_TYPE_NONE;
+    const int academy = house->service_level(HOUSE_SERVICE_ACADEMY);
+    return (academy > 0) ? academy / 10 : COLUMN_TYPE_NONE;
 }
 
 int city_overlay_libraries::get_column_height(const building *b) const {
@@ -79,8 +79,8 @@ int city_overlay_libraries::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    return (housed.library > 0) ? housed.library / 10 : COLUMN_TYPE_NONE;
+    const int library = house->service_level(HOUSE_SERVICE_LIBRARY);
+    return (library > 0) ? library / 10 : COLUMN_TYPE_NONE;
 }
 
 xstring city_overlay_libraries::get_tooltip_for_building(tooltip_context *c, const building *b) const {
@@ -90,12 +90,12 @@ xstring city_overlay_libraries::get_tooltip_for_building(tooltip_context *c, con
         return ui::str(66, 26);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.library <= 0) {
+    const int library = house->service_level(HOUSE_SERVICE_LIBRARY);
+    if (library <= 0) {
         return ui::str(66, 23);
-    } else if (housed.library >= 80) {
+    } else if (library >= 80) {
         return ui::str(66, 24);
-    } else if (housed.library >= 20) {
+    } else if (library >= 20) {
         return ui::str(66, 25);
     }
 
@@ -15,9 +15,9 @@ int city_overlay_booth::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.booth_juggler || housed.bandstand_juggler) {
-        return std::max<int>(housed.booth_juggler, housed.bandstand_juggler) / 10;
+    const int juggler_value = std::max<int>(house->service_level(HOUSE_SERVICE_BOOTH_JUGGLER), house->service_level(HOUSE_SERVICE_BANDSTAND_JUGGLER));
+    if (juggler_value) {
+        return juggler_value / 10;
     }
 
     return COLUMN_TYPE_NONE;
@@ -30,8 +30,7 @@ xstring city_overlay_booth::get_tooltip_for_building(tooltip_context *c, const b
         return ui::str(66, 78);
     }
 
-    auto &housed = house->runtime_data();
-    int juggler_value = std::max<int>(housed.booth_juggler, housed.bandstand_juggler);
+    int juggler_value = std::max<int>(house->service_level(HOUSE_SERVICE_BOOTH_JUGGLER), house->service_level(HOUSE_SERVICE_BANDSTAND_JUGGLER));
 
     if (juggler_value <= 0)
         return ui::str(66, 75);
@@ -15,8 +15,8 @@ int city_overlay_mortuary::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    return (housed.mortuary > 0) ? housed.mortuary / 10 : COLUMN_TYPE_NONE;
+    const int mortuary = house->service_level(HOUSE_SERVICE_MORTUARY);
+    return (mortuary > 0) ? mortuary / 10 : COLUMN_TYPE_NONE;
 }
 
 xstring city_overlay_mortuary::get_tooltip_for_building(tooltip_context *c, const building *b) const {
@@ -26,12 +26,12 @@ xstring city_overlay_mortuary::get_tooltip_for_building(tooltip_context *c, cons
         return ui::str(66, 42);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.mortuary <= 0) {
+    const int mortuary = house->service_level(HOUSE_SERVICE_MORTUARY);
+    if (mortuary <= 0) {
         return ui::str(66, 39);
-    } else if (housed.mortuary >= 80) {
+    } else if (mortuary >= 80) {
         return ui::str(66, 40);
-    } else if (housed.mortuary >= 20) {
+    } else if (mortuary >= 20) {
         return ui::str(66, 41);
     }
 
@@ -44,12 +44,12 @@ xstring city_overlay_pavilion::get_tooltip_for_building(tooltip_context *c, cons
         return ui::str(66, 86);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.senet_player <= 0) {
+    const int senet_player = house->service_level(HOUSE_SERVICE_SENET_PLAYER);
+    if (senet_player <= 0) {
         return ui::str(66, 83);
-    } else if (housed.senet_player >= 80) {
+    } else if (senet_player >= 80) {
         return ui::str(66, 84);
-    } else if (housed.senet_player >= 20) {
+    } else if (senet_player >= 20) {
         return ui::str(66, 85);
     } else {
         return ui::str(66, 86);
@@ -15,10 +15,10 @@ int city_overlay_physician::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
+    const int physician = house->service_level(HOUSE_SERVICE_PHYSICIAN);
     return (house->house_population() > 0)
-             ? housed.physician
-                ? housed.physician / 10
+             ? physician
+                ? physician / 10
                 : 0
              : COLUMN_TYPE_NONE;
 }
@@ -30,12 +30,12 @@ xstring city_overlay_physician::get_tooltip_for_building(tooltip_context *c, con
         return ui::str(66, 135);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.physician <= 0) {
+    const int physician = house->service_level(HOUSE_SERVICE_PHYSICIAN);
+    if (physician <= 0) {
         return ui::str(66, 132);
-    } else if (housed.physician <= 33) {
+    } else if (physician <= 33) {
         return ui::str(66, 133);
-    } else if (housed.physician <= 66) {
+    } else if (physician <= 66) {
         return ui::str(66, 134);
     } else {
         return ui::str(66, 135);
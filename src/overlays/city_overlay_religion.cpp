@@ -47,19 +47,19 @@ xstring city_overlay_religion::get_tooltip_for_building(tooltip_context *c, cons
 
     auto &housed = house->runtime_data();
     if (housed.num_gods < 5) {
-        if (housed.temple_osiris)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_OSIRIS))
             add_god(c, GOD_OSIRIS);
 
-        if (housed.temple_ra)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_RA))
             add_god(c, GOD_RA);
 
-        if (housed.temple_ptah)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_PTAH))
             add_god(c, GOD_PTAH);
 
-        if (housed.temple_seth)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_SETH))
             add_god(c, GOD_SETH);
 
-        if (housed.temple_bast)
+        if (house->service_level(HOUSE_SERVICE_TEMPLE_BAST))
             add_god(c, GOD_BAST);
     }
 
@@ -25,13 +25,12 @@ struct city_overlay_religion_god : public city_overlay_t<TYPE> {
         }
 
         int value = 0;
-        auto &housed = house->runtime_data();
         switch (_god) {
-        case GOD_OSIRIS: value = housed.temple_osiris; break;
-        case GOD_RA: value = housed.temple_ra; break;
-        case GOD_PTAH: value = housed.temple_ptah; break;
-        case GOD_SETH: value = housed.temple_seth; break;
-        case GOD_BAST: value = housed.temple_bast; break;
+        case GOD_OSIRIS: value = house->service_level(HOUSE_SERVICE_TEMPLE_OSIRIS); break;
+        case GOD_RA: value = house->service_level(HOUSE_SERVICE_TEMPLE_RA); break;
+        case GOD_PTAH: value = house->service_level(HOUSE_SERVICE_TEMPLE_PTAH); break;
+        case GOD_SETH: value = house->service_level(HOUSE_SERVICE_TEMPLE_SETH); break;
+        case GOD_BAST: value = house->service_level(HOUSE_SERVICE_TEMPLE_BAST); break;
         }
 
         return value / 10;
@@ -18,8 +18,7 @@ int city_overlay_schools::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    return housed.school / 10;
+    return house->service_level(HOUSE_SERVICE_SCHOOL) / 10;
 }
 
 xstring city_overlay_schools::get_tooltip_for_building(tooltip_context *c, const building *b) const {
@@ -29,14 +28,14 @@ xstring city_overlay_schools::get_tooltip_for_building(tooltip_context *c, const
         return ui::str(66, 22);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.school <= 0)
+    const int school = house->service_level(HOUSE_SERVICE_SCHOOL);
+    if (school <= 0)
         return ui::str(66, 19);
     
-    if (housed.school >= 80)
+    if (school >= 80)
         return ui::str(66, 20);
     
-    if (housed.school >= 20)
+    if (school >= 20)
         return ui::str(66, 21);
     
     return ui::str(66, 22);
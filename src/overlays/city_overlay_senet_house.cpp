@@ -12,8 +12,8 @@ int city_overlay_senet_house::get_column_height(const building *b) const {
         return COLUMN_TYPE_NONE;
     }
 
-    auto &housed = house->runtime_data();
-    return (house->house_population() > 0) ? housed.senet_player / 10 : COLUMN_TYPE_NONE;
+    const int senet_player = house->service_level(HOUSE_SERVICE_SENET_PLAYER);
+    return (house->house_population() > 0) ? senet_player / 10 : COLUMN_TYPE_NONE;
 }
 
 xstring city_overlay_senet_house::get_tooltip_for_building(tooltip_context *c, const building *b) const {
@@ -23,12 +23,12 @@ xstring city_overlay_senet_house::get_tooltip_for_building(tooltip_context *c, c
         return ui::str(66, 90);
     }
 
-    auto &housed = house->runtime_data();
-    if (housed.senet_player <= 0) {
+    const int senet_player = house->service_level(HOUSE_SERVICE_SENET_PLAYER);
+    if (senet_player <= 0) {
         return ui::str(66, 87);
-    } else if (housed.senet_player >= 80) {
+    } else if (senet_player >= 80) {
         return ui::str(66, 88);
-    } else if (housed.senet_player >= 20) {
+    } else if (senet_player >= 20) {
         return ui::str(66, 89);
     } else {
         return ui::str(66, 90);
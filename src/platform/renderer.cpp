@@ -8,9 +8,12 @@
 #include "platform/screen.h"
 #include "platform/platform.h"
 #include "graphics/image_groups.h"
+#include "graphics/painter.h"
 #include "graphics/view/view.h"
 #include "game/game.h"
 #include "input/cursor.h"
+#include "widget/city/terrain_chunks.h"
+#include "widget/widget_minimap.h"
 
 #include <SDL.h>
 #include <SDL_video.h>
@@ -331,6 +334,7 @@ void graphics_renderer_interface::draw_image_grayscale(painter &ctx, const image
 void graphics_renderer_interface::create_custom_texture(int type, int width, int height) {
     auto &data = g_renderer_data;
     if (data.custom_textures[type].texture) {
+        painter_grayscale_release(data.custom_textures[type].texture);
         SDL_DestroyTexture(data.custom_textures[type].texture);
         data.custom_textures[type].texture = 0;
     }
@@ -741,6 +745,7 @@ void load_unpacked_image(const image_t* img, const color* pixels) {
     data.unpacked_images[index].id = unpacked_image_id;
 
     if (data.unpacked_images[index].texture) {
+        painter_grayscale_release(data.unpacked_images[index].texture);
         SDL_DestroyTexture(data.unpacked_images[index].texture);
         data.unpacked_images[index].texture = 0;
     }
@@ -759,6 +764,7 @@ void load_unpacked_image(const image_t* img, const color* pixels) {
             SDL_FreeSurface(surface);
             return;
         }
+        painter_grayscale_release(data.unpacked_images[oldest_texture_index].texture);
         SDL_DestroyTexture(data.unpacked_images[oldest_texture_index].texture);
         data.unpacked_images[oldest_texture_index].texture = 0;
         data.unpacked_images[index].texture = SDL_CreateTextureFromSurface(data.renderer, surface);
@@ -1054,6 +1060,7 @@ static void destroy_render_texture(void) {
 int platform_renderer_create_render_texture(int width, int height) {
     auto &data = g_renderer_data;
     destroy_render_texture();
+    g_terrain_chunks.invalidate();
 
     if (data.filter_texture) {
         SDL_DestroyTexture(data.filter_texture);
@@ -1117,15 +1124,19 @@ int platform_renderer_lost_render_texture() {
 void platform_renderer_invalidate_target_textures() {
     auto &data = g_renderer_data;
     if (data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture) {
+        painter_grayscale_release(data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture);
         SDL_DestroyTexture(data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture);
         data.custom_textures[CUSTOM_IMAGE_RED_FOOTPRINT].texture = 0;
         create_blend_texture(CUSTOM_IMAGE_RED_FOOTPRINT);
     }
     if (data.custom_textures[CUSTOM_IMAGE_GREEN_FOOTPRINT].texture) {
+        painter_grayscale_release(data.custom_textures[CUSTOM_IMAGE_GREEN_FOOTPRINT].texture);
         SDL_DestroyTexture(data.custom_textures[CUSTOM_IMAGE_GREEN_FOOTPRINT].texture);
         data.custom_textures[CUSTOM_IMAGE_GREEN_FOOTPRINT].texture = 0;
         create_blend_texture(CUSTOM_IMAGE_GREEN_FOOTPRINT);
     }
+    g_terrain_chunks.invalidate();
+    widget_minimap_invalidate();
 }
 
 #ifdef PLATFORM_USE_SOFTWARE_CURSOR
@@ -1241,6 +1252,7 @@ void platform_renderer_resume() {
 void platform_renderer_destroy(void) {
     auto &data = g_renderer_data;
     destroy_render_texture();
+    g_terrain_chunks.invalidate();
     if (data.renderer) {
         SDL_DestroyRenderer(data.renderer);
         data.renderer = 0;
@@ -0,0 +1,274 @@
+#include "terrain_chunks.h"
+
+#include "core/profiler.h"
+#include "graphics/graphics.h"
+#include "graphics/image.h"
+#include "graphics/painter.h"
+#include "graphics/view/lookup.h"
+#include "graphics/view/view.h"
+#include "grid/building.h"
+#include "grid/grid.h"
+#include "grid/image.h"
+#include "grid/property.h"
+#include "grid/terrain.h"
+#include "widget/city/tile_draw.h"
+
+#include <SDL.h>
+#include <cmath>
+
+terrain_chunks_t g_terrain_chunks;
+
+constexpr int CHUNKS_PER_ROW = (GRID_LENGTH + terrain_chunks_t::CHUNK_SIZE - 1) / terrain_chunks_t::CHUNK_SIZE;
+
+static int chunk_index_of(int grid_offset) {
+    return (GRID_Y(grid_offset) / terrain_chunks_t::CHUNK_SIZE) * CHUNKS_PER_ROW + GRID_X(grid_offset) / terrain_chunks_t::CHUNK_SIZE;
+}
+
+static int tile_index_in_chunk(int grid_offset) {
+    return (GRID_Y(grid_offset) % terrain_chunks_t::CHUNK_SIZE) * terrain_chunks_t::CHUNK_SIZE + GRID_X(grid_offset) % terrain_chunks_t::CHUNK_SIZE;
+}
+
+// pixel bounds of all tiles of a chunk, relative to the pixel of its first tile
+static void chunk_bounds(vec2i &bmin, vec2i &bmax) {
+    constexpr int last = terrain_chunks_t::CHUNK_SIZE - 1;
+    const vec2i corners[] = { tile_pixel_delta(0, 0), tile_pixel_delta(last, 0), tile_pixel_delta(0, last), tile_pixel_delta(last, last) };
+
+    bmin = corners[0];
+    bmax = corners[0];
+    for (const vec2i &c : corners) {
+        bmin = { std::min(bmin.x, c.x), std::min(bmin.y, c.y) };
+        bmax = { std::max(bmax.x, c.x), std::max(bmax.y, c.y) };
+    }
+    bmax += vec2i(TILE_WIDTH_PIXELS, TILE_HEIGHT_PIXELS);
+}
+
+int terrain_chunks_t::signature(int grid_offset, int image_id) const {
+    if (image_id <= 0) {
+        return 0;
+    }
+
+    const bool outside_map = map_terrain_is(grid_offset, TERRAIN_TREE) && map_terrain_is(grid_offset, TERRAIN_WATER);
+    if (outside_map || map_terrain_is(grid_offset, TERRAIN_PLANER_FUTURE)) {
+        return 0;
+    }
+
+    if (!map_property_is_draw_tile(grid_offset) || map_property_multi_tile_size(grid_offset) > 1) {
+        return 0;
+    }
+
+    if (map_building_at(grid_offset) > 0 || map_property_is_constructing(grid_offset) || map_property_is_deleted(grid_offset)) {
+        return 0;
+    }
+
+    if (map_image_alt_at(grid_offset) & 0x00ffffff) {
+        return 0;
+    }
+
+    // animated water is changed by the flat pass itself, keep it out of the cache
+    if (render_ctx) {
+        const bool is_water = (image_id >= render_ctx->image_id_water_first && image_id <= render_ctx->image_id_water_last);
+        const bool is_deepwater = (image_id >= render_ctx->image_id_deepwater_first && image_id <= render_ctx->image_id_deepwater_last);
+        if (is_water || is_deepwater) {
+            return 0;
+        }
+    }
+
+    const image_t *img = image_get(image_id);
+    if (!img || !img->atlas.p_atlas) {
+        return 0;
+    }
+
+    if (img->isometric_size() != 1 || img->isometric_top_height() > 0) {
+        return 0;
+    }
+
+    if (img->width > TILE_WIDTH_PIXELS || img->height > TILE_HEIGHT_PIXELS) {
+        return 0;
+    }
+
+    return image_id;
+}
+
+void terrain_chunks_t::evict_textures() {
+    while (num_textures >= MAX_TEXTURES) {
+        chunk_t *oldest = nullptr;
+        for (auto &chunk : chunks) {
+            if (!chunk.texture || chunk.visible_frame == frame) {
+                continue;
+            }
+
+            if (!oldest || chunk.visible_frame < oldest->visible_frame) {
+                oldest = &chunk;
+            }
+        }
+
+        if (!oldest) {
+            return;
+        }
+
+        SDL_DestroyTexture(oldest->texture);
+        oldest->texture = nullptr;
+        oldest->dirty = true;
+        --num_textures;
+    }
+}
+
+void terrain_chunks_t::render(painter &ctx, chunk_t &chunk, int chunk_index) {
+    OZZY_PROFILER_SECTION("Render/Frame/Terrain Chunks/Render");
+    const float scale = ctx.global_render_scale;
+
+    vec2i bmin, bmax;
+    chunk_bounds(bmin, bmax);
+    const vec2i size(int(std::ceil((bmax.x - bmin.x) * scale)) + 1, int(std::ceil((bmax.y - bmin.y) * scale)) + 1);
+
+    if (chunk.texture && chunk.texture_size != size) {
+        SDL_DestroyTexture(chunk.texture);
+        chunk.texture = nullptr;
+        --num_textures;
+    }
+
+    if (!chunk.texture) {
+        evict_textures();
+        chunk.texture = SDL_CreateTexture(ctx.renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET, size.x, size.y);
+        if (!chunk.texture) {
+            chunk.dirty = true;
+            return;
+        }
+        chunk.texture_size = size;
+        ++num_textures;
+    }
+
+    SDL_Texture *former_target = SDL_GetRenderTarget(ctx.renderer);
+    SDL_Rect former_viewport;
+    SDL_Rect former_clip;
+    const bool former_clip_enabled = SDL_RenderIsClipEnabled(ctx.renderer);
+    Uint8 r, g, b, a;
+    SDL_RenderGetViewport(ctx.renderer, &former_viewport);
+    SDL_RenderGetClipRect(ctx.renderer, &former_clip);
+    SDL_GetRenderDrawColor(ctx.renderer, &r, &g, &b, &a);
+
+    SDL_SetRenderTarget(ctx.renderer, chunk.texture);
+    SDL_RenderSetClipRect(ctx.renderer, nullptr);
+    SDL_SetRenderDrawColor(ctx.renderer, 0, 0, 0, 0);
+    SDL_RenderClear(ctx.renderer);
+
+    painter chunk_ctx = ctx;
+    const int x0 = (chunk_index % CHUNKS_PER_ROW) * CHUNK_SIZE;
+    const int y0 = (chunk_index / CHUNKS_PER_ROW) * CHUNK_SIZE;
+    for (int dy = 0; dy < CHUNK_SIZE; ++dy) {
+        for (int dx = 0; dx < CHUNK_SIZE; ++dx) {
+            int &sig = chunk.signatures[dy * CHUNK_SIZE + dx];
+            sig = 0;
+            if (x0 + dx >= GRID_LENGTH || y0 + dy >= GRID_LENGTH) {
+                continue;
+            }
+
+            const int grid_offset = GRID_OFFSET(x0 + dx, y0 + dy);
+            sig = signature(grid_offset, map_image_at(grid_offset));
+            if (sig) {
+                ImageDraw::isometric_from_drawtile(chunk_ctx, sig, tile_pixel_delta(dx, dy) - bmin);
+            }
+        }
+    }
+
+    SDL_SetRenderTarget(ctx.renderer, former_target);
+    SDL_RenderSetViewport(ctx.renderer, &former_viewport);
+    SDL_RenderSetClipRect(ctx.renderer, former_clip_enabled ? &former_clip : nullptr);
+    SDL_SetRenderDrawColor(ctx.renderer, r, g, b, a);
+
+    chunk.scale = scale;
+    chunk.orientation = orientation;
+    chunk.dirty = false;
+}
+
+void terrain_chunks_t::draw(painter &ctx, const local_render_context_t &rctx) {
+    OZZY_PROFILER_SECTION("Render/Frame/Terrain Chunks");
+    if (chunks.empty()) {
+        chunks.resize(CHUNKS_PER_ROW * CHUNKS_PER_ROW);
+    }
+
+    ++frame;
+    active = true;
+    render_ctx = &rctx;
+    orientation = city_view_orientation() / 2;
+
+    visible.clear();
+    for (const city_view_tile &vt : city_view_visible_tiles(ctx)) {
+        const int grid_offset = vt.tile.grid_offset();
+        const int index = chunk_index_of(grid_offset);
+        chunk_t &chunk = chunks[index];
+        if (chunk.visible_frame == frame) {
+            continue;
+        }
+
+        chunk.visible_frame = frame;
+        chunk.origin = vt.pixel - tile_pixel_delta(GRID_X(grid_offset) % CHUNK_SIZE, GRID_Y(grid_offset) % CHUNK_SIZE);
+        visible.push_back(index);
+    }
+
+    vec2i bmin, bmax;
+    chunk_bounds(bmin, bmax);
+    const float scale = ctx.global_render_scale;
+    for (const int index : visible) {
+        chunk_t &chunk = chunks[index];
+        if (chunk.dirty || !chunk.texture || chunk.scale != scale || chunk.orientation != orientation) {
+            render(ctx, chunk, index);
+        }
+
+        if (chunk.dirty) {
+            continue;
+        }
+
+        ctx.draw(chunk.texture, chunk.origin + bmin, vec2i(0, 0), chunk.texture_size, COLOR_MASK_NONE, 1.f / scale, 1.f / scale);
+        chunk.blitted_frame = frame;
+    }
+}
+
+void terrain_chunks_t::finish() {
+    active = false;
+    render_ctx = nullptr;
+}
+
+bool terrain_chunks_t::covers(tile2i tile, int image_id) {
+    const int grid_offset = tile.grid_offset();
+    if (!active || !map_grid_is_valid_offset(grid_offset)) {
+        return false;
+    }
+
+    chunk_t &chunk = chunks[chunk_index_of(grid_offset)];
+    if (chunk.blitted_frame != frame) {
+        return false;
+    }
+
+    // tile changed without notification, draw it directly now and refresh the chunk next frame
+    const int sig = signature(grid_offset, image_id);
+    if (chunk.signatures[tile_index_in_chunk(grid_offset)] != sig) {
+        chunk.dirty = true;
+        return false;
+    }
+
+    return sig != 0;
+}
+
+void terrain_chunks_t::mark_dirty(int grid_offset) {
+    if (chunks.empty() || !map_grid_is_valid_offset(grid_offset)) {
+        return;
+    }
+
+    chunk_t &chunk = chunks[chunk_index_of(grid_offset)];
+    if (chunk.signatures[tile_index_in_chunk(grid_offset)] != 0) {
+        chunk.dirty = true;
+    }
+}
+
+void terrain_chunks_t::invalidate() {
+    for (auto &chunk : chunks) {
+        if (chunk.texture) {
+            SDL_DestroyTexture(chunk.texture);
+            chunk.texture = nullptr;
+        }
+        chunk.dirty = true;
+        chunk.signatures.fill(0);
+    }
+    num_textures = 0;
+}
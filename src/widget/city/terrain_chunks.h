@@ -0,0 +1,56 @@
+#pragma once
+
+#include "core/vec2i.h"
+#include "grid/point.h"
+
+#include <array>
+#include <vector>
+
+struct painter;
+struct SDL_Texture;
+struct local_render_context_t;
+
+// Flat terrain (grass, floodplain, roads...) pre-rendered into per-chunk render targets.
+// Only single-tile images without tall parts, buildings or color masks are cached,
+// everything else is still drawn tile by tile on top by the flat pass.
+struct terrain_chunks_t {
+    enum {
+        CHUNK_SIZE = 16,
+        CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE,
+        MAX_TEXTURES = 48,
+    };
+
+    struct chunk_t {
+        SDL_Texture *texture = nullptr;
+        vec2i texture_size = {0, 0};
+        float scale = 0.f;
+        int orientation = -1;
+        bool dirty = true;
+        uint32_t visible_frame = 0;
+        uint32_t blitted_frame = 0;
+        vec2i origin = {0, 0}; // pixel of the chunk's first tile in the current frame
+        std::array<int, CHUNK_TILES> signatures = {};
+    };
+
+    std::vector<chunk_t> chunks;
+    std::vector<int> visible;
+    uint32_t frame = 0;
+    bool active = false;
+    int orientation = 0;
+    int num_textures = 0;
+    const local_render_context_t *render_ctx = nullptr;
+
+    void draw(painter &ctx, const local_render_context_t &rctx);
+    void finish();
+    bool covers(tile2i tile, int image_id);
+
+    void mark_dirty(int grid_offset);
+    void invalidate();
+
+private:
+    int signature(int grid_offset, int image_id) const;
+    void render(painter &ctx, chunk_t &chunk, int chunk_index);
+    void evict_textures();
+};
+
+extern terrain_chunks_t g_terrain_chunks;
@@ -138,14 +138,14 @@ void widget_sidebar_editor_draw_background() {
     int x_offset = sidebar_common_get_x_offset_expanded();
     ImageDraw::img_generic(ctx, image_base, x_offset, TOP_MENU_HEIGHT);
     draw_buttons();
-    widget_minimap_draw({x_offset + 8, MINIMAP_Y_OFFSET}, 1);
+    widget_minimap_draw({x_offset + 8, MINIMAP_Y_OFFSET});
     draw_status();
     sidebar_common_draw_relief({ x_offset, SIDEBAR_MAIN_SECTION_HEIGHT + TOP_MENU_HEIGHT }, side_panel);
 }
 
 void widget_sidebar_editor_draw_foreground(void) {
     draw_buttons();
-    widget_minimap_draw({sidebar_common_get_x_offset_expanded() + 8, MINIMAP_Y_OFFSET}, 0);
+    widget_minimap_draw({sidebar_common_get_x_offset_expanded() + 8, MINIMAP_Y_OFFSET});
 }
 
 int widget_sidebar_editor_handle_mouse(const mouse* m) {
@@ -34,6 +34,7 @@
 #include "sound/effect.h"
 #include "sound/sound.h"
 #include "widget/city/ornaments.h"
+#include "widget/city/terrain_chunks.h"
 #include "widget/city/tile_draw.h"
 #include "widget/widget_minimap.h"
 #include "window/window_building_info.h"
@@ -156,17 +157,13 @@ void screen_city_t::clear_current_tile() {
 }
 
 void screen_city_t::draw_figures(vec2i pixel, tile2i tile, painter &ctx, bool force) {
-    auto figures = map_figures_in_row(tile);
+    auto figures = force ? map_figures_around(pixel) : map_figures_to_draw(pixel);
 
     for (auto *f : figures) {
         if (f->is_drawn && !force) {
             continue;
         }
 
-        if (f->cached_pos.x < (pixel.x - TILE_WIDTH_PIXELS) || f->cached_pos.x >(pixel.x + TILE_WIDTH_PIXELS)) {
-            continue;
-        }
-
         if (!selected_figure_id) {
             int highlight = f->formation_id > 0 && f->formation_id == highlighted_formation;
             f->city_draw_figure(ctx, highlight);
@@ -177,8 +174,7 @@ void screen_city_t::draw_figures(vec2i pixel, tile2i tile, painter &ctx, bool fo
 }
 
 void screen_city_t::draw_figures_overlay(vec2i pixel, tile2i tile, painter &ctx) {
-    int grid_offset = tile.grid_offset();
-    auto figures = map_figures_in_row(tile);
+    auto figures = map_figures_to_draw(pixel);
 
     for (auto *f : figures) {
         if (!g_city.overlay()->show_figure(f)) {
@@ -189,10 +185,6 @@ void screen_city_t::draw_figures_overlay(vec2i pixel, tile2i tile, painter &ctx)
             continue;
         }
 
-        if (f->cached_pos.x < (pixel.x - TILE_WIDTH_PIXELS) || f->cached_pos.x >(pixel.x + TILE_WIDTH_PIXELS)) {
-            continue;
-        }
-
         if (!selected_figure_id) {
             int highlight = f->formation_id > 0 && f->formation_id == highlighted_formation;
             f->city_draw_figure(ctx, highlight);
@@ -238,11 +230,13 @@ void screen_city_t::draw_without_overlay(painter &ctx, int selected_figure_id, v
     clear_mappoint_pixelcoord();
     city_view_foreach_valid_map_tile(ctx, update_tile_coords);
 
-    map_figure_sort_by_y();
+    map_figure_build_draw_list(ctx);
+    g_terrain_chunks.draw(ctx, render_ctx);
     city_view_foreach_valid_map_tile(ctx, 
         [this] (vec2i pixel, tile2i tile, painter &ctx) { draw_isometric_flat(pixel, tile, ctx); },
         draw_ornaments_flat
     );
+    g_terrain_chunks.finish();
 
     city_view_foreach_valid_map_tile(ctx, 
         [this] (vec2i pixel, tile2i tile, painter &ctx) { draw_isometric_terrain_height(pixel, tile, ctx); }
@@ -337,6 +331,12 @@ void screen_city_t::draw_isometric_flat(vec2i pixel, tile2i tile, painter &ctx)
         color_mask = COLOR_MASK_GREEN;
     }
 
+    // already blitted with its terrain chunk
+    if (color_mask == COLOR_MASK_NONE && g_terrain_chunks.covers(tile, image_id)) {
+        map_render_set(tile, 0);
+        return;
+    }
+
     const image_t *img = ImageDraw::isometric_from_drawtile(ctx, image_id, pixel, color_mask);
     if (!img) {
         return;
@@ -487,7 +487,7 @@ void screen_city_t::draw_with_overlay(painter &ctx) {
     g_city_planner.ghost_mark_deleting(current_tile);
     city_view_foreach_valid_map_tile(ctx, update_tile_coords);
 
-    map_figure_sort_by_y();
+    map_figure_build_draw_list(ctx);
     city_view_foreach_valid_map_tile(ctx, draw_isometrics_overlay_flat);
     city_view_foreach_valid_map_tile(ctx,
         draw_isometrics_overlay_height,
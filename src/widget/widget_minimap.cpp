@@ -8,36 +8,28 @@
 #include "grid/property.h"
 #include "grid/random.h"
 #include "grid/terrain.h"
-#include "input/scroll.h"
 #include "city/city_buildings.h"
 #include "game/game_events.h"
 #include "scenario/scenario.h"
 #include "game/game.h"
 #include "dev/debug.h"
 
+#include <SDL.h>
+#include <algorithm>
+
 static const color ENEMY_COLOR_BY_CLIMATE[] = {COLOR_MINIMAP_ENEMY_CENTRAL, COLOR_MINIMAP_ENEMY_NORTHERN, COLOR_MINIMAP_ENEMY_DESERT};
 minimap_window g_minimap_window;
 
-template<typename F>
-void city_view_foreach_minimap_tile(int x_offset, int y_offset, int absolute_x, int absolute_y, int width_tiles, int height_tiles, F callback) {
-    int odd = 0;
-    int y_abs = absolute_y - 4;
-    int screen_y = y_offset - 4;
-    for (int y_rel = -4; y_rel < height_tiles + 4; y_rel++, y_abs++, screen_y++) {
-        int screen_x;
-        if (odd) {
-            screen_x = x_offset - 9;
-            odd = 0;
-        } else {
-            screen_x = x_offset - 8;
-            odd = 1;
-        }
-        int x_abs = absolute_x - 4;
-        for (int x_rel = -4; x_rel < width_tiles; x_rel++, x_abs++, screen_x += 2) {
-            if (x_abs >= 0 && x_abs < (2 * GRID_LENGTH) + 1 && y_abs >= 0 && y_abs < (2 * GRID_LENGTH) + 1)
-                callback({ screen_x, screen_y }, screen_to_tile({ x_abs, y_abs }));
-        }
-    }
+// minimap space is (2 * GRID_LENGTH + 1) tiles square, every tile is 2 pixels wide and odd rows are shifted left by one
+constexpr int MINIMAP_SPAN = 2 * GRID_LENGTH + 1;
+constexpr int MINIMAP_CACHE_PAD = 8;
+constexpr int MINIMAP_BLOCK = 16;
+constexpr int MINIMAP_BLOCKS = (MINIMAP_SPAN + MINIMAP_BLOCK - 1) / MINIMAP_BLOCK;
+constexpr int MINIMAP_BLOCK_MARGIN = 6; // multi-tile building images reach this far from their draw tile
+constexpr uint64_t MINIMAP_SIGNATURE_NONE = ~0ull;
+
+static vec2i minimap_cache_pixel(int x_abs, int y_abs) {
+    return { MINIMAP_CACHE_PAD + 2 * x_abs - (y_abs & 1), MINIMAP_CACHE_PAD + y_abs };
 }
 
 void minimap_window::load(archive arch, pcstr) {
@@ -78,6 +70,8 @@ void minimap_window::on_mission_start() {
     events::subscribe([] (event_rotate_map_reset ev) {
         widget_minimap_invalidate();
     });
+
+    widget_minimap_invalidate();
 }
 
 vec2i minimap_window::get_mouse_relative_pos(const mouse *m, float &xx, float &yy) {
@@ -114,7 +108,6 @@ int minimap_window::handle_mouse(const mouse *m) {
 
             painter ctx = game.painter();
             camera_go_to_pixel(ctx, mm_view.min + map_pos - view_size / 2, true);
-            widget_minimap_invalidate();
             mouse_last_coords = { m->x, m->y };
             return true;
         }
@@ -136,17 +129,10 @@ void minimap_window::draw_foreground(UiFlags flags) {
     OZZY_PROFILER_SECTION("Render/Frame/Window/City/Sidebar Expanded/Minimap");
 
     painter ctx = game.painter();
-    graphics_set_clip_rectangle(screen_offset, size);
-
-    if (refresh_requested || scroll_in_progress() || draw_force) {
-        draw_uncached(screen_offset);
-        refresh_requested = 0;
-    } else {
-        graphics_draw_from_texture(cached_texture, screen_offset, size);
-    }
-
-    draw_force = false;
+    update_cache(ctx);
 
+    graphics_set_clip_rectangle(screen_offset, size);
+    draw(UiFlags_None);
     draw_viewport_rectangle(ctx);
     graphics_reset_clip_rectangle();
 }
@@ -213,7 +199,8 @@ bool minimap_window::draw_figure(vec2i screen, tile2i point) {
     return true;
 }
 
-void minimap_window::draw_minimap_tile(vec2i screen, tile2i point) {
+// terrain and buildings only, figures never go to the cache and are drawn over it every frame
+void minimap_window::draw_minimap_terrain(vec2i screen, tile2i point) {
     painter ctx = game.painter();
     int grid_offset = point.grid_offset();
     int screen_x = screen.x;
@@ -223,10 +210,6 @@ void minimap_window::draw_minimap_tile(vec2i screen, tile2i point) {
         return;
     }
 
-    if (draw_figure(screen, point)) {
-        return;
-    }
-
     int terrain = map_terrain_get(grid_offset);
     // exception for fort ground: display as empty land
     if (terrain & TERRAIN_BUILDING) {
@@ -344,29 +327,155 @@ void minimap_window::draw_viewport_rectangle(painter &ctx) {
     graphics_draw_rect(vec2i{x_offset, y_offset}, vec2i{ view_size_tiles.x * 2 + 8, view_size_tiles.y + 3}, COLOR_MINIMAP_VIEWPORT);
 }
 
-void minimap_window::clear() {
-    graphics_clear_saved_texture(cached_texture, 0xff000000);
+uint64_t minimap_window::tile_signature(tile2i point) {
+    const int grid_offset = point.grid_offset();
+    if (grid_offset < 0) {
+        return 0;
+    }
+
+    uint64_t signature = grid_offset + 1;
+    auto mix = [&signature] (uint64_t v) { signature = (signature ^ v) * 0x100000001b3ull; };
+    const int terrain = map_terrain_get(grid_offset);
+    mix(terrain);
+    mix(map_random_get(grid_offset));
+    if (terrain & TERRAIN_BUILDING) {
+        building *b = building_at(grid_offset);
+        mix(b->id);
+        mix(b->type);
+        mix(map_property_is_draw_tile(grid_offset));
+        mix(map_property_multi_tile_size(grid_offset));
+    }
+
+    return signature;
+}
+
+void minimap_window::update_cache(painter &ctx) {
+    OZZY_PROFILER_SECTION("Render/Frame/Window/City/Sidebar Expanded/Minimap Cache");
+    if (cache_signatures.empty()) {
+        cache_signatures.resize(MINIMAP_SPAN * MINIMAP_SPAN, MINIMAP_SIGNATURE_NONE);
+        cache_dirty_blocks.resize(MINIMAP_BLOCKS * MINIMAP_BLOCKS, 0);
+    }
+
+    if (!cache_texture) {
+        const vec2i pixels = minimap_cache_pixel(MINIMAP_SPAN, MINIMAP_SPAN) + vec2i(MINIMAP_CACHE_PAD, MINIMAP_CACHE_PAD);
+        cache_texture = SDL_CreateTexture(ctx.renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_TARGET, pixels.x, pixels.y);
+        if (!cache_texture) {
+            return;
+        }
+        SDL_SetTextureBlendMode(cache_texture, SDL_BLENDMODE_NONE);
+        refresh_requested = 1;
+    }
+
+    if (refresh_requested) {
+        std::fill(cache_signatures.begin(), cache_signatures.end(), MINIMAP_SIGNATURE_NONE);
+        refresh_requested = 0;
+    }
+
+    enemy_color = ENEMY_COLOR_BY_CLIMATE[scenario_property_climate()];
+
+    // only tiles which changed since the last frame go to the cache, figures are drawn over it every frame
+    figure_tiles.clear();
+    const int x_first = std::max(absolute_tile.x() - 4, 0);
+    const int x_last = std::min(absolute_tile.x() + draw_size.x, MINIMAP_SPAN);
+    const int y_first = std::max(absolute_tile.y() - 4, 0);
+    const int y_last = std::min(absolute_tile.y() + draw_size.y + 4, MINIMAP_SPAN);
+    bool any_dirty = false;
+    for (int y_abs = y_first; y_abs < y_last; y_abs++) {
+        for (int x_abs = x_first; x_abs < x_last; x_abs++) {
+            const tile2i point = screen_to_tile({ x_abs, y_abs });
+            const uint64_t signature = tile_signature(point);
+            uint64_t &cached = cache_signatures[y_abs * MINIMAP_SPAN + x_abs];
+            if (cached != signature) {
+                cached = signature;
+                cache_dirty_blocks[(y_abs / MINIMAP_BLOCK) * MINIMAP_BLOCKS + x_abs / MINIMAP_BLOCK] = 1;
+                any_dirty = true;
+            }
+
+            if (point.grid_offset() >= 0 && map_has_figure_at(point)) {
+                figure_tiles.push_back({ vec2i(x_abs, y_abs), point });
+            }
+        }
+    }
+
+    if (!any_dirty) {
+        return;
+    }
+
+    for (int block_y = 0; block_y < MINIMAP_BLOCKS; block_y++) {
+        uint8_t *row = &cache_dirty_blocks[block_y * MINIMAP_BLOCKS];
+        for (int block_x = 0; block_x < MINIMAP_BLOCKS; block_x++) {
+            if (!row[block_x]) {
+                continue;
+            }
+
+            int block_x_last = block_x;
+            while (block_x_last + 1 < MINIMAP_BLOCKS && row[block_x_last + 1]) {
+                block_x_last++;
+            }
+
+            repaint_blocks(ctx, block_y, block_x, block_x_last);
+            std::fill(row + block_x, row + block_x_last + 1, 0);
+            block_x = block_x_last;
+        }
+    }
+}
+
+void minimap_window::repaint_blocks(painter &ctx, int block_y, int block_x_first, int block_x_last) {
+    OZZY_PROFILER_SECTION("Render/Frame/Window/City/Sidebar Expanded/Minimap Cache/Repaint");
+    const int x0 = block_x_first * MINIMAP_BLOCK;
+    const int x1 = std::min((block_x_last + 1) * MINIMAP_BLOCK, MINIMAP_SPAN);
+    const int y0 = block_y * MINIMAP_BLOCK;
+    const int y1 = std::min(y0 + MINIMAP_BLOCK, MINIMAP_SPAN);
+
+    SDL_Texture *former_target = SDL_GetRenderTarget(ctx.renderer);
+    SDL_Rect former_viewport;
+    SDL_Rect former_clip;
+    const bool former_clip_enabled = SDL_RenderIsClipEnabled(ctx.renderer);
+    SDL_RenderGetViewport(ctx.renderer, &former_viewport);
+    SDL_RenderGetClipRect(ctx.renderer, &former_clip);
+
+    SDL_SetRenderTarget(ctx.renderer, cache_texture);
+    SDL_RenderSetViewport(ctx.renderer, nullptr);
+    const vec2i start = minimap_cache_pixel(x0, 1);
+    const SDL_Rect clip = { start.x, MINIMAP_CACHE_PAD + y0, 2 * (x1 - x0) + 1, y1 - y0 };
+    SDL_RenderSetClipRect(ctx.renderer, &clip);
+    SDL_SetRenderDrawColor(ctx.renderer, 0, 0, 0, 0xff);
+    SDL_RenderFillRect(ctx.renderer, &clip);
+
+    const int x_first = std::max(x0 - MINIMAP_BLOCK_MARGIN, 0);
+    const int x_last = std::min(x1 + MINIMAP_BLOCK_MARGIN, MINIMAP_SPAN);
+    const int y_first = std::max(y0 - MINIMAP_BLOCK_MARGIN, 0);
+    const int y_last = std::min(y1 + MINIMAP_BLOCK_MARGIN, MINIMAP_SPAN);
+    for (int y_abs = y_first; y_abs < y_last; y_abs++) {
+        for (int x_abs = x_first; x_abs < x_last; x_abs++) {
+            draw_minimap_terrain(minimap_cache_pixel(x_abs, y_abs), screen_to_tile({ x_abs, y_abs }));
+        }
+    }
+
+    SDL_SetRenderTarget(ctx.renderer, former_target);
+    SDL_RenderSetViewport(ctx.renderer, &former_viewport);
+    SDL_RenderSetClipRect(ctx.renderer, former_clip_enabled ? &former_clip : nullptr);
 }
 
 void minimap_window::draw(UiFlags flags) {
     OZZY_PROFILER_SECTION("Render/Frame/Window/City/Sidebar Expanded/Minimap Tiles");
-    clear();
-    city_view_foreach_minimap_tile(screen_offset.x, screen_offset.y, absolute_tile.x(), absolute_tile.y(), draw_size.x, draw_size.y, [this] (vec2i screen, tile2i point) {
-        draw_minimap_tile(screen, point);
-    });
-}
+    if (!cache_texture) {
+        return;
+    }
 
-void minimap_window::draw_uncached(vec2i pos) {
-    screen_offset = pos;
-    enemy_color = ENEMY_COLOR_BY_CLIMATE[scenario_property_climate()];
-    draw(UiFlags_None);
+    painter ctx = game.painter();
+    const SDL_Rect src = { MINIMAP_CACHE_PAD + 2 * absolute_tile.x(), MINIMAP_CACHE_PAD + absolute_tile.y(), size.x, size.y };
+    const SDL_Rect dst = { screen_offset.x, screen_offset.y, size.x, size.y };
+    SDL_RenderCopy(ctx.renderer, cache_texture, &src, &dst);
 
-    cached_texture = graphics_save_to_texture(cached_texture, screen_offset, size);
+    for (const auto &it : figure_tiles) {
+        const vec2i screen = minimap_cache_pixel(it.first.x, it.first.y) - vec2i(src.x, src.y) + screen_offset;
+        draw_figure(screen, it.second);
+    }
 }
 
-void widget_minimap_draw(vec2i offset, int force) {
+void widget_minimap_draw(vec2i offset) {
     g_minimap_window.screen_offset = offset;
-    g_minimap_window.draw_force = force;
     g_minimap_window.draw_foreground(0);
 }
 
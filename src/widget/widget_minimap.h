@@ -4,6 +4,10 @@
 #include "graphics/animation.h"
 #include "window/autoconfig_window.h"
 
+#include <vector>
+
+struct SDL_Texture;
+
 struct minimap_window : public autoconfig_window_t<minimap_window> {
     tile2i absolute_tile;
     vec2i draw_size;
@@ -14,8 +18,10 @@ struct minimap_window : public autoconfig_window_t<minimap_window> {
     vec2i rel_mouse;
     vec2i mouse_last_coords;
     int refresh_requested;
-    bool draw_force = false;
-    int cached_texture = 0;
+    SDL_Texture *cache_texture = nullptr; // whole map in minimap space, repainted block by block
+    std::vector<uint64_t> cache_signatures;
+    std::vector<uint8_t> cache_dirty_blocks;
+    std::vector<std::pair<vec2i, tile2i>> figure_tiles;
     animation_t terrain_canal;
     animation_t terrain_water;
     animation_t terrain_shrub;
@@ -50,14 +56,15 @@ struct minimap_window : public autoconfig_window_t<minimap_window> {
     bool draw_figure(vec2i screen, tile2i point);
     vec2i get_mouse_relative_pos(const mouse *m, float &xx, float &yy);
     void set_bounds(vec2i draw_size);
-    void draw_uncached(vec2i offset);
-    void draw_minimap_tile(vec2i screen, tile2i point);
+    uint64_t tile_signature(tile2i point);
+    void update_cache(painter &ctx);
+    void repaint_blocks(painter &ctx, int block_y, int block_x_first, int block_x_last);
+    void draw_minimap_terrain(vec2i screen, tile2i point);
     void draw_viewport_rectangle(painter &ctx);
-    void clear();
     virtual void draw(UiFlags flags) override;
 };
 
 void widget_minimap_init();
 void widget_minimap_invalidate();
-void widget_minimap_draw(vec2i offset, int force);
+void widget_minimap_draw(vec2i offset);
 bool widget_minimap_handle_mouse(const mouse* m);
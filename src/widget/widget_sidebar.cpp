@@ -183,7 +183,7 @@ void ui::sidebar_window_expanded::ui_draw_foreground(UiFlags flags) {
     const UiFlags wflags = is_disabled ? UiFlags_Darkened : UiFlags_None;
 
     ui.begin_widget(ui.pos);
-    widget_minimap_draw({ x_offset + 12, MINIMAP_Y_OFFSET }, 0);
+    widget_minimap_draw({ x_offset + 12, MINIMAP_Y_OFFSET });
 
     ui.draw(wflags);
     ui.end_widget();
@@ -334,7 +334,7 @@ void widget_sidebar_city_draw_foreground() {
 
 void widget_sidebar_city_draw_foreground_military() {
     widget_sidebar_city_draw_foreground();
-    widget_minimap_draw({screen_width() - g_sidebar_expanded.expanded_offset_x + 8, MINIMAP_Y_OFFSET}, 1);
+    widget_minimap_draw({screen_width() - g_sidebar_expanded.expanded_offset_x + 8, MINIMAP_Y_OFFSET});
 }
 
 int widget_sidebar_city_handle_mouse(const mouse* m) {
@@ -21,6 +21,7 @@
 #include "content/vfs.h"
 #include "io/gamefiles/lang.h"
 #include "io/gamestate/boilerplate.h"
+#include "io/gamestate/save_index.h"
 #include "widget/input_box.h"
 #include "window/window_city.h"
 #include "window/editor/window_editor.h"
@@ -40,7 +41,7 @@ static image_button image_buttons[] = {
   {392, 335, 39, 26, IB_NORMAL, GROUP_OK_CANCEL_SCROLL_BUTTONS, 4, button_ok_cancel, button_none, 0, 0, 1},
 };
 
-#define NUM_FILES_IN_VIEW 12
+#define NUM_FILES_IN_VIEW 11 // one row left for the save details line
 // #define MAX_FILE_WINDOW_TEXT_WIDTH (18 * INPUT_BOX_BLOCK_SIZE)
 
 static scrollable_list_ui_params ui_params = [] {
@@ -142,20 +143,48 @@ static void init(file_type type, file_dialog_type dialog_type) {
     if (type == FILE_TYPE_SCENARIO) {
         data.panel->change_file_path("Maps/", map_file_data.extension);
     } else {
+        pcstr only_extension = nullptr;
         if (data.dialog_type == FILE_DIALOG_LOAD) {
             data.panel->change_file_path(folder_name, data.file_data->extension);
             data.panel->append_files_with_extension(folder_name, saved_game_data_expanded.extension); // TODO?
         } else if (data.dialog_type == FILE_DIALOG_SAVE) {
             data.panel->change_file_path(folder_name, saved_game_data_expanded.extension);
+            only_extension = saved_game_data_expanded.extension;
         } else {
             assert(false);
         }
+
+        // the index reuses the listing instead of scanning the folder again
+        std::vector<pcstr> filenames;
+        for (int i = 0, count = data.panel->get_total_entries(); i < count; i++) {
+            filenames.push_back(data.panel->get_entry_text_by_idx(i, FILE_WITH_EXT));
+        }
+        g_save_index.open(folder_name, filenames, only_extension);
     }
 
     set_chosen_filename(data.file_data->last_loaded_file);
     input_box_start(&file_name_input, data.typed_name, MAX_FILE_NAME, 0);
 }
 
+static void draw_save_details() {
+    auto& data = g_file_dialog;
+    if (data.panel->get_selected_entry_idx() < 0) {
+        return;
+    }
+
+    const save_index_t::entry_t *entry = g_save_index.find(data.panel->get_selected_entry_text(FILE_WITH_EXT));
+    if (!entry || entry->stale || entry->version < 0) {
+        return;
+    }
+
+    const int y = 120 + (NUM_FILES_IN_VIEW + 1) * 16 + 4;
+    int x = 152;
+    x += text_draw(entry->scenario_name, x, y, FONT_SMALL_PLAIN, COLOR_BLACK) + 8;
+    x += lang_text_draw_year(entry->year, x, y, FONT_SMALL_PLAIN) + 8;
+    // same labels as the top menu: population, then funds
+    lang_text_draw(vec2i{x, y}, FONT_SMALL_PLAIN, 0, "%s %d  %s %d", ui::str(6, 1), entry->population, ui::str(6, 0), entry->treasury);
+}
+
 static void draw_foreground(int) {
     auto& data = g_file_dialog;
     graphics_set_to_dialog();
@@ -179,6 +208,12 @@ static void draw_foreground(int) {
     data.panel->ui_params.pos = { 144, 120 };
     data.panel->draw();
 
+    if (data.type == FILE_TYPE_SAVED_GAME) {
+        // re-read a couple of changed files per frame, the list itself never waits for them
+        g_save_index.refresh_stale(2);
+        draw_save_details();
+    }
+
     image_buttons_draw({0, 0}, image_buttons, 2);
 
     //    uint8_t txt[200];
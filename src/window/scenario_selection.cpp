@@ -462,22 +462,36 @@ static void button_select_item(int index, int param2) {
     auto &data = g_window_scenario_selection;
     if (index >= data.panel->get_total_entries())
         return;
+    // only the scenario header is read for the side panel, the full load happens on start
     switch (data.dialog) {
     case MAP_SELECTION_CUSTOM:
-        GamestateIO::load_map(data.panel->get_selected_entry_text(FILE_WITH_EXT), false);
+        GamestateIO::load_map_preview(data.panel->get_selected_entry_text(FILE_WITH_EXT));
         break;
     case MAP_SELECTION_CAMPAIGN_SINGLE_LIST:
-        GamestateIO::load_mission(get_first_mission_in_campaign(data.campaign_sub_dialog) + data.panel->get_selected_entry_idx(), false);
+        GamestateIO::load_mission_preview(get_first_mission_in_campaign(data.campaign_sub_dialog) + data.panel->get_selected_entry_idx());
         break;
     }
 }
 
 static void button_start_scenario(int param1, int param2) {
+    auto &data = g_window_scenario_selection;
     if (scenario_campaign_scenario_id() == -1) {
         return;
     }
 
-    GamestateIO::start_loaded_file();
+    bool loaded = false;
+    switch (data.dialog) {
+    case MAP_SELECTION_CUSTOM:
+        loaded = GamestateIO::load_map(data.panel->get_selected_entry_text(FILE_WITH_EXT), false);
+        break;
+    case MAP_SELECTION_CAMPAIGN_SINGLE_LIST:
+        loaded = GamestateIO::load_mission(get_first_mission_in_campaign(data.campaign_sub_dialog) + data.panel->get_selected_entry_idx(), false);
+        break;
+    }
+
+    if (loaded) {
+        GamestateIO::start_loaded_file();
+    }
 }
 
 static void button_scores_or_goals(int param1, int param2) {